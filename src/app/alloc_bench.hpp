@@ -0,0 +1,119 @@
+// src/app/alloc_bench.hpp
+// --bench-alloc: the batch-tool allocation pattern (parse -> tempo map ->
+// schedule -> drop, file after file) under three memory resources:
+//   heap   the global allocator (glibc malloc via new/delete)
+//   pool   a long-lived size-class pool (std::pmr::unsynchronized_pool_
+//          resource); freed blocks are reused across files, like the
+//          per-size bins of jemalloc/tcmalloc
+//   arena  a per-file monotonic arena (common/arena.hpp), dropped in O(1)
+//
+// Design notes:
+//  * Every resource sits on a CountingResource, so the report shows how often
+//    each strategy still goes to the system allocator.
+//  * The raw file bytes are read once, outside the timed loop, and the
+//    parser reads them in place; the difference is Song + TempoMap +
+//    schedule only.
+//  * Each mode runs for a fixed wall-clock budget after one warm-up file.
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <vector>
+
+#include "audio/schedule.hpp"
+#include "common/arena.hpp"
+#include "midi/smf.hpp"
+#include "midi/tempo.hpp"
+
+namespace app {
+
+struct AllocBenchResult {
+  const char *name;
+  double usPerFile;          // parse + tempo + schedule + free
+  double upstreamPerFile;    // system allocations per file
+  std::size_t upstreamPeak;  // peak bytes held from the system
+};
+
+namespace detail {
+
+// One file's worth of work; returns the event count so nothing is elided.
+inline std::size_t alloc_bench_file(const std::vector<std::uint8_t> &bytes,
+                                    std::pmr::memory_resource *mr) {
+  const midi::Song song = midi::parse_smf(bytes, mr);
+  const midi::TempoMap tempo = midi::build_tempo_map(song, mr);
+  return audio::build_schedule(song, tempo, mr).size();
+}
+
+template <class PerFile>
+AllocBenchResult alloc_bench_run(const char *name, double seconds,
+                                 const CountingResource &counter,
+                                 PerFile &&perFile) {
+  using clock = std::chrono::steady_clock;
+  std::size_t sink = perFile(); // warm-up: page in, size the arena
+  const std::size_t allocs0 = counter.allocations();
+  std::size_t files = 0;
+  const auto t0 = clock::now();
+  double elapsed = 0.0;
+  while (elapsed < seconds) {
+    for (int i = 0; i < 16; ++i)
+      sink += perFile();
+    files += 16;
+    elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+  }
+  volatile std::size_t keep = sink;
+  (void)keep;
+  return AllocBenchResult{
+      name, elapsed * 1e6 / double(files),
+      double(counter.allocations() - allocs0) / double(files),
+      counter.peak()};
+}
+
+} // namespace detail
+
+inline std::vector<AllocBenchResult>
+run_alloc_bench(const std::vector<std::uint8_t> &bytes,
+                double secondsPerMode = 1.0) {
+  std::vector<AllocBenchResult> out;
+  {
+    CountingResource heap;
+    out.push_back(detail::alloc_bench_run(
+        "heap", secondsPerMode, heap,
+        [&] { return detail::alloc_bench_file(bytes, &heap); }));
+  }
+  {
+    CountingResource up;
+    std::pmr::unsynchronized_pool_resource pool(&up);
+    out.push_back(detail::alloc_bench_run(
+        "pool", secondsPerMode, up,
+        [&] { return detail::alloc_bench_file(bytes, &pool); }));
+  }
+  {
+    CountingResource up;
+    FileArena arena(std::size_t(64) << 10, &up);
+    out.push_back(detail::alloc_bench_run(
+        "arena", secondsPerMode, up, [&] {
+          const std::size_t n =
+              detail::alloc_bench_file(bytes, arena.resource());
+          arena.reset();
+          return n;
+        }));
+  }
+  return out;
+}
+
+inline void print_alloc_bench(const std::vector<AllocBenchResult> &rs) {
+  std::cout << "Allocation strategies (parse + tempo + schedule per file):\n"
+            << "  resource   us/file   sys allocs/file   sys peak KiB\n";
+  for (const auto &r : rs) {
+    std::cout << "  " << std::left << std::setw(8) << r.name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10)
+              << r.usPerFile << std::setprecision(1) << std::setw(18)
+              << r.upstreamPerFile << std::setw(15)
+              << double(r.upstreamPeak) / 1024.0 << "\n";
+  }
+}
+
+} // namespace app
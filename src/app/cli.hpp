@@ -3,6 +3,34 @@
 // Responsibilities:
 //  - Extract the positional MIDI path.
 //  - Parse an optional --sf <name-or-path> override.
+//  - Collect optional --mix <file.mid> layers (played together via the mixer).
+//  - Parse --admit (admission control for the --mix sessions).
+//  - Parse --mix-slots <n> (mixer slots; later songs wait for one to free).
+//  - Parse an optional --live <spec> input; the MIDI path may then be omitted.
+//  - Parse --dry (bypass the reverb/chorus send buses).
+//  - Parse --ir <file.wav> [--ir-master] (convolution reverb).
+//  - Parse --interp <mode> and --bench-interp (sample interpolation).
+//  - Parse --no-mipmaps (disable band-limited sample pyramids).
+//  - Parse --bench-alloc (compare allocators on the parse/schedule path).
+//  - Parse --bench-jobs (preview latency under bulk renders, FIFO vs EDF).
+//  - Parse --compact-events (delta-encoded schedule for very long songs).
+//  - Parse --watch (hot reload the MIDI file whenever it is saved).
+//  - Parse --pack <file.mpk>: the positional then names an entry in the pack
+//    (io/pack.hpp) instead of a file; without it the pack is listed.
+//  - Parse --mem-report (print memory per subsystem when playback ends).
+//  - Parse --perf (hardware counters per pipeline stage, Linux).
+//  - Parse --cost-report (render time per preset and MIDI channel).
+//  - Parse --golden <dir> [--golden-update] [--golden-snr <dB>]
+//    [--golden-timing] (offline golden-render regression check,
+//    app/golden.hpp).
+//  - Parse --driver <spec> (device, null or simulated output, see
+//    audio/driver.hpp).
+//  - Parse --stats <dir-or-pack> (scan a corpus, print JSON lines, exit).
+//  - Parse --farm <spool> [--farm-submit <dir-or-file>] [--farm-workers <n>]
+//    [--farm-checkpoint <sec>] and --farm-worker <spool> (multi-process
+//    render farm, app/render_farm.hpp).
+//  - Accept "-" (stdin) or a pipe/FIFO as the MIDI path: played while it
+//    arrives (app/stream_input.hpp).
 //  - Validate that the MIDI file exists (fail early with a clear error).
 //
 // Design notes:
@@ -13,8 +41,40 @@
 //   app::Cli cli = app::parse_cli(argc, argv);
 //   cli.midiPath     --> std::filesystem::path to the .mid file
 //   cli.sfOverride   --> std::optional<std::string> (empty if not provided)
+//   cli.mixPaths     --> extra MIDI files to layer on the same device
+//   cli.admit        --> add the mix sessions under admission control
+//   cli.mixSlots     --> mixer session slots (0 = one per song)
+//   cli.liveSpec     --> live input spec (unix:<path>, fifo:<path>, udp:<port>)
+//   cli.dry          --> true if send effects should be bypassed
+//   cli.irPath       --> impulse response WAV (empty if not provided)
+//   cli.irMaster     --> apply the IR to the master mix, not the reverb bus
+//   cli.interp       --> interpolation mode name (empty = player default)
+//   cli.benchInterp  --> measure every interpolation mode and exit
+//   cli.mipmaps      --> false if --no-mipmaps was given
+//   cli.benchAlloc   --> benchmark heap/pool/arena on this file and exit
+//   cli.benchJobs    --> benchmark the render job scheduler and exit
+//   cli.compactEvents --> keep the schedule as a compact byte stream
+//   cli.watch        --> re-read the MIDI file on save and keep playing
+//   cli.packPath     --> packed corpus to read from (empty if not provided)
+//   cli.packEntry    --> entry name inside the pack (empty = list the pack)
+//   cli.streamPath   --> "-" or a non-seekable input (midiPath stays empty)
+//   cli.statsPath    --> directory or pack to scan (empty if not provided)
+//   cli.memReport    --> print current/peak bytes per subsystem at the end
+//   cli.perf         --> count cycles/instructions/misses per stage
+//   cli.costReport   --> rank presets and channels by render time
+//   cli.goldenDir    --> golden reference directory (empty if not provided)
+//   cli.goldenUpdate --> record new references instead of checking
+//   cli.goldenSnr    --> > 0: tolerance mode (minimum SNR in dB)
+//   cli.goldenTiming --> record/check this machine's render times too
+//   cli.driver       --> output driver spec (empty = playback device)
+//   cli.farmSpool    --> coordinate a render farm on this spool directory
+//   cli.farmSubmit   --> directory or MIDI file to queue on the farm
+//   cli.farmWorkers  --> local worker processes (< 0 = one per core)
+//   cli.farmCheckpoint --> seconds between render checkpoints (0 = never)
+//   cli.farmWorker   --> spool directory to claim and render jobs from
 
 #pragma once
+#include <cstdlib>
 #include <filesystem>
 #include <optional>
 #include <stdexcept>
@@ -26,6 +86,37 @@ namespace app {
 struct Cli {
   std::filesystem::path midiPath;
   std::optional<std::string> sfOverride; // from --sf <name-or-path>, if given
+  std::vector<std::filesystem::path> mixPaths; // from --mix (repeatable)
+  bool admit = false;                  // from --admit
+  int mixSlots = 0;                    // from --mix-slots
+  std::optional<std::string> liveSpec; // from --live; midiPath may be empty
+  bool dry = false;                    // from --dry
+  std::filesystem::path irPath;        // from --ir
+  bool irMaster = false;               // from --ir-master
+  std::string interp;                  // from --interp
+  bool benchInterp = false;            // from --bench-interp
+  bool mipmaps = true;                 // cleared by --no-mipmaps
+  bool benchAlloc = false;             // from --bench-alloc
+  bool benchJobs = false;              // from --bench-jobs
+  bool compactEvents = false;          // from --compact-events
+  bool watch = false;                  // from --watch
+  std::filesystem::path packPath;      // from --pack
+  std::string packEntry;               // positional, with --pack
+  std::string streamPath;              // positional "-", a pipe or FIFO
+  std::filesystem::path statsPath;     // from --stats
+  bool memReport = false;              // from --mem-report
+  bool perf = false;                   // from --perf
+  bool costReport = false;             // from --cost-report
+  std::filesystem::path goldenDir;     // from --golden
+  bool goldenUpdate = false;           // from --golden-update
+  double goldenSnr = 0.0;              // from --golden-snr
+  bool goldenTiming = false;           // from --golden-timing
+  std::string driver;                  // from --driver
+  std::filesystem::path farmSpool;     // from --farm
+  std::filesystem::path farmSubmit;    // from --farm-submit
+  int farmWorkers = -1;                // from --farm-workers
+  double farmCheckpoint = 30.0;        // from --farm-checkpoint
+  std::filesystem::path farmWorker;    // from --farm-worker
 };
 
 // Small helper: true if s looks like a flag (starts with '-' and not just "-")
@@ -35,42 +126,319 @@ inline bool is_flag_like(const std::string &s) {
 
 // Parse argv into our Cli struct.
 // Contract:
-//  - argv[1] must be the MIDI file path (positional).
-//  - Optional: --sf <name-or-path>
+//  - argv[1] must be the MIDI file path (positional), unless --live is given;
+//    with --pack it is an entry name and may be omitted; --stats, --farm
+//    and --farm-worker need none.
+//  - Optional: --sf <name-or-path>, --mix <file.mid>..., --admit,
+//    --mix-slots <n>, --live <spec>, --dry,
+//    --ir <file.wav>, --ir-master, --interp <mode>, --bench-interp,
+//    --no-mipmaps, --bench-alloc, --bench-jobs, --compact-events, --watch,
+//    --pack <file.mpk>, --stats <dir-or-pack>, --mem-report, --perf,
+//    --cost-report,
+//    --golden <dir>, --golden-update, --golden-snr <dB>, --golden-timing,
+//    --driver <spec>,
+//    --farm <spool>, --farm-submit <dir-or-file>, --farm-workers <n>,
+//    --farm-checkpoint <sec>, --farm-worker <spool>
 //  - Throws std::runtime_error on any invalid input.
 inline Cli parse_cli(int argc, char **argv) {
   if (argc < 2) {
-    throw std::runtime_error("Usage: " + std::string(argv[0]) +
-                             " <file.mid> [--sf <name-or-path>]");
-  }
-
-  // 1) Positional MIDI path
-  std::filesystem::path midiPath = argv[1];
-  if (is_flag_like(midiPath.string())) {
     throw std::runtime_error(
-        "First argument must be a MIDI file path, not a flag.");
+        "Usage: " + std::string(argv[0]) +
+        " <file.mid> [--sf <name-or-path>] [--mix <file.mid>]... [--admit] "
+        "[--mix-slots <n>] [--live <spec>] [--dry] "
+        "[--ir <file.wav> [--ir-master]] "
+        "[--interp <mode>] [--bench-interp] [--no-mipmaps] [--bench-alloc] "
+        "[--bench-jobs] [--compact-events] [--watch] [--pack <file.mpk>] "
+        "[--stats <dir-or-pack>] [--mem-report] [--perf] [--cost-report] "
+        "[--golden <dir> [--golden-update] [--golden-snr <dB>] "
+        "[--golden-timing]] "
+        "[--driver <spec>] "
+        "[--farm <spool> [--farm-submit <dir-or-file>] [--farm-workers <n>] "
+        "[--farm-checkpoint <sec>]] [--farm-worker <spool>]");
   }
-  if (!std::filesystem::exists(midiPath) ||
-      !std::filesystem::is_regular_file(midiPath)) {
-    throw std::runtime_error("MIDI file not found: " + midiPath.string());
+
+  // 1) Positional MIDI path or pack entry (validated after the flags;
+  //    optional in live mode and with --pack)
+  std::string positional;
+  int firstFlag = 1;
+  if (!is_flag_like(argv[1])) {
+    positional = argv[1];
+    firstFlag = 2;
   }
 
   // 2) Optional flags
   std::optional<std::string> sfOverride;
-  for (int i = 2; i < argc; ++i) {
+  std::vector<std::filesystem::path> mixPaths;
+  bool admit = false;
+  int mixSlots = 0;
+  std::optional<std::string> liveSpec;
+  bool dry = false;
+  std::filesystem::path irPath;
+  bool irMaster = false;
+  std::string interp;
+  bool benchInterp = false;
+  bool mipmaps = true;
+  bool benchAlloc = false;
+  bool benchJobs = false;
+  bool compactEvents = false;
+  bool watch = false;
+  std::filesystem::path packPath;
+  std::filesystem::path statsPath;
+  bool memReport = false;
+  bool perf = false;
+  bool costReport = false;
+  std::filesystem::path goldenDir;
+  bool goldenUpdate = false;
+  double goldenSnr = 0.0;
+  bool goldenTiming = false;
+  std::string driver;
+  std::filesystem::path farmSpool;
+  std::filesystem::path farmSubmit;
+  int farmWorkers = -1;
+  double farmCheckpoint = -1.0;
+  std::filesystem::path farmWorker;
+  for (int i = firstFlag; i < argc; ++i) {
     std::string a = argv[i];
     if (a == "--help" || a == "-h") {
       throw std::runtime_error(
           "Usage:\n  " + std::string(argv[0]) +
-          " <file.mid> [--sf <name-or-path>]\n"
+          " <file.mid> [--sf <name-or-path>] [--mix <file.mid>]... [--admit] "
+          "[--mix-slots <n>] [--live <spec>] [--dry] "
+        "[--ir <file.wav> [--ir-master]] "
+          "[--interp <mode>] [--bench-interp] [--no-mipmaps] "
+          "[--bench-alloc] [--bench-jobs] [--compact-events] [--watch] "
+          "[--pack <file.mpk>] [--stats <dir-or-pack>] [--mem-report] "
+          "[--perf] [--cost-report] "
+          "[--golden <dir> [--golden-update] [--golden-snr <dB>] "
+          "[--golden-timing]] "
+          "[--driver <spec>] "
+          "[--farm <spool> [--farm-submit <dir-or-file>] "
+          "[--farm-workers <n>] [--farm-checkpoint <sec>]] "
+          "[--farm-worker <spool>]\n"
           "Options:\n"
+          "  <file.mid>           A MIDI file; - (stdin) or a pipe is played "
+          "while it arrives\n"
           "  --sf <name-or-path>  Choose a specific SoundFont by name (in root "
-          "soundfonts/) or by path\n");
+          "soundfonts/) or by path\n"
+          "  --mix <file.mid>     Play another MIDI file at the same time on "
+          "the same device (repeatable)\n"
+          "  --admit              Add the --mix songs under admission "
+          "control: each is admitted,\n"
+          "                       downgraded, queued or rejected by its "
+          "estimated CPU demand\n"
+          "  --mix-slots <n>      Mixer slots (default: one per song); later "
+          "songs wait for a\n"
+          "                       finished one to be removed\n"
+          "  --live <spec>        Also play live MIDI from unix:<path>, "
+          "fifo:<path> or udp:<port>\n"
+          "                       (the MIDI file is optional; Ctrl-C to "
+          "stop)\n"
+          "  --dry                Bypass the reverb/chorus send effects\n"
+          "  --ir <file.wav>      Convolution reverb with this impulse "
+          "response on the reverb bus\n"
+          "  --ir-master          Apply the --ir reverb to the whole mix "
+          "instead\n"
+          "                       (both also apply to --farm-submit jobs)\n"
+          "  --interp <mode>      Sample interpolation: linear, cubic "
+          "(default), sinc8, sinc16\n"
+          "  --bench-interp       Measure the cost of every interpolation "
+          "mode and exit\n"
+          "  --no-mipmaps         Play high notes from the full-rate samples "
+          "only\n"
+          "  --bench-alloc        Compare heap, pool and arena allocation "
+          "for parsing this file, and exit\n"
+          "  --bench-jobs         Time previews of this file against bulk "
+          "renders, FIFO vs deadline\n"
+          "                       scheduling, and exit\n"
+          "  --compact-events     Keep the event schedule delta-encoded "
+          "(automatic above ~1M events)\n"
+          "  --watch              Reload the MIDI file whenever it is saved "
+          "and keep playing (Ctrl-C to stop)\n"
+          "  --pack <file.mpk>    Read the MIDI file from a pack built by "
+          "midi_pack; the first\n"
+          "                       argument is the entry name (omit it to "
+          "list the pack)\n"
+          "  --stats <dir|pack>   Scan every MIDI file in a directory tree "
+          "or pack on all cores;\n"
+          "                       print one JSON line per file and a "
+          "summary, and exit\n"
+          "  --mem-report         Print current and peak memory per "
+          "subsystem when playback ends\n"
+          "  --perf               Count cycles, instructions, cache and "
+          "branch misses per stage\n"
+          "                       (parse, tempo, schedule, SF2 load, render; "
+          "Linux perf events)\n"
+          "  --cost-report        Rank presets and MIDI channels by voice "
+          "render time, with voices\n"
+          "                       started per note-on, when playback ends\n"
+          "  --golden <dir>       Render the built-in test corpus offline and "
+          "compare it bit-exactly\n"
+          "                       with the references in <dir>; fails on "
+          "changed output\n"
+          "  --golden-update      Record the references instead\n"
+          "  --golden-snr <dB>    Compare against the stored PCM with this "
+          "minimum SNR instead\n"
+          "  --golden-timing      Also record (with --golden-update) or "
+          "check this machine's\n"
+          "                       render times; fails on a slowdown\n"
+          "  --driver <spec>      Output: device (default), null[:frames] "
+          "(real time, no sound) or\n"
+          "                       sim[:min[-max][:seed]] (back-to-back "
+          "random periods, full speed)\n"
+          "  --farm <spool>       Coordinate a render farm on a spool "
+          "directory: start workers,\n"
+          "                       re-queue stale claims, report jobs as "
+          "they finish\n"
+          "  --farm-submit <path> Queue every MIDI file in this directory "
+          "(or this file)\n"
+          "  --farm-workers <n>   Local worker processes (default: one per "
+          "core; 0: remote only)\n"
+          "  --farm-checkpoint <sec>\n"
+          "                       Checkpoint submitted renders this often "
+          "(default 30; 0: never)\n"
+          "  --farm-worker <spool>\n"
+          "                       Claim and render jobs from the spool "
+          "until it is empty\n");
     } else if (a == "--sf") {
       if (i + 1 >= argc) {
         throw std::runtime_error("--sf requires a value (name or path)");
       }
       sfOverride = std::string(argv[++i]);
+    } else if (a == "--mix") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--mix requires a MIDI file path");
+      }
+      std::filesystem::path p = argv[++i];
+      if (!std::filesystem::exists(p) ||
+          !std::filesystem::is_regular_file(p)) {
+        throw std::runtime_error("MIDI file not found: " + p.string());
+      }
+      mixPaths.push_back(std::filesystem::canonical(p));
+    } else if (a == "--live") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--live requires a source spec");
+      }
+      liveSpec = std::string(argv[++i]);
+    } else if (a == "--dry") {
+      dry = true;
+    } else if (a == "--ir") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--ir requires a WAV file path");
+      }
+      irPath = argv[++i];
+      if (!std::filesystem::is_regular_file(irPath)) {
+        throw std::runtime_error("Impulse response not found: " +
+                                 irPath.string());
+      }
+    } else if (a == "--ir-master") {
+      irMaster = true;
+    } else if (a == "--interp") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--interp requires a mode name");
+      }
+      interp = argv[++i];
+    } else if (a == "--bench-interp") {
+      benchInterp = true;
+    } else if (a == "--no-mipmaps") {
+      mipmaps = false;
+    } else if (a == "--bench-alloc") {
+      benchAlloc = true;
+    } else if (a == "--bench-jobs") {
+      benchJobs = true;
+    } else if (a == "--compact-events") {
+      compactEvents = true;
+    } else if (a == "--watch") {
+      watch = true;
+    } else if (a == "--pack") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--pack requires a pack file path");
+      }
+      packPath = argv[++i];
+      if (!std::filesystem::is_regular_file(packPath)) {
+        throw std::runtime_error("Pack not found: " + packPath.string());
+      }
+    } else if (a == "--golden") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--golden requires a reference directory");
+      }
+      goldenDir = argv[++i];
+    } else if (a == "--golden-update") {
+      goldenUpdate = true;
+    } else if (a == "--golden-snr") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--golden-snr requires a value in dB");
+      }
+      goldenSnr = std::atof(argv[++i]);
+      if (!(goldenSnr > 0.0)) {
+        throw std::runtime_error("--golden-snr must be a positive dB value");
+      }
+    } else if (a == "--golden-timing") {
+      goldenTiming = true;
+    } else if (a == "--driver") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--driver requires a driver spec");
+      }
+      driver = argv[++i];
+    } else if (a == "--farm") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--farm requires a spool directory");
+      }
+      farmSpool = argv[++i];
+    } else if (a == "--farm-submit") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--farm-submit requires a directory or file");
+      }
+      farmSubmit = argv[++i];
+      if (!std::filesystem::exists(farmSubmit)) {
+        throw std::runtime_error("Not found: " + farmSubmit.string());
+      }
+    } else if (a == "--farm-workers") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--farm-workers requires a count");
+      }
+      farmWorkers = std::atoi(argv[++i]);
+      if (farmWorkers < 0) {
+        throw std::runtime_error("--farm-workers must be 0 or more");
+      }
+    } else if (a == "--farm-checkpoint") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--farm-checkpoint requires seconds");
+      }
+      farmCheckpoint = std::atof(argv[++i]);
+      if (!(farmCheckpoint >= 0.0)) {
+        throw std::runtime_error("--farm-checkpoint must be 0 or more");
+      }
+    } else if (a == "--farm-worker") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--farm-worker requires a spool directory");
+      }
+      farmWorker = argv[++i];
+    } else if (a == "--admit") {
+      admit = true;
+    } else if (a == "--mix-slots") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--mix-slots requires a count");
+      }
+      mixSlots = std::atoi(argv[++i]);
+      if (mixSlots < 1) {
+        throw std::runtime_error("--mix-slots must be 1 or more");
+      }
+    } else if (a == "--perf") {
+      perf = true;
+    } else if (a == "--cost-report") {
+      costReport = true;
+    } else if (a == "--mem-report") {
+      memReport = true;
+    } else if (a == "--stats") {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("--stats requires a directory or pack path");
+      }
+      statsPath = argv[++i];
+      if (!std::filesystem::is_directory(statsPath) &&
+          !std::filesystem::is_regular_file(statsPath)) {
+        throw std::runtime_error("Not a directory or pack: " +
+                                 statsPath.string());
+      }
     } else {
       // Future flags could go here; for now treat unknowns as errors to avoid
       // surprises.
@@ -78,10 +446,90 @@ inline Cli parse_cli(int argc, char **argv) {
     }
   }
 
+  std::filesystem::path midiPath;
+  std::string streamPath;
+  if (packPath.empty() && !positional.empty()) {
+    const auto type = std::filesystem::status(positional).type();
+    if (positional == "-" || type == std::filesystem::file_type::fifo ||
+        type == std::filesystem::file_type::character) {
+      streamPath = positional; // not seekable: parsed as it arrives
+    } else if (type == std::filesystem::file_type::regular) {
+      midiPath = positional;
+    } else {
+      throw std::runtime_error("MIDI file not found: " + positional);
+    }
+  }
+  if (!streamPath.empty() &&
+      (watch || benchAlloc || benchJobs || !mixPaths.empty())) {
+    throw std::runtime_error("--watch, --bench-alloc, --bench-jobs and --mix "
+                             "need a MIDI file, not a stream");
+  }
+  if ((admit || mixSlots > 0) && mixPaths.empty()) {
+    throw std::runtime_error("--admit and --mix-slots need --mix");
+  }
+  if ((goldenUpdate || goldenSnr > 0.0 || goldenTiming) &&
+      goldenDir.empty()) {
+    throw std::runtime_error(
+        "--golden-update, --golden-snr and --golden-timing need --golden");
+  }
+  if ((!farmSubmit.empty() || farmWorkers >= 0) && farmSpool.empty()) {
+    throw std::runtime_error("--farm-submit and --farm-workers need --farm");
+  }
+  if (farmCheckpoint >= 0.0 && farmSubmit.empty()) {
+    throw std::runtime_error("--farm-checkpoint needs --farm-submit");
+  }
+  if (farmCheckpoint > 0.0 && !irPath.empty()) {
+    throw std::runtime_error("--farm-checkpoint cannot be combined with --ir "
+                             "(a convolution reverb is not checkpointed)");
+  }
+  if (midiPath.empty() && streamPath.empty() && !liveSpec &&
+      packPath.empty() && statsPath.empty() && goldenDir.empty() &&
+      farmSpool.empty() && farmWorker.empty()) {
+    throw std::runtime_error(
+        "First argument must be a MIDI file path, not a flag.");
+  }
+  if (watch && midiPath.empty()) {
+    throw std::runtime_error("--watch needs a MIDI file path");
+  }
+
   // 3) Return the parsed/validated CLI
   Cli cli;
-  cli.midiPath = std::filesystem::canonical(midiPath); // nice absolute path
+  if (!midiPath.empty())
+    cli.midiPath = std::filesystem::canonical(midiPath); // nice absolute path
   cli.sfOverride = sfOverride;
+  cli.mixPaths = std::move(mixPaths);
+  cli.admit = admit;
+  cli.mixSlots = mixSlots;
+  cli.liveSpec = liveSpec;
+  cli.dry = dry;
+  cli.irPath = irPath;
+  cli.irMaster = irMaster;
+  cli.interp = interp;
+  cli.benchInterp = benchInterp;
+  cli.mipmaps = mipmaps;
+  cli.benchAlloc = benchAlloc;
+  cli.benchJobs = benchJobs;
+  cli.compactEvents = compactEvents;
+  cli.watch = watch;
+  cli.packPath = packPath;
+  cli.streamPath = streamPath;
+  cli.statsPath = statsPath;
+  cli.memReport = memReport;
+  cli.perf = perf;
+  cli.costReport = costReport;
+  cli.goldenDir = goldenDir;
+  cli.goldenUpdate = goldenUpdate;
+  cli.goldenSnr = goldenSnr;
+  cli.goldenTiming = goldenTiming;
+  cli.farmSpool = farmSpool;
+  cli.farmSubmit = farmSubmit;
+  cli.farmWorkers = farmWorkers;
+  if (farmCheckpoint >= 0.0)
+    cli.farmCheckpoint = farmCheckpoint;
+  cli.farmWorker = farmWorker;
+  cli.driver = driver;
+  if (!packPath.empty())
+    cli.packEntry = positional;
   return cli;
 }
 
@@ -0,0 +1,613 @@
+// src/app/golden.hpp
+// --golden: render a fixed corpus offline and compare it with stored
+// references, so renderer optimizations can be checked for unchanged output
+// and for speed.
+//
+//   midi_player --golden tests/golden --golden-update   // write references
+//   midi_player --golden tests/golden                   // bit-exact check
+//   midi_player --golden tests/golden --golden-snr 90   // tolerance check
+//   midi_player --golden tests/golden --golden-timing   // and speed check
+//
+// Everything the renders depend on is generated here: a tiny two-preset
+// SoundFont (a looped saw and a noise burst on the drum bank) and a handful
+// of SMF songs that reach the interesting paths (sustain pedal, volume and
+// pan, CC91/CC93 sends, notes far above the root key for the mipmap levels,
+// drums). Each case renders one song with one interpolation mode through
+// parse -> tempo map -> schedule -> Synth + SendEffects, in kMaxBusFrames
+// blocks with events applied per block like the real-time callback.
+//
+// The reference directory holds:
+//   golden.sf2        the generated font (rewritten only if it changed)
+//   <song>.mid        the generated songs, likewise; for playing them by
+//                     hand and for ctest's simulated-driver runs
+//   manifest.txt      "<case> <fnv1a-64 of the PCM> <frames>"; the one in
+//                     tests/golden is committed and checked by ctest
+//   <case>.f32        raw interleaved stereo float PCM (tolerance mode)
+//   timing.txt        "<case> <render ms>", only with --golden-timing
+// Only manifest.txt is meant for version control: the PCM is large and
+// timings belong to one machine and build type.
+//
+// Checks, per case:
+// - bit-exact (default): the FNV-1a hash of the float PCM must match.
+// - tolerance (--golden-snr <dB>): SNR against the stored PCM must be at
+//   least the given dB; max abs error is reported too. Meant for changes
+//   that legitimately move the last bits (reassociated sums, table math).
+// - speed (opt-in, --golden-timing): the best of kGoldenRuns renders may
+//   be at most kGoldenMaxSlowdown times the time in timing.txt (plus
+//   kGoldenSlackMs for timer noise on the short cases). Record the
+//   baseline on the machine that checks it, with --golden-update
+//   --golden-timing.
+// - determinism: the kGoldenRuns renders must be bit-identical.
+// Returns the number of failed cases; main() turns that into exit status 1.
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "audio/interp.hpp"
+#include "audio/offline.hpp"
+#include "audio/schedule.hpp"
+#include "audio/synth.hpp"
+#include "common/hash.hpp"
+#include "io/io.hpp"
+#include "midi/smf.hpp"
+#include "midi/tempo.hpp"
+
+namespace app {
+
+constexpr int kGoldenRuns = 3;
+constexpr double kGoldenMaxSlowdown = 1.5;
+constexpr double kGoldenSlackMs = 2.0;
+constexpr int kGoldenSampleRate = 44100;
+constexpr double kGoldenTailSec = 1.0;
+
+struct GoldenOptions {
+  std::filesystem::path dir;
+  bool update = false;
+  double snrDb = 0.0; // > 0: tolerance mode
+  bool timing = false; // record or check timing.txt as well
+};
+
+namespace detail {
+
+// --- The test SoundFont ---------------------------------------------------
+
+inline void put_le(std::vector<std::uint8_t> &out, std::uint32_t v, int n) {
+  for (int i = 0; i < n; ++i)
+    out.push_back(std::uint8_t(v >> (8 * i)));
+}
+
+inline void put_name(std::vector<std::uint8_t> &out, const char *name) {
+  std::size_t i = 0;
+  for (; name[i] && i < 20; ++i)
+    out.push_back(std::uint8_t(name[i]));
+  out.insert(out.end(), 20 - i, 0);
+}
+
+inline std::vector<std::uint8_t>
+riff_chunk(const char *id, const std::vector<std::uint8_t> &data) {
+  std::vector<std::uint8_t> out(id, id + 4);
+  put_le(out, std::uint32_t(data.size()), 4);
+  out.insert(out.end(), data.begin(), data.end());
+  if (data.size() % 2)
+    out.push_back(0);
+  return out;
+}
+
+inline std::vector<std::uint8_t>
+riff_list(const char *type, const std::vector<std::vector<std::uint8_t>> &cs) {
+  std::vector<std::uint8_t> body(type, type + 4);
+  for (const auto &c : cs)
+    body.insert(body.end(), c.begin(), c.end());
+  return riff_chunk("LIST", body);
+}
+
+// Two samples, each followed by the 46 zero samples the format requires:
+// a 100-sample saw cycle repeated (root 69, looped) and a decaying noise
+// burst from a fixed LCG (root 60, one-shot).
+inline std::vector<std::uint8_t> golden_font() {
+  constexpr std::uint32_t kSaw = 4000, kNoise = 6000, kPad = 46;
+  std::vector<std::uint8_t> smpl;
+  for (std::uint32_t i = 0; i < kSaw; ++i) {
+    const int v = int(12000.0 * (2.0 * double(i % 100) / 100.0 - 1.0));
+    put_le(smpl, std::uint32_t(std::uint16_t(std::int16_t(v))), 2);
+  }
+  smpl.insert(smpl.end(), kPad * 2, 0);
+  std::uint32_t lcg = 12345;
+  for (std::uint32_t i = 0; i < kNoise; ++i) {
+    lcg = lcg * 1664525u + 1013904223u;
+    const double env = std::exp(-double(i) / 900.0);
+    const int v = int(double(std::int16_t(lcg >> 16)) * 0.6 * env);
+    put_le(smpl, std::uint32_t(std::uint16_t(std::int16_t(v))), 2);
+  }
+  smpl.insert(smpl.end(), kPad * 2, 0);
+
+  std::vector<std::uint8_t> ifil, isng(std::begin("EMU8000"),
+                                       std::end("EMU8000"));
+  put_le(ifil, 2, 2);
+  put_le(ifil, 1, 2);
+  const std::vector<std::uint8_t> inam{'G', 'o', 'l', 'd', 0, 0};
+
+  // Presets: 0:0 "Saw" -> instrument 0, 128:0 "Kit" -> instrument 1.
+  std::vector<std::uint8_t> phdr, pbag, pmod(10, 0), pgen;
+  const auto preset = [&](const char *name, int prog, int bank, int bag) {
+    put_name(phdr, name);
+    put_le(phdr, std::uint32_t(prog), 2);
+    put_le(phdr, std::uint32_t(bank), 2);
+    put_le(phdr, std::uint32_t(bag), 2);
+    put_le(phdr, 0, 4);
+    put_le(phdr, 0, 4);
+    put_le(phdr, 0, 4);
+  };
+  preset("Saw", 0, 0, 0);
+  preset("Kit", 0, 128, 1);
+  preset("EOP", 0, 0, 2);
+  for (int b = 0; b <= 2; ++b) {
+    put_le(pbag, std::uint32_t(b), 2); // one generator per zone
+    put_le(pbag, 0, 2);
+  }
+  for (std::uint32_t inst : {0u, 1u}) {
+    put_le(pgen, 41, 2); // instrument
+    put_le(pgen, inst, 2);
+  }
+  put_le(pgen, 0, 4);
+
+  // Instruments: sampleModes, releaseVolEnv (timecents), sampleID.
+  std::vector<std::uint8_t> inst, ibag, imod(10, 0), igen;
+  put_name(inst, "SawI");
+  put_le(inst, 0, 2);
+  put_name(inst, "KitI");
+  put_le(inst, 1, 2);
+  put_name(inst, "EOI");
+  put_le(inst, 2, 2);
+  for (int b = 0; b <= 2; ++b) {
+    put_le(ibag, std::uint32_t(b * 3), 2);
+    put_le(ibag, 0, 2);
+  }
+  const auto gen = [&](int oper, int amount) {
+    put_le(igen, std::uint32_t(oper), 2);
+    put_le(igen, std::uint32_t(std::uint16_t(std::int16_t(amount))), 2);
+  };
+  gen(54, 1);     // looped
+  gen(38, -3000); // ~0.18 s release
+  gen(53, 0);
+  gen(54, 0);
+  gen(38, -2000);
+  gen(53, 1);
+  put_le(igen, 0, 4);
+
+  std::vector<std::uint8_t> shdr;
+  const auto sample = [&](const char *name, std::uint32_t start,
+                          std::uint32_t end, std::uint32_t loopStart,
+                          std::uint32_t loopEnd, int root) {
+    put_name(shdr, name);
+    put_le(shdr, start, 4);
+    put_le(shdr, end, 4);
+    put_le(shdr, loopStart, 4);
+    put_le(shdr, loopEnd, 4);
+    put_le(shdr, kGoldenSampleRate, 4);
+    shdr.push_back(std::uint8_t(root));
+    shdr.push_back(0); // pitch correction
+    put_le(shdr, 0, 2);
+    put_le(shdr, 1, 2); // mono
+  };
+  const std::uint32_t noise0 = kSaw + kPad;
+  sample("saw", 0, kSaw, 0, kSaw, 69);
+  sample("noise", noise0, noise0 + kNoise, noise0, noise0 + kNoise, 60);
+  put_name(shdr, "EOS");
+  shdr.insert(shdr.end(), 26, 0);
+
+  std::vector<std::uint8_t> body{'s', 'f', 'b', 'k'};
+  for (const auto &l :
+       {riff_list("INFO", {riff_chunk("ifil", ifil), riff_chunk("isng", isng),
+                           riff_chunk("INAM", inam)}),
+        riff_list("sdta", {riff_chunk("smpl", smpl)}),
+        riff_list("pdta",
+                  {riff_chunk("phdr", phdr), riff_chunk("pbag", pbag),
+                   riff_chunk("pmod", pmod), riff_chunk("pgen", pgen),
+                   riff_chunk("inst", inst), riff_chunk("ibag", ibag),
+                   riff_chunk("imod", imod), riff_chunk("igen", igen),
+                   riff_chunk("shdr", shdr)})})
+    body.insert(body.end(), l.begin(), l.end());
+  return riff_chunk("RIFF", body);
+}
+
+// --- The test songs -------------------------------------------------------
+
+// One format-1 SMF at 480 PPQN from (tick, track, bytes) events; track 0 is
+// the conductor track.
+class SmfBuilder {
+public:
+  void add(std::uint32_t tick, int track, std::vector<std::uint8_t> bytes) {
+    if (std::size_t(track) >= tracks_.size())
+      tracks_.resize(std::size_t(track) + 1);
+    tracks_[std::size_t(track)].push_back({tick, std::move(bytes)});
+  }
+  void note(std::uint32_t tick, std::uint32_t len, int track, int ch,
+            int key, int vel) {
+    add(tick, track, {std::uint8_t(0x90 | ch), std::uint8_t(key),
+                      std::uint8_t(vel)});
+    add(tick + len, track, {std::uint8_t(0x80 | ch), std::uint8_t(key), 0});
+  }
+  void cc(std::uint32_t tick, int track, int ch, int num, int value) {
+    add(tick, track, {std::uint8_t(0xB0 | ch), std::uint8_t(num),
+                      std::uint8_t(value)});
+  }
+  void tempo(std::uint32_t tick, std::uint32_t usPerQN) {
+    add(tick, 0, {0xFF, 0x51, 0x03, std::uint8_t(usPerQN >> 16),
+                  std::uint8_t(usPerQN >> 8), std::uint8_t(usPerQN)});
+  }
+
+  std::vector<std::uint8_t> bytes() const {
+    std::vector<std::uint8_t> out{'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1};
+    out.push_back(std::uint8_t(tracks_.size() >> 8));
+    out.push_back(std::uint8_t(tracks_.size()));
+    out.push_back(480 >> 8);
+    out.push_back(480 & 0xFF);
+    for (auto evs : tracks_) {
+      std::stable_sort(
+          evs.begin(), evs.end(),
+          [](const Ev &a, const Ev &b) { return a.tick < b.tick; });
+      std::vector<std::uint8_t> data;
+      std::uint32_t last = 0;
+      for (const Ev &e : evs) {
+        put_vlq(data, e.tick - last);
+        last = e.tick;
+        data.insert(data.end(), e.bytes.begin(), e.bytes.end());
+      }
+      data.insert(data.end(), {0, 0xFF, 0x2F, 0});
+      out.insert(out.end(), {'M', 'T', 'r', 'k'});
+      for (int s = 24; s >= 0; s -= 8)
+        out.push_back(std::uint8_t(data.size() >> s));
+      out.insert(out.end(), data.begin(), data.end());
+    }
+    return out;
+  }
+
+private:
+  struct Ev {
+    std::uint32_t tick;
+    std::vector<std::uint8_t> bytes;
+  };
+  static void put_vlq(std::vector<std::uint8_t> &out, std::uint32_t v) {
+    std::uint8_t buf[5];
+    int n = 0;
+    do {
+      buf[n++] = std::uint8_t(v & 0x7F);
+      v >>= 7;
+    } while (v);
+    while (n > 1)
+      out.push_back(buf[--n] | 0x80);
+    out.push_back(buf[0]);
+  }
+
+  std::vector<std::vector<Ev>> tracks_{1};
+};
+
+inline std::vector<std::uint8_t> song_scale() {
+  SmfBuilder b;
+  for (int i = 0; i < 16; ++i)
+    b.note(std::uint32_t(i) * 240, 220, 1, 0, 48 + 2 * i, 60 + 4 * i);
+  return b.bytes();
+}
+
+inline std::vector<std::uint8_t> song_chords() {
+  SmfBuilder b;
+  b.tempo(0, 500000);
+  b.tempo(1920, 400000);
+  const int roots[] = {60, 65, 67, 60};
+  for (int c = 0; c < 4; ++c) {
+    const std::uint32_t t = std::uint32_t(c) * 960;
+    b.cc(t, 1, 0, 64, 127); // sustain through the chord
+    b.cc(t + 900, 1, 0, 64, 0);
+    b.cc(t, 1, 0, 7, 70 + 15 * c);
+    b.cc(t, 2, 1, 10, c % 2 ? 20 : 108);
+    for (int k : {0, 4, 7})
+      b.note(t, 480, 1, 0, roots[c] + k, 90);
+    b.note(t + 240, 600, 2, 1, roots[c] - 12, 100);
+  }
+  return b.bytes();
+}
+
+inline std::vector<std::uint8_t> song_sends() {
+  SmfBuilder b;
+  for (int ch = 0; ch < 4; ++ch) {
+    b.cc(0, 1 + ch, ch, 91, 30 * ch);
+    b.cc(0, 1 + ch, ch, 93, 127 - 30 * ch);
+    for (int i = 0; i < 6; ++i)
+      b.note(std::uint32_t(i * 320 + ch * 80), 400, 1 + ch, ch,
+             57 + ch * 5 + i, 80 + ch * 10);
+  }
+  return b.bytes();
+}
+
+inline std::vector<std::uint8_t> song_high() {
+  SmfBuilder b; // one to four octaves above the root: every pyramid level
+  for (int i = 0; i < 24; ++i)
+    b.note(std::uint32_t(i) * 120, 160, 1, 0, 72 + (i * 7) % 48, 100);
+  return b.bytes();
+}
+
+inline std::vector<std::uint8_t> song_drums() {
+  SmfBuilder b;
+  for (int i = 0; i < 16; ++i) {
+    const std::uint32_t t = std::uint32_t(i) * 240;
+    b.note(t, 60, 1, 9, 42, 70);
+    if (i % 4 == 0)
+      b.note(t, 120, 1, 9, 36, 120);
+    if (i % 4 == 2)
+      b.note(t, 120, 1, 9, 38, 110);
+  }
+  return b.bytes();
+}
+
+struct GoldenSong {
+  const char *name;
+  std::vector<std::uint8_t> (*bytes)();
+};
+
+inline const std::vector<GoldenSong> &golden_songs() {
+  static const std::vector<GoldenSong> songs = {
+      {"scale", song_scale}, {"chords", song_chords}, {"sends", song_sends},
+      {"high", song_high},   {"drums", song_drums},
+  };
+  return songs;
+}
+
+struct GoldenCase {
+  const char *name;
+  std::vector<std::uint8_t> (*song)();
+  audio::Interp interp;
+  bool mipmaps;
+};
+
+inline const std::vector<GoldenCase> &golden_cases() {
+  using audio::Interp;
+  static const std::vector<GoldenCase> cases = {
+      {"scale-linear", song_scale, Interp::Linear, true},
+      {"scale-cubic", song_scale, Interp::Cubic, true},
+      {"scale-sinc16", song_scale, Interp::Sinc16, true},
+      {"chords-cubic", song_chords, Interp::Cubic, true},
+      {"sends-cubic", song_sends, Interp::Cubic, true},
+      {"sends-sinc8", song_sends, Interp::Sinc8, true},
+      {"high-linear", song_high, Interp::Linear, true},
+      {"high-cubic", song_high, Interp::Cubic, true},
+      {"high-cubic-nomip", song_high, Interp::Cubic, false},
+      {"drums-cubic", song_drums, Interp::Cubic, true},
+  };
+  return cases;
+}
+
+// --- Rendering and comparison ---------------------------------------------
+
+// Offline render of one case on a share()d copy of `font` (interleaved
+// stereo, events applied per block up to the block end).
+inline std::vector<float> golden_render(const audio::Synth &font,
+                                        const audio::Schedule &events) {
+  audio::OfflineRender job(font, events, kGoldenSampleRate, kGoldenTailSec);
+  std::vector<float> pcm;
+  pcm.reserve(job.frames() * 2);
+  while (job.step() > 0)
+    pcm.insert(pcm.end(), job.block(), job.block() + job.block_frames() * 2);
+  return pcm;
+}
+
+inline std::uint64_t pcm_hash(const std::vector<float> &pcm) {
+  return fnv1a(pcm.data(), pcm.size() * sizeof(float));
+}
+
+struct GoldenRef {
+  std::uint64_t hash = 0;
+  std::size_t frames = 0;
+};
+
+// Fields after the frame count (older manifests kept the render time
+// there) are ignored.
+inline std::map<std::string, GoldenRef>
+read_manifest(const std::filesystem::path &file) {
+  std::map<std::string, GoldenRef> refs;
+  std::ifstream in(file);
+  for (std::string line; std::getline(in, line);) {
+    std::istringstream fields(line);
+    std::string name, hex;
+    GoldenRef r;
+    if (fields >> name >> hex >> r.frames) {
+      r.hash = std::stoull(hex, nullptr, 16);
+      refs[name] = r;
+    }
+  }
+  return refs;
+}
+
+inline std::map<std::string, double>
+read_timing(const std::filesystem::path &file) {
+  std::map<std::string, double> ms;
+  std::ifstream in(file);
+  std::string name;
+  double v = 0.0;
+  while (in >> name >> v)
+    ms[name] = v;
+  return ms;
+}
+
+inline void write_file(const std::filesystem::path &file, const void *data,
+                       std::size_t size) {
+  std::ofstream out(file, std::ios::binary | std::ios::trunc);
+  out.write(static_cast<const char *>(data), std::streamsize(size));
+  if (!out)
+    throw std::runtime_error("Cannot write " + file.string());
+}
+
+// Generated inputs are rewritten only when they changed: a new mtime would
+// invalidate the font's pyramid cache.
+inline void write_if_changed(const std::filesystem::path &file,
+                             const std::vector<std::uint8_t> &bytes) {
+  if (!std::filesystem::exists(file) || io::read_all(file) != bytes)
+    write_file(file, bytes.data(), bytes.size());
+}
+
+} // namespace detail
+
+// Render every case and check it against (or, with update, record) the
+// references in opts.dir. Prints one line per case; returns the failures.
+inline int run_golden(const GoldenOptions &opts) {
+  namespace fs = std::filesystem;
+  using clock = std::chrono::steady_clock;
+  fs::create_directories(opts.dir);
+
+  // The font and songs are regenerated every run.
+  const fs::path fontPath = opts.dir / "golden.sf2";
+  detail::write_if_changed(fontPath, detail::golden_font());
+  for (const detail::GoldenSong &s : detail::golden_songs())
+    detail::write_if_changed(opts.dir / (std::string(s.name) + ".mid"),
+                             s.bytes());
+
+  const fs::path manifest = opts.dir / "manifest.txt";
+  const auto refs = detail::read_manifest(manifest);
+  if (!opts.update && refs.empty()) {
+    throw std::runtime_error("No golden references in " + opts.dir.string() +
+                             " (record them with --golden-update)");
+  }
+  const fs::path timingFile = opts.dir / "timing.txt";
+  const auto refMs = opts.timing && !opts.update
+                         ? detail::read_timing(timingFile)
+                         : std::map<std::string, double>{};
+  if (opts.timing && !opts.update && refMs.empty()) {
+    throw std::runtime_error(
+        "No timing baseline in " + opts.dir.string() +
+        " (record one on this machine with --golden-update --golden-timing)");
+  }
+
+  audio::Synth base(fontPath, kGoldenSampleRate);
+  audio::Synth mipBase = base.share();
+  mipBase.enable_mipmaps();
+
+  std::cout << (opts.update ? "Recording" : "Checking") << " golden renders in "
+            << opts.dir.string()
+            << (opts.update       ? ""
+                : opts.snrDb > 0 ? " (tolerance mode)"
+                                 : " (bit-exact)")
+            << ":\n"
+            << "  case                 frames   ms   ref ms  result\n";
+  int failures = 0;
+  std::string lines, timingLines;
+  for (const detail::GoldenCase &c : detail::golden_cases()) {
+    const midi::Song song = midi::parse_smf(c.song());
+    const audio::Schedule events =
+        audio::build_schedule(song, midi::build_tempo_map(song));
+    audio::Synth font = (c.mipmaps ? mipBase : base).share();
+    font.set_interpolation(c.interp);
+
+    std::vector<float> pcm;
+    double bestMs = std::numeric_limits<double>::infinity();
+    bool deterministic = true;
+    for (int run = 0; run < kGoldenRuns; ++run) {
+      const auto t0 = clock::now();
+      std::vector<float> out = detail::golden_render(font, events);
+      const double ms =
+          std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+      bestMs = std::min(bestMs, ms);
+      if (run > 0 && out != pcm)
+        deterministic = false;
+      pcm = std::move(out);
+    }
+    const std::uint64_t hash = detail::pcm_hash(pcm);
+    const std::size_t frames = pcm.size() / 2;
+
+    std::string result;
+    double baseMs = -1.0; // shown as "-" when there is no baseline
+    if (const auto t = refMs.find(c.name); t != refMs.end())
+      baseMs = t->second;
+    if (!deterministic) {
+      result = "FAIL: renders differ between runs";
+    } else if (opts.update) {
+      char line[128];
+      std::snprintf(line, sizeof line, "%s %016llx %zu\n", c.name,
+                    (unsigned long long)hash, frames);
+      lines += line;
+      std::snprintf(line, sizeof line, "%s %.3f\n", c.name, bestMs);
+      timingLines += line;
+      detail::write_file(opts.dir / (std::string(c.name) + ".f32"),
+                         pcm.data(), pcm.size() * sizeof(float));
+      result = "recorded";
+    } else if (auto it = refs.find(c.name); it == refs.end()) {
+      result = "FAIL: no reference";
+    } else {
+      const detail::GoldenRef &ref = it->second;
+      if (frames != ref.frames) {
+        result = "FAIL: " + std::to_string(frames) + " frames, expected " +
+                 std::to_string(ref.frames);
+      } else if (opts.snrDb > 0.0) {
+        const auto refPcm =
+            io::read_all(opts.dir / (std::string(c.name) + ".f32"));
+        if (refPcm.size() != pcm.size() * sizeof(float)) {
+          result = "FAIL: reference PCM missing or truncated";
+        } else {
+          const auto *r = reinterpret_cast<const float *>(refPcm.data());
+          double signal = 0.0, noise = 0.0, maxAbs = 0.0;
+          for (std::size_t i = 0; i < pcm.size(); ++i) {
+            const double e = double(pcm[i]) - double(r[i]);
+            signal += double(r[i]) * double(r[i]);
+            noise += e * e;
+            maxAbs = std::max(maxAbs, std::abs(e));
+          }
+          const double snr = noise > 0.0
+                                 ? 10.0 * std::log10(signal / noise)
+                                 : std::numeric_limits<double>::infinity();
+          char buf[96];
+          std::snprintf(buf, sizeof buf, "SNR %.1f dB, max abs %.2e", snr,
+                        maxAbs);
+          result = (snr >= opts.snrDb ? "ok: " : "FAIL: ") + std::string(buf);
+        }
+      } else {
+        result = hash == ref.hash ? "ok" : "FAIL: output changed";
+      }
+      if (opts.timing && baseMs < 0.0 && result.rfind("ok", 0) == 0) {
+        result = "FAIL: no timing baseline";
+      } else if (opts.timing && result.rfind("ok", 0) == 0 &&
+                 bestMs > baseMs * kGoldenMaxSlowdown + kGoldenSlackMs) {
+        char buf[64];
+        std::snprintf(buf, sizeof buf, "FAIL: over %.1fx the reference time",
+                      kGoldenMaxSlowdown);
+        result = buf;
+      }
+    }
+    if (result.rfind("FAIL", 0) == 0)
+      ++failures;
+    std::cout << "  " << std::left << std::setw(18) << c.name << std::right
+              << std::setw(10) << frames << std::fixed << std::setprecision(1)
+              << std::setw(6) << bestMs << std::setw(9);
+    if (baseMs < 0.0)
+      std::cout << "-";
+    else
+      std::cout << baseMs;
+    std::cout << "  " << result << "\n";
+  }
+  if (opts.update)
+    detail::write_file(manifest, lines.data(), lines.size());
+  if (opts.update && opts.timing)
+    detail::write_file(timingFile, timingLines.data(), timingLines.size());
+  const std::size_t total = detail::golden_cases().size();
+  if (failures)
+    std::cout << failures << " of " << total << " cases failed\n";
+  else
+    std::cout << "All " << total << " cases "
+              << (opts.update ? "recorded" : "passed") << "\n";
+  return failures;
+}
+
+} // namespace app
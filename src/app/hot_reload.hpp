@@ -0,0 +1,58 @@
+// src/app/hot_reload.hpp
+// --watch: replay the MIDI file every time it is saved, without restarting
+// playback.
+//
+//   app::HotReload reload(cli.midiPath);
+//   opts.reload = &reload;                 // play() polls it while waiting
+//   audio::play(reload.song(), reload.tempo(), sf, opts);
+//
+// Design notes:
+//  * io::FileWatcher notices the save; midi::IncrementalSmf re-parses only
+//    the tracks whose bytes changed and keeps the tempo map unless the
+//    conductor track changed.
+//  * A file that fails to parse (mid-save, or a broken export) is reported
+//    and skipped; playback carries on with the last good version.
+
+#pragma once
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+#include "audio/player.hpp"
+#include "io/file_watch.hpp"
+#include "io/io.hpp"
+#include "midi/incremental.hpp"
+
+namespace app {
+
+class HotReload : public audio::ReloadSource {
+public:
+  explicit HotReload(const std::filesystem::path &midiPath)
+      : watch_(midiPath), smf_(io::read_all(midiPath)) {}
+
+  [[nodiscard]] const midi::Song &song() const { return smf_.song(); }
+  [[nodiscard]] const midi::TempoMap &tempo() const { return smf_.tempo(); }
+
+  bool poll(const midi::Song *&song, const midi::TempoMap *&tempo) override {
+    if (!watch_.changed())
+      return false;
+    try {
+      const midi::ReloadStats st = smf_.update(io::read_all(watch_.path()));
+      std::cout << "Reloaded " << watch_.path().filename().string() << ": "
+                << st.reparsed << " of " << st.tracks << " tracks re-parsed"
+                << (st.tempoChanged ? ", tempo map rebuilt" : "") << "\n";
+    } catch (const std::exception &ex) {
+      std::cerr << "reload skipped: " << ex.what() << "\n";
+      return false;
+    }
+    song = &smf_.song();
+    tempo = &smf_.tempo();
+    return true;
+  }
+
+private:
+  io::FileWatcher watch_;
+  midi::IncrementalSmf smf_;
+};
+
+} // namespace app
@@ -0,0 +1,149 @@
+// src/app/job_bench.hpp
+// --bench-jobs: interactive previews submitted while bulk renders keep every
+// worker busy, under FIFO and under the deadline scheduler
+// (audio/job_scheduler.hpp).
+//
+// Design notes:
+//  * Bulk jobs are this song looped to kJobBenchBulkSec of audio, two per
+//    worker, so the pool is saturated for the whole run.
+//  * Previews render the song's first kJobBenchPreviewSec, one every
+//    kJobBenchPreviewEverySec, each due kJobBenchDeadlineSec after it was
+//    submitted - the "needed in under a second" request.
+//  * Reported per policy: preview latency (p50, p95, max), missed deadlines
+//    and bulk throughput in seconds of audio per wall-clock second. The two
+//    throughput figures show what preemption costs the bulk jobs.
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "audio/job_scheduler.hpp"
+#include "audio/offline.hpp"
+#include "audio/schedule.hpp"
+#include "audio/synth.hpp"
+
+namespace app {
+
+constexpr int kJobBenchSampleRate = 44100;
+constexpr double kJobBenchBulkSec = 120.0;
+constexpr double kJobBenchPreviewSec = 2.0;
+constexpr double kJobBenchPreviewEverySec = 0.1;
+constexpr double kJobBenchDeadlineSec = 1.0;
+constexpr int kJobBenchPreviews = 16;
+
+struct JobBenchResult {
+  const char *name;
+  double p50Ms, p95Ms, maxMs; // preview latency, submit -> done
+  int missed;                 // previews later than kJobBenchDeadlineSec
+  double bulkRealtime;        // bulk audio seconds per wall second
+  std::uint64_t preemptions;
+};
+
+namespace detail {
+
+// `events` played back to back (1 s apart) until it lasts at least `sec`.
+inline audio::Schedule loop_schedule(const audio::Schedule &events,
+                                     double sec) {
+  audio::Schedule out(events.get_allocator());
+  if (events.empty())
+    return out;
+  const double len = events.back().tSec + 1.0;
+  for (double off = 0.0; off < sec; off += len) {
+    for (audio::ScheduledEvent e : events) {
+      e.tSec += off;
+      out.push_back(e);
+    }
+  }
+  return out;
+}
+
+inline JobBenchResult job_bench_run(const char *name,
+                                    audio::SchedPolicy policy, int workers,
+                                    const audio::Synth &font,
+                                    const audio::Schedule &events) {
+  using clock = std::chrono::steady_clock;
+  const audio::Schedule bulk = loop_schedule(events, kJobBenchBulkSec);
+  audio::RenderScheduler sched(workers, policy);
+
+  const auto t0 = clock::now();
+  std::vector<audio::JobId> bulkIds;
+  double bulkAudio = 0.0;
+  for (int i = 0; i < 2 * workers; ++i) {
+    auto job = std::make_unique<audio::OfflineRender>(font, bulk,
+                                                      kJobBenchSampleRate);
+    bulkAudio += double(job->frames()) / kJobBenchSampleRate;
+    bulkIds.push_back(sched.submit(std::move(job), audio::JobClass::Bulk,
+                                   std::numeric_limits<double>::infinity()));
+  }
+
+  std::vector<audio::JobId> previews;
+  for (int i = 0; i < kJobBenchPreviews; ++i) {
+    std::this_thread::sleep_until(
+        t0 + std::chrono::duration_cast<clock::duration>(
+                 std::chrono::duration<double>(
+                     kJobBenchPreviewEverySec * (i + 1))));
+    previews.push_back(sched.submit(
+        std::make_unique<audio::OfflineRender>(font, events,
+                                               kJobBenchSampleRate, 1.0,
+                                               kJobBenchPreviewSec),
+        audio::JobClass::Interactive, kJobBenchDeadlineSec));
+  }
+
+  JobBenchResult r{name, 0, 0, 0, 0, 0, 0};
+  std::vector<double> ms;
+  for (audio::JobId id : previews) {
+    const audio::JobResult p = sched.wait(id);
+    ms.push_back(p.latencySec * 1e3);
+    r.missed += p.missed ? 1 : 0;
+  }
+  for (audio::JobId id : bulkIds)
+    sched.wait(id);
+  const double wall =
+      std::chrono::duration<double>(clock::now() - t0).count();
+  r.bulkRealtime = wall > 0.0 ? bulkAudio / wall : 0.0;
+  r.preemptions = sched.preemptions();
+
+  std::sort(ms.begin(), ms.end());
+  r.p50Ms = ms[ms.size() / 2];
+  r.p95Ms = ms[std::min(ms.size() - 1, ms.size() * 95 / 100)];
+  r.maxMs = ms.back();
+  return r;
+}
+
+} // namespace detail
+
+inline std::vector<JobBenchResult>
+run_job_bench(const audio::Synth &font, const audio::Schedule &events,
+              int workers) {
+  return {detail::job_bench_run("fifo", audio::SchedPolicy::Fifo, workers,
+                                font, events),
+          detail::job_bench_run("edf", audio::SchedPolicy::Edf, workers,
+                                font, events)};
+}
+
+inline void print_job_bench(const std::vector<JobBenchResult> &rs,
+                            int workers) {
+  std::cout << "Render scheduling (" << workers << " workers, "
+            << 2 * workers << " bulk renders of " << kJobBenchBulkSec
+            << " s, " << kJobBenchPreviews << " previews of "
+            << kJobBenchPreviewSec << " s due in " << kJobBenchDeadlineSec
+            << " s):\n"
+            << "  policy   p50 ms   p95 ms   max ms   missed   "
+               "bulk x realtime   preemptions\n";
+  for (const auto &r : rs) {
+    std::cout << "  " << std::left << std::setw(6) << r.name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(9)
+              << r.p50Ms << std::setw(9) << r.p95Ms << std::setw(9)
+              << r.maxMs << std::setw(9) << r.missed << std::setw(18)
+              << r.bulkRealtime << std::setw(14) << r.preemptions << "\n";
+  }
+}
+
+} // namespace app
@@ -1,18 +1,22 @@
 // src/app/preview.hpp
 // Pretty, compact console preview of a parsed MIDI song.
 // - Prints SMF header summary
-// - Prints first 10 NoteOn/NoteOff events with timestamps (s)
+// - Prints the opening time/key signature
+// - Prints first 10 NoteOn/NoteOff events with timestamps (s) and musical
+//   positions (bar:beat:tick)
 
 #pragma once
 #include <iomanip>
 #include <iostream>
 
 #include "midi/events.hpp"
+#include "midi/meter.hpp"
 #include "midi/tempo.hpp"
 
 namespace app {
 
-inline void print_preview(const midi::Song &song, const midi::TempoMap &tempo) {
+inline void print_preview(const midi::Song &song, const midi::TempoMap &tempo,
+                          const midi::MeterMap &meter) {
   // Header
   std::cout << "SMF header:\n";
   std::cout << "  format  = " << song.header.format << "\n";
@@ -24,13 +28,25 @@ inline void print_preview(const midi::Song &song, const midi::TempoMap &tempo) {
               << song.header.smpte_sub << " subframes\n";
   }
 
+  const midi::MeterSeg &m0 = meter.segments.front();
+  std::cout << "  meter   = " << int(m0.num) << "/" << int(m0.den);
+  if (meter.segments.size() > 1)
+    std::cout << " (changes: " << meter.segments.size() - 1 << ")";
+  std::cout << "\n";
+  if (!meter.keys.empty())
+    std::cout << "  key     = " << midi::key_name(midi::key_at(0, meter))
+              << "\n";
+
   // First 10 notes
   std::cout << "\nFirst 10 note events with time:\n";
   const std::size_t limit = std::min<std::size_t>(10, song.notes.size());
+  midi::MusicalCursor cursor(tempo, meter);
   for (std::size_t i = 0; i < limit; ++i) {
     const auto &ev = song.notes[i];
-    const double t = midi::ticks_to_seconds(ev.tick, tempo);
+    const double t = cursor.seconds(ev.tick);
     std::cout << "t=" << std::fixed << std::setprecision(3) << t << "s  "
+              << std::left << std::setw(10)
+              << midi::format_bbt(cursor.bbt(ev.tick)) << std::right
               << (ev.type == midi::EvType::NoteOn ? "On " : "Off")
               << " ch=" << int(ev.ch) << " note=" << int(ev.note)
               << " vel=" << int(ev.vel) << "\n";
@@ -0,0 +1,635 @@
+// src/app/render_farm.hpp
+// --farm / --farm-worker: batch rendering spread over processes, and over
+// boxes, that share nothing but a spool directory.
+//
+//   coordinator:  midi_player --farm spool --farm-submit corpus/
+//   other boxes:  midi_player --farm-worker spool   (same shared spool)
+//
+// Spool layout (one small "key=value" text manifest per job):
+//   queue/<job>.job         waiting to be claimed
+//   claimed/<job>@<worker>  being rendered by <worker> (host-pid)
+//   done/<job>.job          manifest plus results (frames, seconds, ms)
+//   failed/<job>.job        manifest plus error=...
+//   out/<job>.wav           the render, 32-bit float stereo
+//   tmp/<job>@<worker>.wav.part  that claim's render so far
+//   tmp/<job>@<worker>.ckpt      its last checkpoint
+//   tmp/                    also files being written; renamed into place
+//
+// Design notes:
+// - A worker claims a job by rename(queue/x, claimed/x@me). Rename is atomic
+//   within one filesystem, so exactly one worker wins each job without a
+//   lock server; files only ever appear complete, via tmp/.
+// - Heartbeats: a worker touches its claim's mtime every kFarmHeartbeatSec
+//   while it renders. The coordinator calls a claim stale when its mtime has
+//   not changed for kFarmStaleSec on the coordinator's own clock, so clocks
+//   on other boxes need not agree. A stale claim is renamed away (via tmp/)
+//   and re-queued; a worker that was only slow loses its claim and drops the
+//   job at its next touch.
+// - A job that throws (malformed MIDI, unreadable font) fails at once: the
+//   error is deterministic. A job whose worker dies (crash, kill) is retried
+//   up to kFarmMaxAttempts times, so one poisonous file costs one process,
+//   not the batch.
+// - A worker loads each font once and renders every job on a share()d copy
+//   through audio::OfflineRender; parallelism comes from the processes.
+// - Every checkpoint_sec of wall time (--farm-checkpoint) the worker flushes
+//   the partial output and saves the render state plus the output offset
+//   it belongs to. Whoever claims the job next renames the newest
+//   checkpoint and its partial file to its own claim's names, truncates the
+//   file to that offset and resumes, instead of starting an hours-long
+//   render over.
+// - Partial files are named per claim, so a worker that lost its claim
+//   never finishes, checkpoints over or deletes the next owner's files. It
+//   checks its claim before moving output into out/ and before any cleanup,
+//   and drops the job if the claim is gone. Until its next heartbeat it may
+//   still write through a file it has open, but only the same bytes at the
+//   same offsets; a checkpoint beyond the file's end is discarded.
+// - --ir is recorded in each manifest; the worker loads the impulse
+//   response in ConvolutionReverb::Mode::Offline (large blocks, latency
+//   compensated by OfflineRender). Such jobs are not checkpointed: the
+//   convolver state is not saved, so a retry starts over.
+// - Job names are the file stem plus a hash of its absolute path, so
+//   submitting a corpus again (say, after a coordinator restart) skips jobs
+//   that are queued, running or finished.
+// - Local workers are respawned while jobs are queued: crashed ones, and
+//   ones that ran out of work before a stale claim came back.
+
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char **environ;
+#endif
+
+#include "audio/convolver.hpp"
+#include "audio/offline.hpp"
+#include "audio/schedule.hpp"
+#include "audio/synth.hpp"
+#include "common/hash.hpp"
+#include "common/snapshot.hpp"
+#include "io/io.hpp"
+#include "io/wav.hpp"
+#include "midi/smf.hpp"
+#include "midi/tempo.hpp"
+
+namespace app {
+
+constexpr int kFarmSampleRate = 44100;
+constexpr double kFarmHeartbeatSec = 1.0;
+constexpr double kFarmStaleSec = 10.0;
+constexpr double kFarmPollSec = 0.25;
+constexpr double kFarmCheckpointSec = 30.0;
+constexpr int kFarmMaxAttempts = 3;
+
+struct FarmOptions {
+  std::filesystem::path spool;
+  std::filesystem::path submit;    // directory or MIDI file; empty: none
+  std::filesystem::path soundFont; // recorded in each submitted manifest
+  int workers = 0;                 // local worker processes
+  double checkpointSec = kFarmCheckpointSec; // per job; 0: never
+  std::filesystem::path impulseResponse; // optional convolution reverb
+  bool irOnMaster = false;
+  std::string self;                // argv[0], run as --farm-worker
+};
+
+struct FarmSummary {
+  std::size_t submitted = 0, done = 0, failed = 0, requeued = 0;
+  double audioSec = 0.0;
+  double wallSec = 0.0;
+};
+
+namespace detail {
+
+using JobManifest = std::map<std::string, std::string>;
+
+inline std::string farm_worker_id() {
+#if defined(_WIN32)
+  const char *host = std::getenv("COMPUTERNAME");
+  return std::string(host ? host : "host") + "-" +
+         std::to_string(_getpid());
+#else
+  char host[256] = {};
+  if (gethostname(host, sizeof host - 1) != 0)
+    std::snprintf(host, sizeof host, "host");
+  return std::string(host) + "-" + std::to_string(getpid());
+#endif
+}
+
+// Stem (letters, digits, '-' and '_' only) plus 8 hex digits of the path
+// hash: unique per input file and safe in any filesystem.
+inline std::string farm_job_name(const std::filesystem::path &midi) {
+  std::string name;
+  for (const char c : midi.stem().string().substr(0, 40)) {
+    const bool keep = std::isalnum(static_cast<unsigned char>(c)) ||
+                      c == '-' || c == '_';
+    name += keep ? c : '_';
+  }
+  const std::string abs = std::filesystem::absolute(midi).string();
+  char hex[16];
+  std::snprintf(hex, sizeof hex, "%08x",
+                unsigned(fnv1a(abs.data(), abs.size()) & 0xFFFFFFFFu));
+  return name + "-" + hex;
+}
+
+// Job name of a queue/, done/, failed/ or claimed/ entry.
+inline std::string farm_entry_job(const std::filesystem::path &entry) {
+  const std::string f = entry.filename().string();
+  return f.substr(0, std::min(f.find('@'), f.rfind(".job")));
+}
+
+inline std::vector<std::filesystem::path>
+farm_list(const std::filesystem::path &dir) {
+  std::vector<std::filesystem::path> out;
+  std::error_code ec;
+  for (std::filesystem::directory_iterator it(dir, ec), end;
+       !ec && it != end; it.increment(ec))
+    out.push_back(it->path());
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+inline JobManifest read_job(const std::filesystem::path &file) {
+  std::ifstream in(file);
+  if (!in)
+    throw std::runtime_error("Cannot read job " + file.string());
+  JobManifest m;
+  std::string line;
+  while (std::getline(in, line)) {
+    const std::size_t eq = line.find('=');
+    if (eq != std::string::npos)
+      m[line.substr(0, eq)] = line.substr(eq + 1);
+  }
+  return m;
+}
+
+// Write to tmp/ and rename to `file`, so readers never see a partial file.
+inline void write_atomic(const std::filesystem::path &spool,
+                         const std::filesystem::path &file, const void *data,
+                         std::size_t size) {
+  const std::filesystem::path tmp =
+      spool / "tmp" / (file.filename().string() + "." + farm_worker_id());
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(static_cast<const char *>(data), std::streamsize(size));
+    if (!out)
+      throw std::runtime_error("Cannot write " + tmp.string());
+  }
+  std::filesystem::rename(tmp, file);
+}
+
+inline void write_job(const std::filesystem::path &spool,
+                      const std::filesystem::path &file,
+                      const JobManifest &m) {
+  std::string text;
+  for (const auto &[key, value] : m)
+    text += key + '=' + value + '\n';
+  write_atomic(spool, file, text.data(), text.size());
+}
+
+// Heartbeat; false once the claim is gone (re-queued by the coordinator).
+inline bool farm_touch(const std::filesystem::path &claim) {
+  std::error_code ec;
+  std::filesystem::last_write_time(
+      claim, std::filesystem::file_time_type::clock::now(), ec);
+  return !ec;
+}
+
+inline void farm_dirs(const std::filesystem::path &spool) {
+  for (const char *d : {"queue", "claimed", "done", "failed", "out", "tmp"})
+    std::filesystem::create_directories(spool / d);
+}
+
+// Files in tmp/ that belong to claims on `job`: "<job>@<worker>" plus
+// ".wav.part", ".ckpt" or a write_atomic suffix.
+inline std::vector<std::filesystem::path>
+farm_claim_files(const std::filesystem::path &spool, const std::string &job) {
+  std::vector<std::filesystem::path> out;
+  for (const std::filesystem::path &f : farm_list(spool / "tmp")) {
+    if (f.filename().string().rfind(job + "@", 0) == 0)
+      out.push_back(f);
+  }
+  return out;
+}
+
+// Take over the newest checkpoint an earlier claim on `job` left, and its
+// partial output, by renaming both to this claim's `ckpt` and `part`.
+inline void farm_adopt(const std::filesystem::path &spool,
+                       const std::string &job,
+                       const std::filesystem::path &ckpt,
+                       const std::filesystem::path &part) {
+  namespace fs = std::filesystem;
+  fs::path newest;
+  fs::file_time_type newestTime{};
+  std::error_code ec;
+  for (const fs::path &f : farm_claim_files(spool, job)) {
+    if (f.extension() != ".ckpt" || f == ckpt)
+      continue;
+    const fs::file_time_type t = fs::last_write_time(f, ec);
+    if (!ec && (newest.empty() || t > newestTime)) {
+      newest = f;
+      newestTime = t;
+    }
+  }
+  if (newest.empty())
+    return;
+  fs::path from = newest;
+  from.replace_extension(".wav.part");
+  fs::rename(from, part, ec);
+  if (!ec)
+    fs::rename(newest, ckpt, ec);
+}
+
+// Load the job's checkpoint into `render` if there is one and the partial
+// output reaches its offset. Returns that offset, or 0 to start over.
+inline std::uint64_t farm_resume(const std::filesystem::path &ckpt,
+                                 const std::filesystem::path &part,
+                                 audio::OfflineRender &render) {
+  std::error_code ec;
+  if (!std::filesystem::exists(ckpt, ec))
+    return 0;
+  const std::vector<std::uint8_t> bytes = io::read_all(ckpt);
+  StateReader r(bytes);
+  const auto offset = r.get<std::uint64_t>();
+  const std::uintmax_t size = std::filesystem::file_size(part, ec);
+  if (ec || size < offset)
+    throw std::runtime_error("partial output is shorter than the checkpoint");
+  render.load_state(r);
+  return offset;
+}
+
+// Render one claimed job into out/<job>.wav and file its manifest under
+// done/ or failed/. Returns false if the claim was lost on the way.
+inline bool farm_render(
+    const std::filesystem::path &spool, const std::filesystem::path &claim,
+    std::map<std::string, std::unique_ptr<audio::Synth>> &fonts) {
+  namespace fs = std::filesystem;
+  using clock = std::chrono::steady_clock;
+  const std::string job = farm_entry_job(claim);
+  const std::string mine = claim.filename().string();
+  const fs::path part = spool / "tmp" / (mine + ".wav.part");
+  const fs::path ckpt = spool / "tmp" / (mine + ".ckpt");
+  JobManifest m;
+  std::error_code ec;
+  try {
+    m = read_job(claim);
+    const int rate = std::stoi(m.at("rate"));
+    double every = std::atof(m["checkpoint_sec"].c_str());
+    std::unique_ptr<audio::Synth> &font = fonts[m.at("sf")];
+    if (!font)
+      font = std::make_unique<audio::Synth>(fs::path(m.at("sf")), rate);
+    const midi::Song song = midi::parse_smf(io::read_all(m.at("midi")));
+    const midi::TempoMap tempo = midi::build_tempo_map(song);
+    const audio::Schedule events = audio::build_schedule(song, tempo);
+    auto render = std::make_unique<audio::OfflineRender>(*font, events, rate);
+
+    std::uint64_t offset = 0;
+    if (!m["ir"].empty()) {
+      render->set_convolution(
+          audio::load_impulse_response(
+              m["ir"], rate, audio::ConvolutionReverb::Mode::Offline),
+          m["ir_master"] == "1");
+      every = 0.0;
+    } else {
+      farm_adopt(spool, job, ckpt, part);
+      try {
+        offset = farm_resume(ckpt, part, *render);
+      } catch (const std::exception &e) {
+        std::cerr << "worker " << farm_worker_id() << ": " << job
+                  << ": checkpoint ignored (" << e.what() << ")\n";
+        render = std::make_unique<audio::OfflineRender>(*font, events, rate);
+      }
+    }
+    std::fstream out;
+    if (offset) {
+      fs::resize_file(part, offset);
+      out.open(part, std::ios::binary | std::ios::in | std::ios::out);
+      out.seekp(std::streamoff(offset));
+      char num[32];
+      std::snprintf(num, sizeof num, "%.3f",
+                    double(render->position()) / rate);
+      m["resumed_at"] = num;
+    } else {
+      out.open(part, std::ios::binary | std::ios::out | std::ios::trunc);
+      const std::vector<std::uint8_t> header =
+          io::wav_float_header(rate, 2, render->frames());
+      out.write(reinterpret_cast<const char *>(header.data()),
+                std::streamsize(header.size()));
+      offset = header.size();
+    }
+
+    const auto t0 = clock::now();
+    auto beat = t0, saved = t0;
+    while (render->step() > 0) {
+      const std::size_t bytes = std::size_t(render->block_frames()) * 2 * 4;
+      out.write(reinterpret_cast<const char *>(render->block()),
+                std::streamsize(bytes));
+      offset += bytes;
+      const auto now = clock::now();
+      if (every > 0.0 && now - saved >= std::chrono::duration<double>(every)) {
+        saved = now;
+        if (!out.flush())
+          throw std::runtime_error("Cannot write " + part.string());
+        StateWriter w;
+        w.put(offset);
+        render->save_state(w);
+        write_atomic(spool, ckpt, w.bytes().data(), w.bytes().size());
+      }
+      if (now - beat >= std::chrono::duration<double>(kFarmHeartbeatSec)) {
+        beat = now;
+        if (!farm_touch(claim))
+          return false; // the next owner resumes from the checkpoint
+      }
+    }
+    out.close();
+    if (!out)
+      throw std::runtime_error("Cannot write " + part.string());
+    if (!farm_touch(claim))
+      return false;
+    fs::rename(part, spool / "out" / (job + ".wav"));
+    for (const fs::path &f : farm_claim_files(spool, job))
+      fs::remove(f, ec); // our checkpoint, leftovers of earlier claims
+
+    const double ms =
+        std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+    char num[32];
+    m["frames"] = std::to_string(render->frames());
+    std::snprintf(num, sizeof num, "%.3f", double(render->frames()) / rate);
+    m["seconds"] = num;
+    std::snprintf(num, sizeof num, "%.1f", ms);
+    m["render_ms"] = num;
+    m["worker"] = farm_worker_id();
+    write_job(spool, spool / "done" / (job + ".job"), m);
+  } catch (const std::exception &e) {
+    if (!farm_touch(claim))
+      return false; // the files are the next owner's now
+    for (const fs::path &f : farm_claim_files(spool, job))
+      fs::remove(f, ec);
+    m["error"] = e.what();
+    m["worker"] = farm_worker_id();
+    write_job(spool, spool / "failed" / (job + ".job"), m);
+  }
+  fs::remove(claim, ec);
+  return true;
+}
+
+#if !defined(_WIN32)
+inline pid_t farm_spawn(const std::string &self,
+                        const std::filesystem::path &spool) {
+  std::string a0 = self, a1 = "--farm-worker", a2 = spool.string();
+  char *argv[] = {a0.data(), a1.data(), a2.data(), nullptr};
+  pid_t pid = 0;
+  if (posix_spawnp(&pid, self.c_str(), nullptr, nullptr, argv, environ) != 0)
+    throw std::runtime_error("Cannot start a farm worker: " + self);
+  return pid;
+}
+#endif
+
+} // namespace detail
+
+// Queue every MIDI file under opts.submit (or the one file) that the spool
+// does not know yet. Returns the number of jobs added.
+inline std::size_t farm_submit(const FarmOptions &opts) {
+  namespace fs = std::filesystem;
+  const fs::path &spool = opts.spool, &input = opts.submit;
+  detail::farm_dirs(spool);
+  std::vector<fs::path> files;
+  if (fs::is_directory(input)) {
+    for (const auto &de : fs::recursive_directory_iterator(input)) {
+      if (de.is_regular_file() && io::is_midi_path(de.path()))
+        files.push_back(de.path());
+    }
+    std::sort(files.begin(), files.end());
+  } else {
+    files.push_back(input);
+  }
+
+  std::set<std::string> known;
+  for (const char *d : {"queue", "claimed", "done", "failed"}) {
+    for (const fs::path &e : detail::farm_list(spool / d))
+      known.insert(detail::farm_entry_job(e));
+  }
+  char every[32];
+  std::snprintf(every, sizeof every, "%g",
+                opts.impulseResponse.empty() ? opts.checkpointSec : 0.0);
+  std::size_t added = 0;
+  for (const fs::path &f : files) {
+    const std::string job = detail::farm_job_name(f);
+    if (!known.insert(job).second)
+      continue;
+    detail::JobManifest m{{"midi", fs::absolute(f).string()},
+                          {"sf", fs::absolute(opts.soundFont).string()},
+                          {"rate", std::to_string(kFarmSampleRate)},
+                          {"checkpoint_sec", every},
+                          {"attempts", "0"}};
+    if (!opts.impulseResponse.empty()) {
+      m["ir"] = fs::absolute(opts.impulseResponse).string();
+      m["ir_master"] = opts.irOnMaster ? "1" : "0";
+    }
+    detail::write_job(spool, spool / "queue" / (job + ".job"), m);
+    ++added;
+  }
+  return added;
+}
+
+// --farm-worker: claim and render jobs until the queue is empty. Returns
+// the number of jobs this process finished (done or failed).
+inline std::size_t run_farm_worker(const std::filesystem::path &spool) {
+  namespace fs = std::filesystem;
+  detail::farm_dirs(spool);
+  const std::string me = detail::farm_worker_id();
+  std::map<std::string, std::unique_ptr<audio::Synth>> fonts;
+  std::size_t finished = 0;
+  for (;;) {
+    bool claimed = false;
+    for (const fs::path &q : detail::farm_list(spool / "queue")) {
+      const fs::path claim =
+          spool / "claimed" / (detail::farm_entry_job(q) + "@" + me);
+      std::error_code ec;
+      fs::rename(q, claim, ec);
+      if (ec)
+        continue; // another worker won it
+      claimed = true;
+      if (detail::farm_render(spool, claim, fonts))
+        ++finished;
+      else
+        std::cerr << "worker " << me << ": lost the claim on "
+                  << detail::farm_entry_job(q) << "\n";
+      break;
+    }
+    if (!claimed)
+      return finished;
+  }
+}
+
+// --farm: submit, start opts.workers local workers, re-queue stale claims
+// and report jobs as they finish, until nothing is queued or claimed.
+inline FarmSummary run_farm(const FarmOptions &opts, std::ostream &log) {
+  namespace fs = std::filesystem;
+  using clock = std::chrono::steady_clock;
+  const fs::path &spool = opts.spool;
+  detail::farm_dirs(spool);
+  FarmSummary sum;
+  if (!opts.submit.empty()) {
+    sum.submitted = farm_submit(opts);
+    log << "Queued " << sum.submitted << " jobs in " << spool.string()
+        << std::endl;
+  }
+#if defined(_WIN32)
+  if (opts.workers > 0)
+    throw std::runtime_error("Local farm workers need POSIX; start "
+                             "--farm-worker processes and use "
+                             "--farm-workers 0");
+#else
+  std::vector<pid_t> children;
+#endif
+
+  // Jobs already finished before this run are not reported again.
+  std::set<std::string> reported;
+  for (const char *d : {"done", "failed"}) {
+    for (const fs::path &e : detail::farm_list(spool / d))
+      reported.insert(e.filename().string());
+  }
+  struct Beat {
+    fs::file_time_type mtime;
+    clock::time_point changed; // when we saw mtime change
+  };
+  std::map<std::string, Beat> beats;
+  const auto report = [&] {
+    for (const char *d : {"done", "failed"}) {
+      for (const fs::path &e : detail::farm_list(spool / d)) {
+        if (!reported.insert(e.filename().string()).second)
+          continue;
+        detail::JobManifest m;
+        try {
+          m = detail::read_job(e);
+        } catch (const std::exception &) {
+          continue;
+        }
+        if (d[0] == 'd') {
+          ++sum.done;
+          sum.audioSec += std::atof(m["seconds"].c_str());
+          log << "  done    " << detail::farm_entry_job(e) << "  "
+              << m["seconds"] << " s in " << m["render_ms"] << " ms ("
+              << m["worker"] << ")\n";
+        } else {
+          ++sum.failed;
+          log << "  failed  " << detail::farm_entry_job(e) << ": "
+              << m["error"] << "\n";
+        }
+      }
+    }
+  };
+
+  const auto t0 = clock::now();
+  for (;;) {
+    report();
+#if !defined(_WIN32)
+    for (std::size_t i = 0; i < children.size();) {
+      int status = 0;
+      if (waitpid(children[i], &status, WNOHANG) == 0) {
+        ++i;
+        continue;
+      }
+      if (WIFSIGNALED(status))
+        log << "  worker " << children[i] << " died (signal "
+            << WTERMSIG(status) << ")\n";
+      children.erase(children.begin() + std::ptrdiff_t(i));
+    }
+#endif
+    // Queue before claims: a job moving between the two is seen in one.
+    const std::vector<fs::path> queue = detail::farm_list(spool / "queue");
+    const std::vector<fs::path> claims = detail::farm_list(spool / "claimed");
+    if (queue.empty() && claims.empty())
+      break;
+
+    const clock::time_point now = clock::now();
+    std::map<std::string, Beat> seen;
+    for (const fs::path &c : claims) {
+      std::error_code ec;
+      const fs::file_time_type mtime = fs::last_write_time(c, ec);
+      if (ec)
+        continue;
+      const std::string key = c.filename().string();
+      const auto it = beats.find(key);
+      if (it == beats.end() || it->second.mtime != mtime) {
+        seen[key] = {mtime, now};
+        continue;
+      }
+      if (now - it->second.changed <
+          std::chrono::duration<double>(kFarmStaleSec)) {
+        seen[key] = it->second;
+        continue;
+      }
+      const std::string job = detail::farm_entry_job(c);
+      const fs::path held = spool / "tmp" / (job + ".requeue");
+      fs::rename(c, held, ec);
+      if (ec)
+        continue; // finished meanwhile
+      detail::JobManifest m = detail::read_job(held);
+      const int attempts = std::atoi(m["attempts"].c_str()) + 1;
+      m["attempts"] = std::to_string(attempts);
+      const std::string worker = key.substr(key.find('@') + 1);
+      if (attempts >= kFarmMaxAttempts) {
+        m["error"] = "worker lost " + std::to_string(attempts) +
+                     " times, last " + worker;
+        detail::write_job(spool, spool / "failed" / (job + ".job"), m);
+        for (const fs::path &f : detail::farm_claim_files(spool, job))
+          fs::remove(f, ec);
+      } else {
+        detail::write_job(spool, spool / "queue" / (job + ".job"), m);
+        ++sum.requeued;
+        log << "  requeued " << job << " (" << worker
+            << " stopped responding)\n";
+      }
+      fs::remove(held, ec);
+    }
+    beats = std::move(seen);
+
+#if !defined(_WIN32)
+    if (!queue.empty()) {
+      while (int(children.size()) < opts.workers)
+        children.push_back(detail::farm_spawn(opts.self, spool));
+    }
+#endif
+    std::this_thread::sleep_for(std::chrono::duration<double>(kFarmPollSec));
+  }
+#if !defined(_WIN32)
+  for (const pid_t pid : children)
+    waitpid(pid, nullptr, 0);
+#endif
+  report();
+  sum.wallSec = std::chrono::duration<double>(clock::now() - t0).count();
+  return sum;
+}
+
+inline void print_farm_summary(const FarmSummary &s, std::ostream &os) {
+  const auto flags = os.flags();
+  os << std::fixed << std::setprecision(1) << "Farm: " << s.done
+     << " done, " << s.failed << " failed, " << s.requeued << " requeued; "
+     << s.audioSec << " s of audio in " << s.wallSec << " s ("
+     << (s.wallSec > 0.0 ? s.audioSec / s.wallSec : 0.0) << "x realtime)\n";
+  os.flags(flags);
+}
+
+} // namespace app
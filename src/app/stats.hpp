@@ -0,0 +1,383 @@
+// src/app/stats.hpp
+// --stats: scan a whole corpus (a directory tree or a .mpk pack) and report
+// per-file statistics as JSON lines, then one summary line.
+//
+//   {"file":"jazz/take5.mid","ok":true,"bytes":5120,"format":1,...}
+//   {"file":"broken.mid","ok":false,"error":"Missing MThd"}
+//   {"summary":{"files":1500,"ok":1499,"errors":1,...}}
+//
+// Per file: format, tracks, PPQN, duration, note count in total and per
+// channel, tempo and time signature changes, maximum polyphony and the
+// parse time.
+//
+// Design notes:
+// - Files are spread over one worker per core with work stealing
+//   (common/work_stealing.hpp): corpora mix tiny and huge files, and static
+//   slices would leave cores idle behind the big ones.
+// - Directory files come through io::Readahead: a few I/O threads read a
+//   bounded window of upcoming files, so parsers never block on read() and
+//   memory stays bounded however large the corpus. A file that cannot be
+//   read becomes an error line, like one that does not parse.
+// - Each worker parses into its own FileArena, reset after every file, so
+//   the steady state allocates nothing but the file bytes (none at all for
+//   packs, which are parsed in place from the mapping).
+// - Aggregates are per worker, cache-line aligned and merged after the
+//   join: the hot loop has no locks and no shared atomics besides the
+//   stealing slices. Lines are stored by index and printed in input order,
+//   so the output is identical for any worker count.
+// - Throughput goes to stderr to keep stdout machine-readable.
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "common/arena.hpp"
+#include "common/work_stealing.hpp"
+#include "io/io.hpp"
+#include "io/pack.hpp"
+#include "io/readahead.hpp"
+#include "io/perf_counters.hpp"
+#include "midi/events.hpp"
+#include "midi/smf.hpp"
+#include "midi/tempo.hpp"
+
+namespace app {
+
+struct FileStats {
+  std::size_t bytes = 0;
+  unsigned format = 0;
+  unsigned tracks = 0;
+  unsigned ppqn = 0; // 0 for SMPTE timing
+  double durationSec = 0.0;
+  std::size_t notes = 0; // NoteOn events
+  std::array<std::size_t, 16> channelNotes{};
+  std::size_t tempoChanges = 0;
+  std::size_t timeSigs = 0;
+  std::size_t maxPolyphony = 0;
+  double parseUs = 0.0;
+};
+
+// Corpus totals; one per worker while scanning, merged at the end.
+struct alignas(64) StatsSummary {
+  std::size_t files = 0, errors = 0, bytes = 0, notes = 0;
+  std::array<std::size_t, 3> formats{};
+  std::array<std::size_t, 16> channelNotes{};
+  std::size_t maxPolyphony = 0;
+  double durationSec = 0.0, longestSec = 0.0, parseUs = 0.0;
+  std::map<std::string, std::size_t> errorKinds; // message -> count
+
+  void add(const FileStats &s) {
+    ++files;
+    bytes += s.bytes;
+    notes += s.notes;
+    if (s.format < formats.size())
+      ++formats[s.format];
+    for (std::size_t c = 0; c < 16; ++c)
+      channelNotes[c] += s.channelNotes[c];
+    maxPolyphony = std::max(maxPolyphony, s.maxPolyphony);
+    durationSec += s.durationSec;
+    longestSec = std::max(longestSec, s.durationSec);
+    parseUs += s.parseUs;
+  }
+  void add_error(std::size_t size, const std::string &what) {
+    ++files;
+    ++errors;
+    bytes += size;
+    ++errorKinds[what];
+  }
+  void merge(const StatsSummary &o) {
+    files += o.files;
+    errors += o.errors;
+    bytes += o.bytes;
+    notes += o.notes;
+    for (std::size_t f = 0; f < formats.size(); ++f)
+      formats[f] += o.formats[f];
+    for (std::size_t c = 0; c < 16; ++c)
+      channelNotes[c] += o.channelNotes[c];
+    maxPolyphony = std::max(maxPolyphony, o.maxPolyphony);
+    durationSec += o.durationSec;
+    longestSec = std::max(longestSec, o.longestSec);
+    parseUs += o.parseUs;
+    for (const auto &[what, n] : o.errorKinds)
+      errorKinds[what] += n;
+  }
+};
+
+namespace detail {
+
+inline void json_string(std::string &out, std::string_view s) {
+  out += '"';
+  for (const char ch : s) {
+    const auto c = static_cast<unsigned char>(ch);
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += ch;
+    } else if (c < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof buf, "\\u%04x", c);
+      out += buf;
+    } else {
+      out += ch;
+    }
+  }
+  out += '"';
+}
+
+inline void json_number(std::string &out, double v, int decimals) {
+  char buf[32];
+  std::snprintf(buf, sizeof buf, "%.*f", decimals, v);
+  out += buf;
+}
+
+// Most notes sounding at once. Ons and offs are paired per (port, channel,
+// key) like the scheduler plays them: offs before ons at equal ticks, an off
+// with nothing held is ignored.
+inline std::size_t max_polyphony(const midi::Song &song,
+                                 std::pmr::memory_resource *mr) {
+  const auto &notes = song.notes;
+  std::pmr::vector<std::uint64_t> order(mr);
+  order.reserve(notes.size());
+  for (std::size_t i = 0; i < notes.size(); ++i) {
+    const bool on = notes[i].type == midi::EvType::NoteOn;
+    order.push_back(std::uint64_t(notes[i].tick) << 32 |
+                    std::uint64_t(on) << 31 | std::uint64_t(i));
+  }
+  std::sort(order.begin(), order.end());
+
+  std::size_t ports = 1;
+  for (const auto &n : notes)
+    ports = std::max(ports, std::size_t(n.port) + 1);
+  std::pmr::vector<std::uint16_t> held(ports * 16 * 128, 0, mr);
+  std::size_t now = 0, peak = 0;
+  for (const std::uint64_t k : order) {
+    const midi::NoteEv &n = notes[std::size_t(k & 0x7FFFFFFFu)];
+    const std::size_t chan = std::size_t(n.port) * 16 + (n.ch & 15u);
+    std::uint16_t &h = held[chan * 128 + (n.note & 127u)];
+    if (n.type == midi::EvType::NoteOn) {
+      ++h;
+      peak = std::max(peak, ++now);
+    } else if (h > 0) {
+      --h;
+      --now;
+    }
+  }
+  return peak;
+}
+
+inline FileStats scan_file(const std::uint8_t *data, std::size_t size,
+                           std::pmr::memory_resource *mr) {
+  using clock = std::chrono::steady_clock;
+  FileStats s;
+  s.bytes = size;
+  io::PerfScope perf(io::PerfStage::Parse);
+  const auto t0 = clock::now();
+  const midi::Song song = midi::parse_smf(data, size, mr);
+  s.parseUs =
+      std::chrono::duration<double, std::micro>(clock::now() - t0).count();
+  perf.set_units(song.notes.size() + song.ctrls.size());
+  perf.stop();
+
+  s.format = song.header.format;
+  s.tracks = song.header.nTracks;
+  s.ppqn = song.header.isPPQN ? song.header.ppqn : 0;
+  std::uint32_t last = 0;
+  for (const auto &n : song.notes) {
+    last = std::max(last, n.tick);
+    if (n.type == midi::EvType::NoteOn) {
+      ++s.notes;
+      ++s.channelNotes[n.ch & 15u];
+    }
+  }
+  for (const auto &c : song.ctrls)
+    last = std::max(last, c.tick);
+  s.tempoChanges = song.tempi.size();
+  s.timeSigs = song.timeSigs.size();
+  s.durationSec =
+      midi::ticks_to_seconds(last, midi::build_tempo_map(song, mr));
+  s.maxPolyphony = max_polyphony(song, mr);
+  return s;
+}
+
+inline std::string file_json(std::string_view name, const FileStats &s) {
+  std::string out;
+  out.reserve(320);
+  out += "{\"file\":";
+  json_string(out, name);
+  out += ",\"ok\":true,\"bytes\":" + std::to_string(s.bytes);
+  out += ",\"format\":" + std::to_string(s.format);
+  out += ",\"tracks\":" + std::to_string(s.tracks);
+  out += ",\"ppqn\":" + std::to_string(s.ppqn);
+  out += ",\"duration_s\":";
+  json_number(out, s.durationSec, 3);
+  out += ",\"notes\":" + std::to_string(s.notes);
+  out += ",\"channel_notes\":[";
+  for (std::size_t c = 0; c < 16; ++c) {
+    if (c)
+      out += ',';
+    out += std::to_string(s.channelNotes[c]);
+  }
+  out += "],\"tempo_changes\":" + std::to_string(s.tempoChanges);
+  out += ",\"time_sigs\":" + std::to_string(s.timeSigs);
+  out += ",\"max_polyphony\":" + std::to_string(s.maxPolyphony);
+  out += ",\"parse_us\":";
+  json_number(out, s.parseUs, 1);
+  out += '}';
+  return out;
+}
+
+inline std::string error_json(std::string_view name, std::string_view what) {
+  std::string out = "{\"file\":";
+  json_string(out, name);
+  out += ",\"ok\":false,\"error\":";
+  json_string(out, what);
+  out += '}';
+  return out;
+}
+
+inline std::string summary_json(const StatsSummary &s, int workers,
+                                double wallSec) {
+  std::string out = "{\"summary\":{\"files\":" + std::to_string(s.files);
+  out += ",\"ok\":" + std::to_string(s.files - s.errors);
+  out += ",\"errors\":" + std::to_string(s.errors);
+  out += ",\"bytes\":" + std::to_string(s.bytes);
+  out += ",\"notes\":" + std::to_string(s.notes);
+  out += ",\"formats\":[" + std::to_string(s.formats[0]) + ',' +
+         std::to_string(s.formats[1]) + ',' + std::to_string(s.formats[2]);
+  out += "],\"channel_notes\":[";
+  for (std::size_t c = 0; c < 16; ++c) {
+    if (c)
+      out += ',';
+    out += std::to_string(s.channelNotes[c]);
+  }
+  out += "],\"max_polyphony\":" + std::to_string(s.maxPolyphony);
+  out += ",\"total_duration_s\":";
+  json_number(out, s.durationSec, 3);
+  out += ",\"longest_s\":";
+  json_number(out, s.longestSec, 3);
+  out += ",\"parse_us\":";
+  json_number(out, s.parseUs, 1);
+  out += ",\"error_kinds\":{";
+  bool first = true;
+  for (const auto &[what, n] : s.errorKinds) {
+    if (!first)
+      out += ',';
+    first = false;
+    json_string(out, what);
+    out += ':' + std::to_string(n);
+  }
+  out += "},\"workers\":" + std::to_string(workers);
+  out += ",\"wall_s\":";
+  json_number(out, wallSec, 3);
+  out += "}}";
+  return out;
+}
+
+} // namespace detail
+
+// Scan `path` (a directory, walked recursively for MIDI files, or a .mpk
+// pack) and write one JSON line per file plus the summary to `out`.
+inline StatsSummary run_stats(const std::filesystem::path &path,
+                              std::ostream &out, int workers = 0) {
+  namespace fs = std::filesystem;
+  using clock = std::chrono::steady_clock;
+  if (workers <= 0)
+    workers = int(std::max(1u, std::thread::hardware_concurrency()));
+
+  // Inputs: names plus either a file path or a pack entry.
+  std::vector<std::string> names;
+  std::vector<fs::path> paths;
+  std::vector<const io::PackEntry *> entries;
+  std::unique_ptr<io::PackReader> pack;
+  if (fs::is_directory(path)) {
+    for (const auto &de : fs::recursive_directory_iterator(path)) {
+      if (de.is_regular_file() && io::is_midi_path(de.path()))
+        paths.push_back(de.path());
+    }
+    std::sort(paths.begin(), paths.end());
+    names.reserve(paths.size());
+    for (const auto &p : paths)
+      names.push_back(p.lexically_relative(path).generic_string());
+  } else {
+    pack = std::make_unique<io::PackReader>(path);
+    pack->advise_sequential();
+    for (const io::PackEntry &e : *pack) {
+      entries.push_back(&e);
+      names.emplace_back(pack->name(e));
+    }
+  }
+
+  const std::size_t n = names.size();
+  std::vector<std::string> lines(n);
+  std::vector<StatsSummary> sums(std::size_t(workers), StatsSummary{});
+  std::vector<std::unique_ptr<FileArena>> arenas;
+  for (int w = 0; w < workers; ++w)
+    arenas.push_back(std::make_unique<FileArena>(std::size_t(256) << 10));
+
+  const auto scan = [&](int w, std::size_t i, const std::uint8_t *data,
+                        std::size_t size) {
+    StatsSummary &sum = sums[std::size_t(w)];
+    FileArena &arena = *arenas[std::size_t(w)];
+    try {
+      const FileStats s = detail::scan_file(data, size, arena.resource());
+      sum.add(s);
+      lines[i] = detail::file_json(names[i], s);
+    } catch (const std::exception &ex) {
+      sum.add_error(size, ex.what());
+      lines[i] = detail::error_json(names[i], ex.what());
+    }
+    arena.reset();
+  };
+
+  const auto t0 = clock::now();
+  if (pack) {
+    parallel_for_stealing(n, workers, [&](int w, std::size_t i) {
+      scan(w, i, pack->data(*entries[i]), entries[i]->length);
+    });
+  } else {
+    // Each of the n calls takes whichever file the window delivers next;
+    // r.index says which one it is.
+    io::Readahead files(std::move(paths));
+    parallel_for_stealing(n, workers, [&](int w, std::size_t) {
+      io::ReadResult r;
+      if (!files.next(r))
+        return;
+      if (!r.error.empty()) {
+        sums[std::size_t(w)].add_error(0, r.error);
+        lines[r.index] = detail::error_json(names[r.index], r.error);
+        return;
+      }
+      scan(w, r.index, r.bytes.data(), r.bytes.size());
+    });
+  }
+  const double wall = std::chrono::duration<double>(clock::now() - t0).count();
+
+  StatsSummary total;
+  for (const auto &s : sums)
+    total.merge(s);
+  for (const auto &l : lines)
+    out << l << '\n';
+  out << detail::summary_json(total, workers, wall) << '\n';
+  out.flush();
+
+  std::fprintf(stderr,
+               "Scanned %zu files (%.1f MiB) in %.3f s on %d workers: "
+               "%.0f files/s, %zu errors\n",
+               total.files, double(total.bytes) / (1024.0 * 1024.0), wall,
+               workers, wall > 0.0 ? double(total.files) / wall : 0.0,
+               total.errors);
+  return total;
+}
+
+} // namespace app
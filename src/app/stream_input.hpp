@@ -0,0 +1,204 @@
+// src/app/stream_input.hpp
+// Play a MIDI file while it is still arriving on stdin or a pipe:
+//
+//   generator | midi_player -
+//   midi_player <(generator)
+//
+// Design notes:
+//  * A reader thread feeds midi::SmfStreamParser as bytes arrive; play()
+//    polls this as its ReloadSource and splices the growing song in at the
+//    playhead, like --watch.
+//  * Format 0 starts as soon as the header has arrived and grows at most
+//    every kMinIntervalSec (each version rebuilds the schedule). Format 1
+//    tracks follow each other in the stream, so those wait for the last
+//    one. Events should arrive ahead of the playhead: notes that are
+//    already due when they arrive are dropped.
+//  * The version handed out after EOF (or after a parse error, which is
+//    reported) is the final one: playback ends with it.
+//  * The reader polls with a timeout so Ctrl-C never waits on a quiet pipe.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "audio/player.hpp"
+#include "midi/smf.hpp"
+#include "midi/tempo.hpp"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace app {
+
+class StreamInput : public audio::ReloadSource {
+public:
+  static constexpr double kMinIntervalSec = 0.25;
+
+  // `path` is "-" for stdin, or a FIFO / character device.
+  explicit StreamInput(const std::string &path) {
+#if defined(_WIN32)
+    throw std::runtime_error("Streaming MIDI input is not supported on this "
+                             "platform: " + path);
+#else
+    fd_ = path == "-" ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      throw std::runtime_error("Could not open " + path + ": " +
+                               std::strerror(errno));
+    }
+    ownsFd_ = path != "-";
+    reader_ = std::thread([this] { reader_loop(); });
+#endif
+  }
+
+  ~StreamInput() override {
+    quit_.store(true, std::memory_order_relaxed);
+    if (reader_.joinable())
+      reader_.join();
+#if !defined(_WIN32)
+    if (ownsFd_)
+      ::close(fd_);
+#endif
+  }
+
+  // Block until there is something to play (the header of a format-0
+  // stream, all tracks otherwise), the stream ended, or *stop is raised.
+  // Then take the first version. Throws if nothing playable arrived.
+  void wait_initial(const std::atomic<bool> &stop, midi::Song &song,
+                    midi::TempoMap &tempo) {
+    std::unique_lock<std::mutex> lock(m_);
+    while (!stop.load(std::memory_order_relaxed) && !ended_ &&
+           !playable()) {
+      cv_.wait_for(lock, std::chrono::milliseconds(50));
+    }
+    if (!playable() && !ended_)
+      throw std::runtime_error("Interrupted before the stream started");
+    check_end();
+    if (!parser_.has_header())
+      throw std::runtime_error(error_);
+    if (!error_.empty())
+      std::cerr << "stream: " << error_ << "\n";
+    take_version();
+    song = snapshot_;
+    tempo = tempoSnap_;
+  }
+
+  bool poll(const midi::Song *&song, const midi::TempoMap *&tempo) override {
+    std::lock_guard<std::mutex> lock(m_);
+    if (final_)
+      return false;
+    const auto now = std::chrono::steady_clock::now();
+    const bool grew = event_count() != delivered_;
+    if (!ended_ &&
+        (!grew || !playable() ||
+         now - lastVersion_ < std::chrono::duration<double>(kMinIntervalSec)))
+      return false;
+    check_end();
+    if (!error_.empty())
+      std::cerr << "stream: " << error_ << "\n";
+    take_version();
+    song = &snapshot_;
+    tempo = &tempoSnap_;
+    return true;
+  }
+
+  // Both refer to the last version handed out (waiting thread only).
+  bool complete() const override { return final_; }
+  bool finished() const override { return final_; }
+
+private:
+  bool playable() const {
+    return parser_.complete() ||
+           (parser_.has_header() && parser_.song().header.format == 0);
+  }
+
+  std::size_t event_count() const {
+    const midi::Song &s = parser_.song();
+    return s.notes.size() + s.ctrls.size() + s.tempi.size() +
+           s.timeSigs.size() + s.keySigs.size();
+  }
+
+  // Caller holds m_. A stream that ended early plays what arrived, with a
+  // warning.
+  void check_end() {
+    if (!ended_ || !error_.empty())
+      return;
+    try {
+      parser_.finish();
+    } catch (const std::exception &ex) {
+      error_ = ex.what();
+    }
+  }
+
+  // Caller holds m_.
+  void take_version() {
+    snapshot_ = parser_.song();
+    tempoSnap_ = midi::build_tempo_map(snapshot_);
+    delivered_ = event_count();
+    lastVersion_ = std::chrono::steady_clock::now();
+    final_ = ended_;
+  }
+
+#if defined(_WIN32)
+  void reader_loop() {}
+#else
+  void reader_loop() {
+    std::uint8_t buf[65536];
+    pollfd pfd{fd_, POLLIN, 0};
+    while (!quit_.load(std::memory_order_relaxed)) {
+      if (::poll(&pfd, 1, 50) <= 0)
+        continue;
+      const ssize_t n = ::read(fd_, buf, sizeof buf);
+      if (n < 0 && (errno == EINTR || errno == EAGAIN))
+        continue;
+      std::lock_guard<std::mutex> lock(m_);
+      try {
+        if (n > 0) {
+          parser_.feed(buf, std::size_t(n));
+        } else {
+          if (n < 0)
+            error_ = std::string("read: ") + std::strerror(errno);
+          ended_ = true;
+        }
+      } catch (const std::exception &ex) {
+        error_ = ex.what();
+        ended_ = true;
+      }
+      cv_.notify_all();
+      if (ended_)
+        return;
+    }
+  }
+#endif
+
+  int fd_ = -1;
+  bool ownsFd_ = false;
+  std::thread reader_;
+  std::atomic<bool> quit_{false};
+
+  std::mutex m_;
+  std::condition_variable cv_;
+  midi::SmfStreamParser parser_;
+  bool ended_ = false; // EOF or error: no more bytes will be parsed
+  std::string error_;
+
+  // Versions handed to play() (waiting thread only).
+  midi::Song snapshot_;
+  midi::TempoMap tempoSnap_;
+  std::size_t delivered_ = 0;
+  std::chrono::steady_clock::time_point lastVersion_{};
+  bool final_ = false;
+};
+
+} // namespace app
@@ -0,0 +1,168 @@
+// src/audio/admission.hpp
+// CPU demand of a song and the cost model behind it, for admission control
+// in the mixer (Mixer::try_add, Mixer::headroom).
+//
+//   audio::CostModel model = audio::CostModel::from(
+//       audio::measure_interp_cost(font, 0.25)); // or the built-in defaults
+//   model.calibrate_channels();                  // from the cost tables
+//   const audio::SongDemand d = audio::estimate_demand(song, tempo, model);
+//   double cores = model.cores(d.peakVoices, audio::Interp::Cubic, 44100);
+//
+// Design notes:
+// - Demand is the song's peak polyphony, not its average: a session that
+//   fits on average still glitches on its densest chord. Notes are held for
+//   kReleaseSec after their note-off, as their voices ring through the
+//   release, and each channel's notes count channelWeight[ch] voices.
+// - Programs are not parsed yet (every channel plays GM 0, drums on 10), so
+//   a channel's preset is fixed for the whole song and the per-channel
+//   weights are the per-preset cost model. calibrate_channels() takes them
+//   from the render cost tables (audio/render_cost.hpp): voices started per
+//   note-on times the channel's cost per voice-frame relative to the mean.
+//   The tables only fill while something renders with cost accounting on;
+//   Mixer::calibrate_channels() pre-renders the start of each song for
+//   that.
+// - Cores are fractions of one core's real-time budget: 1.0 means one core
+//   fully busy rendering.
+// - Quality tiers are the interpolation modes, best first; downgrading a
+//   session moves it to a cheaper kernel (sinc16 -> sinc8 -> cubic ->
+//   linear).
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "audio/interp.hpp"
+#include "audio/render_cost.hpp"
+#include "audio/synth.hpp"
+#include "midi/events.hpp"
+#include "midi/tempo.hpp"
+
+namespace audio {
+
+constexpr double kReleaseSec = 0.3;  // voices ring this long after note-off
+constexpr double kAdmitBudget = 0.7; // share of each core sessions may fill
+
+struct CostModel {
+  // Wall time per voice per output sample, by Interp. The defaults are
+  // conservative figures for a desktop core; from() measures this machine.
+  std::array<double, 4> nsPerVoiceSample{8.0, 12.0, 20.0, 30.0};
+  // Average voices a note on this channel costs (see the notes above).
+  std::array<double, kMidiChannels> channelWeight{
+      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+  double sessionCores = 0.005; // per session: event feed, buses, summing
+
+  static CostModel from(const std::vector<InterpCost> &costs) {
+    CostModel m;
+    for (const InterpCost &c : costs) {
+      if (c.nsPerVoiceSample > 0.0)
+        m.nsPerVoiceSample[std::size_t(c.mode)] = c.nsPerVoiceSample;
+    }
+    return m;
+  }
+
+  // Channel weights from what has been rendered so far (needs
+  // cost_enable()); channels never played keep their weight.
+  void calibrate_channels() {
+    std::uint64_t ticks = 0, frames = 0;
+    for (int ch = 0; ch < kMidiChannels; ++ch) {
+      const CostTotals t = cost_channel_totals(ch);
+      ticks += t.ticks;
+      frames += t.voiceFrames;
+    }
+    if (!ticks || !frames)
+      return;
+    const double mean = double(ticks) / double(frames);
+    for (int ch = 0; ch < kMidiChannels; ++ch) {
+      const CostTotals t = cost_channel_totals(ch);
+      if (!t.voiceFrames || !t.noteOns)
+        continue;
+      const double perFrame = double(t.ticks) / double(t.voiceFrames);
+      const double perNote = double(t.voices) / double(t.noteOns);
+      channelWeight[std::size_t(ch)] = perNote * perFrame / mean;
+    }
+  }
+
+  // Cores needed to render `voices` average voices at `tier`.
+  [[nodiscard]] double cores(double voices, Interp tier,
+                             int sampleRate) const {
+    return sessionCores + voices * nsPerVoiceSample[std::size_t(tier)] *
+                              double(sampleRate) * 1e-9;
+  }
+};
+
+struct SongDemand {
+  double peakVoices = 0.0; // weighted, capped at the session's voice limit
+  double meanVoices = 0.0; // weighted, averaged over the song
+  double durationSec = 0.0;
+};
+
+// Weighted polyphony of `song`: a sweep over note-ons and (release-
+// extended) note-offs in seconds. Repeated note-ons on one key each count,
+// as tsf starts a voice for each.
+inline SongDemand estimate_demand(const midi::Song &song,
+                                  const midi::TempoMap &tempo,
+                                  const CostModel &model,
+                                  int voiceCap = 64) {
+  struct Edge {
+    double t;
+    double w; // > 0 on, < 0 off
+  };
+  std::vector<Edge> edges;
+  edges.reserve(song.notes.size());
+  std::size_t ports = 1;
+  for (const midi::NoteEv &n : song.notes)
+    ports = std::max(ports, std::size_t(n.port) + 1);
+  std::vector<std::uint16_t> held(ports * 16 * 128, 0);
+  std::vector<std::uint32_t> order(song.notes.size());
+  for (std::uint32_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::uint32_t a, std::uint32_t b) {
+                     return song.notes[a].tick < song.notes[b].tick;
+                   });
+  double end = 0.0;
+  for (std::uint32_t i : order) {
+    const midi::NoteEv &n = song.notes[i];
+    const double t = midi::ticks_to_seconds(n.tick, tempo);
+    const double w = model.channelWeight[n.ch & 15u];
+    const std::size_t chan = std::size_t(n.port) * 16 + (n.ch & 15u);
+    std::uint16_t &h = held[chan * 128 + (n.note & 127u)];
+    end = std::max(end, t);
+    if (n.type == midi::EvType::NoteOn) {
+      ++h;
+      edges.push_back({t, w});
+    } else if (h > 0) {
+      --h;
+      edges.push_back({t + kReleaseSec, -w});
+    }
+  }
+  std::stable_sort(edges.begin(), edges.end(),
+                   [](const Edge &a, const Edge &b) {
+                     return a.t < b.t || (a.t == b.t && a.w < b.w);
+                   });
+
+  SongDemand d;
+  d.durationSec = end + kReleaseSec;
+  double now = 0.0, area = 0.0, last = 0.0;
+  for (const Edge &e : edges) {
+    area += now * (e.t - last);
+    last = e.t;
+    now = std::max(0.0, now + e.w);
+    d.peakVoices = std::max(d.peakVoices, now);
+  }
+  d.peakVoices = std::min(d.peakVoices, double(voiceCap));
+  d.meanVoices = d.durationSec > 0.0 ? area / d.durationSec : 0.0;
+  return d;
+}
+
+// Tiers a session may be moved to from `best`, best first.
+inline std::vector<Interp> tiers_from(Interp best) {
+  std::vector<Interp> out;
+  for (int t = int(best); t >= int(Interp::Linear); --t)
+    out.push_back(Interp(t));
+  return out;
+}
+
+} // namespace audio
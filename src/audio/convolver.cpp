@@ -0,0 +1,313 @@
+// src/audio/convolver.cpp
+// Uniform overlap-save convolver, the two-tier realtime reverb built from it,
+// and the WAV impulse-response loader.
+
+#include "audio/convolver.hpp"
+#include "audio/simd.hpp"
+#include "io/io.hpp"
+#include "io/wav.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Linear-interpolation resampler; IRs are resampled once at load time.
+std::vector<float> resample(const std::vector<float> &x, int from, int to) {
+  if (from == to || x.empty())
+    return x;
+  const double step = double(from) / to;
+  const auto n = static_cast<std::size_t>(double(x.size()) / step);
+  std::vector<float> y(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const double pos = double(i) * step;
+    const auto j = static_cast<std::size_t>(pos);
+    const float frac = static_cast<float>(pos - double(j));
+    const float a = x[j], b = j + 1 < x.size() ? x[j + 1] : 0.0f;
+    y[i] = a + (b - a) * frac;
+  }
+  return y;
+}
+
+double energy(const std::vector<float> &x) {
+  double e = 0.0;
+  for (float v : x)
+    e += double(v) * v;
+  return e;
+}
+
+} // namespace
+
+namespace audio {
+
+// --- UniformConvolver ------------------------------------------------------
+
+UniformConvolver::UniformConvolver(const float *ir, std::size_t irLen,
+                                   int block)
+    : block_(block),
+      parts_(std::max(1, static_cast<int>((irLen + std::size_t(block) - 1) /
+                                          std::size_t(block)))),
+      fft_(2 * block) {
+  const std::size_t bins = std::size_t(block_);
+  irRe_.assign(bins * std::size_t(parts_), 0.0f);
+  irIm_.assign(irRe_.size(), 0.0f);
+  fdlRe_.assign(irRe_.size(), 0.0f);
+  fdlIm_.assign(irRe_.size(), 0.0f);
+  frame_.assign(2 * bins, 0.0f);
+  accRe_.assign(bins, 0.0f);
+  accIm_.assign(bins, 0.0f);
+  time_.assign(2 * bins, 0.0f);
+
+  // Partition p holds taps [pB, pB + B), zero-padded to 2B. The inverse FFT
+  // is unscaled, so its 1/2B is folded into the stored spectra.
+  const float scale = 1.0f / float(2 * block_);
+  for (int p = 0; p < parts_; ++p) {
+    std::fill(time_.begin(), time_.end(), 0.0f);
+    const std::size_t begin = std::size_t(p) * bins;
+    for (std::size_t i = 0; i < bins && begin + i < irLen; ++i)
+      time_[i] = ir[begin + i] * scale;
+    fft_.forward(time_.data(), irRe_.data() + begin, irIm_.data() + begin);
+  }
+}
+
+void UniformConvolver::process_block(const float *in, float *out) {
+  using namespace simd;
+  const int b = block_;
+  std::copy(frame_.begin() + b, frame_.end(), frame_.begin());
+  std::copy(in, in + b, frame_.begin() + b);
+
+  float *xr = fdlRe_.data() + std::size_t(fdlHead_) * std::size_t(b);
+  float *xi = fdlIm_.data() + std::size_t(fdlHead_) * std::size_t(b);
+  fft_.forward(frame_.data(), xr, xi);
+
+  // acc = sum_p X[t - p] * H[p]. Bin 0 packs two real bins (DC, Nyquist)
+  // and is fixed up separately after the vector loop.
+  std::fill(accRe_.begin(), accRe_.end(), 0.0f);
+  std::fill(accIm_.begin(), accIm_.end(), 0.0f);
+  float dc = 0.0f, nyquist = 0.0f;
+  int slot = fdlHead_;
+  for (int p = 0; p < parts_; ++p) {
+    const std::size_t xo = std::size_t(slot) * std::size_t(b);
+    const std::size_t ho = std::size_t(p) * std::size_t(b);
+    const float *ar = fdlRe_.data() + xo, *ai = fdlIm_.data() + xo;
+    const float *hr = irRe_.data() + ho, *hi = irIm_.data() + ho;
+    dc += ar[0] * hr[0];
+    nyquist += ai[0] * hi[0];
+    for (int k = 0; k < b; k += 4) {
+      const F32x4 a_r = load4(ar + k), a_i = load4(ai + k);
+      const F32x4 h_r = load4(hr + k), h_i = load4(hi + k);
+      store4(accRe_.data() + k,
+             load4(accRe_.data() + k) + (a_r * h_r - a_i * h_i));
+      store4(accIm_.data() + k,
+             load4(accIm_.data() + k) + (a_r * h_i + a_i * h_r));
+    }
+    slot = slot == 0 ? parts_ - 1 : slot - 1;
+  }
+  accRe_[0] = dc;
+  accIm_[0] = nyquist;
+
+  fft_.inverse(accRe_.data(), accIm_.data(), time_.data());
+  std::copy(time_.begin() + b, time_.end(), out); // overlap-save: 2nd half
+  fdlHead_ = fdlHead_ + 1 == parts_ ? 0 : fdlHead_ + 1;
+}
+
+// --- ConvolutionReverb -----------------------------------------------------
+
+ConvolutionReverb::ConvolutionReverb(const std::vector<float> &irLeft,
+                                     const std::vector<float> &irRight,
+                                     Mode mode)
+    : headBlock_(mode == Mode::Offline ? kOfflineBlock : kHeadBlock),
+      irFrames_(std::max(irLeft.size(), irRight.size())) {
+  const std::vector<float> *ir[2] = {&irLeft,
+                                     irRight.empty() ? &irLeft : &irRight};
+
+  // Realtime: the tail block for input period p plays during period p + 2,
+  // i.e. 2L after its input and L after the head's own B latency, so the
+  // head has to cover the first 2L - B taps.
+  const std::size_t headTaps = mode == Mode::Offline
+                                   ? irFrames_
+                                   : std::size_t(2 * kTailBlock - kHeadBlock);
+  for (int c = 0; c < 2; ++c) {
+    const std::vector<float> &h = *ir[c];
+    head_.emplace_back(h.data(), std::min(h.size(), headTaps), headBlock_);
+    headIn_[c].assign(std::size_t(headBlock_), 0.0f);
+    headOut_[c].assign(std::size_t(headBlock_), 0.0f);
+  }
+
+  if (mode == Mode::Offline || irFrames_ <= headTaps)
+    return;
+  for (int c = 0; c < 2; ++c) {
+    const std::vector<float> &h = *ir[c];
+    const std::size_t n = h.size() > headTaps ? h.size() - headTaps : 0;
+    tail_.emplace_back(h.data() + (h.size() - n), n, kTailBlock);
+  }
+  for (TailSlot &s : slots_) {
+    for (int c = 0; c < 2; ++c) {
+      s.in[c].assign(std::size_t(kTailBlock), 0.0f);
+      s.out[c].assign(std::size_t(kTailBlock), 0.0f);
+    }
+  }
+  thread_ = std::thread([this] { worker(); });
+}
+
+ConvolutionReverb::~ConvolutionReverb() {
+  if (!thread_.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    quit_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void ConvolutionReverb::begin_tail_period() {
+  // We read block period_ - 2 from, and capture block period_ into, the same
+  // slot. A slot still Queued means the worker is behind: skip both.
+  TailSlot &s = slots_[period_ & 1];
+  const int st = s.state.load(std::memory_order_acquire);
+  if (st == Queued) {
+    late_.fetch_add(1, std::memory_order_relaxed);
+    filling_ = false;
+    reading_ = nullptr;
+    return;
+  }
+  reading_ = (st == Done && s.block == period_ - 2) ? &s : nullptr;
+  filling_ = true;
+}
+
+void ConvolutionReverb::end_tail_period() {
+  if (filling_) {
+    TailSlot &s = slots_[period_ & 1];
+    s.block = period_;
+    s.state.store(Queued, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lk(m_); // short; same as the mixer's pool
+    }
+    cv_.notify_one();
+  }
+  ++period_;
+  tailPos_ = 0;
+}
+
+void ConvolutionReverb::worker() {
+  std::int64_t last = -1; // last block fed to the tail convolvers
+  std::vector<float> silence(std::size_t(kTailBlock), 0.0f), scratch(silence);
+  for (;;) {
+    TailSlot *job = nullptr;
+    {
+      std::unique_lock<std::mutex> lk(m_);
+      cv_.wait(lk, [&] {
+        job = nullptr;
+        if (quit_)
+          return true;
+        for (TailSlot &s : slots_) {
+          if (s.state.load(std::memory_order_acquire) == Queued &&
+              (!job || s.block < job->block))
+            job = &s;
+        }
+        return job != nullptr;
+      });
+      if (quit_)
+        return;
+    }
+
+    // Keep the delay lines time-aligned across dropped blocks (bounded: after
+    // one IR length of silence the history is all zeros anyway).
+    const std::int64_t gap = std::min<std::int64_t>(
+        job->block - last - 1, tail_[0].partitions());
+    for (std::int64_t g = 0; g < gap; ++g) {
+      for (UniformConvolver &t : tail_)
+        t.process_block(silence.data(), scratch.data());
+    }
+    for (int c = 0; c < 2; ++c)
+      tail_[std::size_t(c)].process_block(job->in[c].data(),
+                                          job->out[c].data());
+    last = job->block;
+    job->state.store(Done, std::memory_order_release);
+  }
+}
+
+void ConvolutionReverb::process(const float *in, float *out, int frames,
+                                float wet) {
+  const bool hasTail = !tail_.empty();
+  int i = 0;
+  while (i < frames) {
+    if (hasTail && tailPos_ == 0)
+      begin_tail_period();
+
+    // kTailBlock is a multiple of kHeadBlock, so a head block never straddles
+    // a tail period.
+    const int n = std::min(frames - i, headBlock_ - headPos_);
+    const float *src = in + std::size_t(i) * 2;
+    float *dst = out + std::size_t(i) * 2;
+    float *hinL = headIn_[0].data() + headPos_;
+    float *hinR = headIn_[1].data() + headPos_;
+    const float *houtL = headOut_[0].data() + headPos_;
+    const float *houtR = headOut_[1].data() + headPos_;
+    for (int j = 0; j < n; ++j) {
+      hinL[j] = src[2 * j];
+      hinR[j] = src[2 * j + 1];
+      dst[2 * j] += houtL[j] * wet;
+      dst[2 * j + 1] += houtR[j] * wet;
+    }
+    if (hasTail) {
+      if (filling_) {
+        TailSlot &s = slots_[period_ & 1];
+        for (int j = 0; j < n; ++j) {
+          s.in[0][std::size_t(tailPos_ + j)] = src[2 * j];
+          s.in[1][std::size_t(tailPos_ + j)] = src[2 * j + 1];
+        }
+      }
+      if (reading_) {
+        const float *tL = reading_->out[0].data() + tailPos_;
+        const float *tR = reading_->out[1].data() + tailPos_;
+        for (int j = 0; j < n; ++j) {
+          dst[2 * j] += tL[j] * wet;
+          dst[2 * j + 1] += tR[j] * wet;
+        }
+      }
+      tailPos_ += n;
+    }
+
+    headPos_ += n;
+    i += n;
+    if (headPos_ == headBlock_) {
+      for (int c = 0; c < 2; ++c)
+        head_[std::size_t(c)].process_block(headIn_[c].data(),
+                                            headOut_[c].data());
+      headPos_ = 0;
+    }
+    if (hasTail && tailPos_ == kTailBlock)
+      end_tail_period();
+  }
+}
+
+std::unique_ptr<ConvolutionReverb>
+load_impulse_response(const std::filesystem::path &wavPath, int sampleRate,
+                      ConvolutionReverb::Mode mode) {
+  const io::WavData wav = io::read_wav(io::read_all(wavPath));
+  std::vector<float> left = resample(wav.channel(0), wav.sampleRate,
+                                     sampleRate);
+  std::vector<float> right =
+      wav.channels > 1 ? resample(wav.channel(1), wav.sampleRate, sampleRate)
+                       : std::vector<float>{};
+  if (left.empty())
+    throw std::runtime_error("Impulse response is empty: " +
+                             wavPath.string());
+
+  // Unit energy per side keeps the wet level comparable across IRs.
+  const double e = right.empty() ? energy(left)
+                                 : 0.5 * (energy(left) + energy(right));
+  if (e > 0.0) {
+    const float g = static_cast<float>(1.0 / std::sqrt(e));
+    for (float &v : left)
+      v *= g;
+    for (float &v : right)
+      v *= g;
+  }
+  return std::make_unique<ConvolutionReverb>(left, right, mode);
+}
+
+} // namespace audio
@@ -0,0 +1,131 @@
+// src/audio/convolver.hpp
+// Partitioned FFT convolution reverb for long measured impulse responses
+// (5-8 s IRs are ~300k taps per channel; direct convolution is out of reach).
+//
+//   auto conv = audio::load_impulse_response("hall.wav", 44100);
+//   conv->process(in, out, frames, wet);   // out += (in * IR) * wet
+//
+// Design notes:
+// - UniformConvolver is the building block: overlap-save with block size B
+//   and FFT size 2B (audio/fft.hpp), the IR cut into B-sized partitions and a
+//   frequency-domain delay line of past input spectra. Per block it does one
+//   forward FFT, one inverse FFT and (partitions x B) complex multiply-adds,
+//   four bins per vector.
+// - Realtime mode is non-uniform, two tiers. The head (first 2L - B taps) runs
+//   inline with small blocks (B = kHeadBlock); the tail runs with large blocks
+//   (L = kTailBlock) on a background thread. A tail block handed off at the
+//   end of period p is only needed at the start of period p + 2, so the
+//   worker gets a full period to finish it. If it is late anyway the audio
+//   thread never waits: that tail block is dropped and late_blocks() counts it.
+// - Offline mode uses one uniform convolver with very large blocks
+//   (kOfflineBlock) computed inline: fewer FFTs per sample, best throughput,
+//   but a latency of kOfflineBlock frames that the caller compensates for.
+// - Latency (latency_frames()) is one head block in realtime mode; for a
+//   reverb return that is just a few ms of extra pre-delay.
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "audio/fft.hpp"
+
+namespace audio {
+
+// Mono, fixed-block overlap-save convolution with a uniformly partitioned IR.
+class UniformConvolver {
+public:
+  UniformConvolver(const float *ir, std::size_t irLen, int block);
+
+  [[nodiscard]] int block() const { return block_; }
+  [[nodiscard]] int partitions() const { return parts_; }
+
+  // Consume block() input samples and write the block() output samples for
+  // the same time span (no latency beyond collecting the block).
+  void process_block(const float *in, float *out);
+
+private:
+  int block_;
+  int parts_;
+  RealFft fft_;
+  std::vector<float> irRe_, irIm_;   // parts_ x block_ packed spectra
+  std::vector<float> fdlRe_, fdlIm_; // ring of past input spectra
+  int fdlHead_ = 0;
+  std::vector<float> frame_; // previous + current input block (2B)
+  std::vector<float> accRe_, accIm_, time_;
+};
+
+class ConvolutionReverb {
+public:
+  enum class Mode { Realtime, Offline };
+
+  static constexpr int kHeadBlock = 256;
+  static constexpr int kTailBlock = 4096;
+  static constexpr int kOfflineBlock = 8192;
+
+  // irRight may be empty (mono IR used for both sides).
+  ConvolutionReverb(const std::vector<float> &irLeft,
+                    const std::vector<float> &irRight,
+                    Mode mode = Mode::Realtime);
+  ~ConvolutionReverb();
+
+  ConvolutionReverb(const ConvolutionReverb &) = delete;
+  ConvolutionReverb &operator=(const ConvolutionReverb &) = delete;
+
+  // out += convolve(in) * wet, interleaved stereo, any frame count.
+  void process(const float *in, float *out, int frames, float wet);
+
+  [[nodiscard]] int latency_frames() const { return headBlock_; }
+  [[nodiscard]] std::size_t ir_frames() const { return irFrames_; }
+  // Tail blocks the background thread did not finish in time.
+  [[nodiscard]] std::uint64_t late_blocks() const {
+    return late_.load(std::memory_order_relaxed);
+  }
+
+private:
+  enum SlotState : int { Idle, Queued, Done };
+  struct TailSlot {
+    std::vector<float> in[2], out[2];
+    std::int64_t block = -1;
+    std::atomic<int> state{Idle};
+  };
+
+  void begin_tail_period();
+  void end_tail_period();
+  void worker();
+
+  int headBlock_;
+  std::size_t irFrames_;
+  std::vector<UniformConvolver> head_; // one per side
+  std::vector<float> headIn_[2], headOut_[2];
+  int headPos_ = 0;
+
+  // Realtime tail (empty when the IR fits in the head).
+  std::vector<UniformConvolver> tail_;
+  TailSlot slots_[2];
+  int tailPos_ = 0;
+  std::int64_t period_ = 0; // index of the tail block being filled
+  bool filling_ = false;    // this period's input is being captured
+  const TailSlot *reading_ = nullptr;
+  std::atomic<std::uint64_t> late_{0};
+
+  std::thread thread_;
+  std::mutex m_;
+  std::condition_variable cv_;
+  bool quit_ = false;
+};
+
+// Load a WAV impulse response (mono or stereo; extra channels ignored),
+// resample it to sampleRate and normalize it to unit energy per side.
+// Throws std::runtime_error on unreadable files.
+std::unique_ptr<ConvolutionReverb> load_impulse_response(
+    const std::filesystem::path &wavPath, int sampleRate,
+    ConvolutionReverb::Mode mode = ConvolutionReverb::Mode::Realtime);
+
+} // namespace audio
@@ -0,0 +1,227 @@
+// src/audio/driver.cpp
+// Output drivers for play(): the miniaudio device, a real-time null sink and
+// the simulated back-to-back driver. The miniaudio implementation itself is
+// compiled in player.cpp.
+
+#include "audio/driver.hpp"
+
+#include "miniaudio.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace audio {
+
+namespace {
+
+std::int64_t steady_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void sleep_sec(double sec) {
+  if (sec > 0.0)
+    std::this_thread::sleep_for(std::chrono::duration<double>(sec));
+}
+
+// Whole decimal number in [1, max]; throws with `spec` in the message.
+std::uint64_t spec_number(std::string_view s, std::string_view spec,
+                          std::uint64_t max = 0xFFFFFFFFull) {
+  std::uint64_t v = 0;
+  bool ok = !s.empty() && s.size() <= 19;
+  for (char c : s) {
+    ok = ok && c >= '0' && c <= '9';
+    v = v * 10 + std::uint64_t(c - '0');
+  }
+  if (!ok || v == 0 || v > max)
+    throw std::runtime_error("Bad driver spec: " + std::string(spec));
+  return v;
+}
+
+} // namespace
+
+// --- DeviceDriver ---------------------------------------------------------
+
+struct DeviceDriver::Impl {
+  ma_device device{};
+  bool open = false;
+  Callback cb = nullptr;
+  void *user = nullptr;
+  std::int64_t startNs = 0;
+
+  static void data_callback(ma_device *device, void *pOutput,
+                            const void * /*pInput*/, ma_uint32 frameCount) {
+    auto *self = reinterpret_cast<Impl *>(device->pUserData);
+    self->cb(self->user, reinterpret_cast<float *>(pOutput), frameCount);
+  }
+};
+
+DeviceDriver::DeviceDriver() : impl_(std::make_unique<Impl>()) {}
+
+DeviceDriver::~DeviceDriver() { stop(); }
+
+void DeviceDriver::start(int sampleRate, Callback cb, void *user) {
+  stop();
+  impl_->cb = cb;
+  impl_->user = user;
+  ma_device_config config = ma_device_config_init(ma_device_type_playback);
+  config.playback.format = ma_format_f32;
+  config.playback.channels = 2;
+  config.sampleRate = static_cast<ma_uint32>(sampleRate);
+  config.dataCallback = &Impl::data_callback;
+  config.pUserData = impl_.get();
+  if (ma_device_init(nullptr, &config, &impl_->device) != MA_SUCCESS) {
+    throw std::runtime_error("Failed to open playback device");
+  }
+  impl_->startNs = steady_ns();
+  if (ma_device_start(&impl_->device) != MA_SUCCESS) {
+    ma_device_uninit(&impl_->device);
+    throw std::runtime_error("Failed to start playback device");
+  }
+  impl_->open = true;
+}
+
+void DeviceDriver::stop() {
+  if (!impl_->open)
+    return;
+  ma_device_stop(&impl_->device);
+  ma_device_uninit(&impl_->device);
+  impl_->open = false;
+}
+
+void DeviceDriver::wait(double sec) { sleep_sec(sec); }
+
+double DeviceDriver::now_sec() const {
+  return double(steady_ns() - impl_->startNs) / 1e9;
+}
+
+double DeviceDriver::output_latency_sec() const {
+  if (!impl_->open)
+    return 0.0;
+  const auto &pb = impl_->device.playback;
+  return double(pb.internalPeriodSizeInFrames) * pb.internalPeriods /
+         pb.internalSampleRate;
+}
+
+// --- NullDriver -----------------------------------------------------------
+
+void NullDriver::start(int sampleRate, Callback cb, void *user) {
+  stop();
+  rate_ = sampleRate;
+  quit_.store(false);
+  startNs_ = steady_ns();
+  thread_ = std::thread([this, cb, user] { run(cb, user); });
+}
+
+void NullDriver::stop() {
+  quit_.store(true);
+  if (thread_.joinable())
+    thread_.join();
+}
+
+void NullDriver::wait(double sec) { sleep_sec(sec); }
+
+double NullDriver::now_sec() const {
+  return double(steady_ns() - startNs_) / 1e9;
+}
+
+// One period per period length of wall time. A late period is not made up
+// for (like an underrun on a device): the schedule restarts from now.
+void NullDriver::run(Callback cb, void *user) {
+  std::vector<float> buf(std::size_t(period_) * 2);
+  const auto period = std::chrono::nanoseconds(
+      std::int64_t(double(period_) / double(rate_) * 1e9));
+  auto next = std::chrono::steady_clock::now();
+  while (!quit_.load(std::memory_order_relaxed)) {
+    cb(user, buf.data(), period_);
+    next += period;
+    const auto now = std::chrono::steady_clock::now();
+    if (next < now)
+      next = now;
+    std::this_thread::sleep_until(next);
+  }
+}
+
+// --- SimulatedDriver ------------------------------------------------------
+
+SimulatedDriver::SimulatedDriver(const SimOptions &o)
+    : opts_(o), rng_(o.seed ? o.seed : 1) {
+  opts_.minFrames = std::max<std::uint32_t>(opts_.minFrames, 1);
+  opts_.maxFrames = std::max(opts_.maxFrames, opts_.minFrames);
+}
+
+void SimulatedDriver::start(int sampleRate, Callback cb, void *user) {
+  rate_ = sampleRate;
+  cb_ = cb;
+  user_ = user;
+  buf_.assign(std::size_t(opts_.maxFrames) * 2, 0.0f);
+  frames_ = 0;
+  periods_ = 0;
+}
+
+// xorshift64: the same seed gives the same periods on every platform.
+std::uint32_t SimulatedDriver::next_period() {
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 7;
+  rng_ ^= rng_ << 17;
+  const std::uint64_t span = opts_.maxFrames - opts_.minFrames + 1;
+  return opts_.minFrames + std::uint32_t(rng_ % span);
+}
+
+void SimulatedDriver::wait(double sec) {
+  if (!cb_)
+    return;
+  const std::uint64_t target =
+      frames_ + std::uint64_t(std::max(sec, 0.0) * rate_ + 0.5);
+  while (frames_ < target) {
+    const std::uint32_t n = next_period();
+    cb_(user_, buf_.data(), n);
+    frames_ += n;
+    ++periods_;
+  }
+}
+
+// --- Spec parsing ---------------------------------------------------------
+
+std::unique_ptr<Driver> make_driver(std::string_view spec) {
+  const std::size_t colon = spec.find(':');
+  const std::string_view kind = spec.substr(0, colon);
+  const std::string_view args =
+      colon == std::string_view::npos ? std::string_view{}
+                                      : spec.substr(colon + 1);
+  if (kind == "device" && colon == std::string_view::npos)
+    return std::make_unique<DeviceDriver>();
+  if (kind == "null") {
+    if (colon == std::string_view::npos)
+      return std::make_unique<NullDriver>();
+    return std::make_unique<NullDriver>(
+        std::uint32_t(spec_number(args, spec, 1 << 20)));
+  }
+  if (kind == "sim") {
+    SimOptions o;
+    if (colon != std::string_view::npos) {
+      const std::size_t seedColon = args.find(':');
+      const std::string_view range = args.substr(0, seedColon);
+      const std::size_t dash = range.find('-');
+      o.minFrames =
+          std::uint32_t(spec_number(range.substr(0, dash), spec, 1 << 20));
+      o.maxFrames = dash == std::string_view::npos
+                        ? o.minFrames
+                        : std::uint32_t(spec_number(range.substr(dash + 1),
+                                                    spec, 1 << 20));
+      if (o.maxFrames < o.minFrames)
+        throw std::runtime_error("Bad driver spec: " + std::string(spec));
+      if (seedColon != std::string_view::npos)
+        o.seed = spec_number(args.substr(seedColon + 1), spec, ~0ull);
+    }
+    return std::make_unique<SimulatedDriver>(o);
+  }
+  throw std::runtime_error("Unknown driver: " + std::string(spec) +
+                           " (expected device, null[:frames] or "
+                           "sim[:min[-max][:seed]])");
+}
+
+} // namespace audio
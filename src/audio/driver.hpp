@@ -0,0 +1,141 @@
+// src/audio/driver.hpp
+// Where play() sends its audio and whose clock it waits on.
+//
+//   audio::SimulatedDriver sim({64, 4096, 7}); // period sizes, seed
+//   opts.driver = &sim;                      // default: the playback device
+//   audio::play(song, tempo, sf2Path, opts); // returns as fast as it renders
+//
+//   auto d = audio::make_driver("sim:256-1024:3"); // from a --driver spec
+//
+// Three drivers:
+// - DeviceDriver: the miniaudio playback device (what play() always used).
+// - NullDriver: a thread that calls the callback in real time with fixed
+//   periods and discards the output: device timing without sound hardware.
+// - SimulatedDriver: no thread and no sleeping. wait() runs the callback
+//   back-to-back on the caller's thread until that much audio time has been
+//   rendered, with period sizes drawn from [minFrames, maxFrames] by a
+//   seeded generator, so a run is reproducible and takes only as long as
+//   the rendering. Uneven periods exercise the block splitting and event
+//   timing that a real device only hits by chance.
+//
+// Design notes:
+// - The callback is a plain function pointer + context and always gets
+//   interleaved stereo f32, like miniaudio's data callback.
+// - now_sec() is the driver's clock: wall time since start() for the real
+//   drivers, rendered audio time for the simulated one. play() uses it (and
+//   wait() instead of sleep_for) for its end-of-song checks and timeouts.
+// - Live MIDI input, hot reloads and streamed files arrive in wall-clock
+//   time, so they only make sense with the real-time drivers.
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace audio {
+
+class Driver {
+public:
+  // Fill `frames` interleaved stereo frames at `out`.
+  using Callback = void (*)(void *user, float *out, std::uint32_t frames);
+
+  virtual ~Driver() = default;
+
+  // Open the output at `sampleRate` and start calling `cb`. Throws
+  // std::runtime_error when the output cannot be opened.
+  virtual void start(int sampleRate, Callback cb, void *user) = 0;
+  // No callback runs after this returns. Safe to call twice.
+  virtual void stop() = 0;
+  // Let `sec` pass on this driver's clock.
+  virtual void wait(double sec) = 0;
+  // Seconds since start() on this driver's clock.
+  [[nodiscard]] virtual double now_sec() const = 0;
+  // Audio buffered after the callback (for live input timing).
+  [[nodiscard]] virtual double output_latency_sec() const { return 0.0; }
+};
+
+class DeviceDriver : public Driver {
+public:
+  DeviceDriver();
+  ~DeviceDriver() override;
+  DeviceDriver(const DeviceDriver &) = delete;
+  DeviceDriver &operator=(const DeviceDriver &) = delete;
+
+  void start(int sampleRate, Callback cb, void *user) override;
+  void stop() override;
+  void wait(double sec) override;
+  [[nodiscard]] double now_sec() const override;
+  [[nodiscard]] double output_latency_sec() const override;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+class NullDriver : public Driver {
+public:
+  explicit NullDriver(std::uint32_t periodFrames = 512)
+      : period_(periodFrames ? periodFrames : 1) {}
+  ~NullDriver() override { stop(); }
+  NullDriver(const NullDriver &) = delete;
+  NullDriver &operator=(const NullDriver &) = delete;
+
+  void start(int sampleRate, Callback cb, void *user) override;
+  void stop() override;
+  void wait(double sec) override;
+  [[nodiscard]] double now_sec() const override;
+  [[nodiscard]] double output_latency_sec() const override {
+    return double(period_) / double(rate_);
+  }
+
+private:
+  void run(Callback cb, void *user);
+
+  std::uint32_t period_;
+  int rate_ = 44100;
+  std::int64_t startNs_ = 0;
+  std::atomic<bool> quit_{false};
+  std::thread thread_;
+};
+
+struct SimOptions {
+  std::uint32_t minFrames = 64;  // period sizes, inclusive range
+  std::uint32_t maxFrames = 4096;
+  std::uint64_t seed = 1;
+};
+
+class SimulatedDriver : public Driver {
+public:
+  explicit SimulatedDriver(const SimOptions &o = {});
+
+  void start(int sampleRate, Callback cb, void *user) override;
+  void stop() override { cb_ = nullptr; }
+  void wait(double sec) override;
+  [[nodiscard]] double now_sec() const override {
+    return double(frames_) / double(rate_);
+  }
+
+  [[nodiscard]] std::uint64_t periods() const { return periods_; }
+  [[nodiscard]] std::uint64_t frames() const { return frames_; }
+
+private:
+  std::uint32_t next_period();
+
+  SimOptions opts_;
+  std::uint64_t rng_;
+  int rate_ = 44100;
+  Callback cb_ = nullptr;
+  void *user_ = nullptr;
+  std::vector<float> buf_; // maxFrames * 2
+  std::uint64_t frames_ = 0;
+  std::uint64_t periods_ = 0;
+};
+
+// "device", "null[:frames]" or "sim[:min[-max][:seed]]". Throws
+// std::runtime_error on anything else.
+std::unique_ptr<Driver> make_driver(std::string_view spec);
+
+} // namespace audio
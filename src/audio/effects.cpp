@@ -0,0 +1,210 @@
+// src/audio/effects.cpp
+// FDN reverb + modulated-delay chorus for the shared send buses.
+
+#include "audio/convolver.hpp"
+#include "audio/effects.hpp"
+#include "audio/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Mutually prime line lengths at 44.1 kHz (~23..64 ms), scaled to the rate.
+constexpr int kFdnLengths44k[8] = {1031, 1327, 1523, 1871,
+                                   2053, 2311, 2539, 2803};
+constexpr float kFdnInputGain = 0.25f;
+constexpr float kFdnOutputGain = 0.5f;
+
+constexpr float kChorusBaseMs = 12.0f;
+constexpr float kChorusDepthMs = 3.0f;
+constexpr float kChorusRatesHz[4] = {0.45f, 0.55f, 0.62f, 0.71f};
+
+} // namespace
+
+namespace audio {
+
+using simd::F32x4;
+
+FdnReverb::FdnReverb(int sampleRate, float rt60Sec, float damping)
+    : damping_(damping) {
+  for (int k = 0; k < kLines; ++k) {
+    const int len = std::max(
+        1, static_cast<int>(kFdnLengths44k[k] * (sampleRate / 44100.0)));
+    lines_[k].assign(std::size_t(len), 0.0f);
+    // -60 dB after rt60Sec: g^(sampleRate * rt60 / len) = 10^-3
+    gain_[k] = std::pow(10.0f, -3.0f * len / (rt60Sec * sampleRate));
+  }
+}
+
+void FdnReverb::process(const float *in, float *out, int frames, float wet) {
+  using namespace simd;
+  const F32x4 gA = load4(gain_), gB = load4(gain_ + 4);
+  const F32x4 damp = splat4(damping_);
+  const F32x4 householder = splat4(2.0f / kLines);
+  F32x4 lpA = load4(lowpass_), lpB = load4(lowpass_ + 4);
+  const float outGain = kFdnOutputGain * wet;
+
+  alignas(16) float x[kLines];
+  alignas(16) float inj[4];
+  alignas(16) float taps[4];
+  for (int i = 0; i < frames; ++i) {
+    for (int k = 0; k < kLines; ++k)
+      x[k] = lines_[k][pos_[k]];
+
+    // Damping: lp = x + d * (lp - x)
+    const F32x4 xA = load4(x), xB = load4(x + 4);
+    lpA = xA + damp * (lpA - xA);
+    lpB = xB + damp * (lpB - xB);
+
+    // Stereo taps: even lines -> left, odd lines -> right.
+    store4(taps, lpA + lpB);
+    out[2 * i] += (taps[0] + taps[2]) * outGain;
+    out[2 * i + 1] += (taps[1] + taps[3]) * outGain;
+
+    // Feedback through the Householder matrix (I - 2/N * 11^T), then inject
+    // the bus input (left into even lines, right into odd lines).
+    F32x4 yA = gA * lpA, yB = gB * lpB;
+    const F32x4 c = householder * splat4(hsum4(yA + yB));
+    inj[0] = inj[2] = in[2 * i] * kFdnInputGain;
+    inj[1] = inj[3] = in[2 * i + 1] * kFdnInputGain;
+    const F32x4 input = load4(inj);
+    store4(x, yA - c + input);
+    store4(x + 4, yB - c + input);
+
+    for (int k = 0; k < kLines; ++k) {
+      lines_[k][pos_[k]] = x[k];
+      if (++pos_[k] == static_cast<int>(lines_[k].size()))
+        pos_[k] = 0;
+    }
+  }
+  store4(lowpass_, lpA);
+  store4(lowpass_ + 4, lpB);
+}
+
+void FdnReverb::save_state(StateWriter &w) const {
+  for (int k = 0; k < kLines; ++k) {
+    w.put_array(lines_[k].data(), lines_[k].size());
+    w.put(pos_[k]);
+  }
+  w.put_raw(lowpass_, sizeof lowpass_);
+}
+
+void FdnReverb::load_state(StateReader &r) {
+  for (int k = 0; k < kLines; ++k) {
+    r.get_array(lines_[k].data(), lines_[k].size());
+    pos_[k] = r.get<int>();
+    if (pos_[k] < 0 || pos_[k] >= static_cast<int>(lines_[k].size()))
+      throw std::runtime_error("Checkpoint mismatch: reverb line position");
+  }
+  r.get_raw(lowpass_, sizeof lowpass_);
+}
+
+Chorus::Chorus(int sampleRate)
+    : baseDelay_(kChorusBaseMs * 1e-3f * sampleRate),
+      depth_(kChorusDepthMs * 1e-3f * sampleRate) {
+  std::size_t size = 2;
+  while (size < static_cast<std::size_t>(baseDelay_ + depth_) + 4)
+    size <<= 1;
+  delay_.assign(size, 0.0f);
+  for (int k = 0; k < 4; ++k) {
+    phase_[k] = 0.25f * k;
+    rate_[k] = kChorusRatesHz[k] / sampleRate;
+  }
+}
+
+void Chorus::process(const float *in, float *out, int frames, float wet) {
+  using namespace simd;
+  const int mask = static_cast<int>(delay_.size()) - 1;
+  const F32x4 base = splat4(baseDelay_), depth = splat4(depth_);
+  const F32x4 one = splat4(1.0f), two = splat4(2.0f);
+  const F32x4 rate = load4(rate_);
+  const float outGain = 0.5f * wet;
+
+  alignas(16) float d[4], s0[4], s1[4], fr[4];
+  for (int i = 0; i < frames; ++i) {
+    delay_[write_] = 0.5f * (in[2 * i] + in[2 * i + 1]);
+
+    // Triangle LFO in [0, 1] per tap -> delay in samples.
+    const F32x4 ph = load4(phase_);
+    store4(d, base + depth * abs4(two * ph - one));
+    for (int k = 0; k < 4; ++k) {
+      const float rp = static_cast<float>(write_) - d[k];
+      const float fl = std::floor(rp);
+      const int i0 = static_cast<int>(fl) & mask;
+      s0[k] = delay_[i0];
+      s1[k] = delay_[(i0 + 1) & mask];
+      fr[k] = rp - fl;
+    }
+    const F32x4 a = load4(s0);
+    store4(s0, a + (load4(s1) - a) * load4(fr));
+    out[2 * i] += (s0[0] + s0[2]) * outGain;
+    out[2 * i + 1] += (s0[1] + s0[3]) * outGain;
+
+    store4(phase_, ph + rate);
+    for (int k = 0; k < 4; ++k) {
+      if (phase_[k] >= 1.0f)
+        phase_[k] -= 1.0f;
+    }
+    write_ = (write_ + 1) & mask;
+  }
+}
+
+void Chorus::save_state(StateWriter &w) const {
+  w.put_array(delay_.data(), delay_.size());
+  w.put(write_);
+  w.put_raw(phase_, sizeof phase_);
+}
+
+void Chorus::load_state(StateReader &r) {
+  r.get_array(delay_.data(), delay_.size());
+  write_ = r.get<int>() & (static_cast<int>(delay_.size()) - 1);
+  r.get_raw(phase_, sizeof phase_);
+}
+
+SendEffects::SendEffects(int sampleRate)
+    : reverb_(sampleRate), chorus_(sampleRate),
+      reverbBus_(std::size_t(kMaxBusFrames) * 2, 0.0f),
+      chorusBus_(std::size_t(kMaxBusFrames) * 2, 0.0f) {}
+
+SendEffects::~SendEffects() = default;
+
+void SendEffects::set_convolution(std::unique_ptr<ConvolutionReverb> conv) {
+  conv_ = std::move(conv);
+}
+
+void SendEffects::save_state(StateWriter &w) const {
+  if (conv_)
+    throw std::runtime_error("Cannot checkpoint a convolution reverb");
+  w.put(reverbReturn_);
+  w.put(chorusReturn_);
+  reverb_.save_state(w);
+  chorus_.save_state(w);
+}
+
+void SendEffects::load_state(StateReader &r) {
+  reverbReturn_ = r.get<float>();
+  chorusReturn_ = r.get<float>();
+  reverb_.load_state(r);
+  chorus_.load_state(r);
+}
+
+void SendEffects::clear(int frames) {
+  simd::clear_stereo(reverbBus_.data(), std::size_t(frames));
+  simd::clear_stereo(chorusBus_.data(), std::size_t(frames));
+}
+
+void SendEffects::process(float *mix, int frames) {
+  if (conv_)
+    conv_->process(reverbBus_.data(), mix, frames, reverbReturn_);
+  else
+    reverb_.process(reverbBus_.data(), mix, frames, reverbReturn_);
+  process_chorus(mix, frames);
+}
+
+void SendEffects::process_chorus(float *mix, int frames) {
+  chorus_.process(chorusBus_.data(), mix, frames, chorusReturn_);
+}
+
+} // namespace audio
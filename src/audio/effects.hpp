@@ -0,0 +1,117 @@
+// src/audio/effects.hpp
+// Shared send-bus effects: one reverb and one chorus for the whole mix.
+//
+// Every channel adds its signal to the two bus buffers at its CC91/CC93 level
+// (see Synth::render); each bus then runs exactly one effect instance, so the
+// effect cost is constant no matter how many voices or channels are playing.
+//
+//   audio::SendEffects fx(44100);
+//   fx.clear(frames);                                  // zero both buses
+//   synth.render(dry, fx.reverb_bus(), fx.chorus_bus(), frames);
+//   fx.process(dry, frames);                           // dry += wet returns
+//
+// Design notes:
+// - Reverb: 8-line feedback delay network with a Householder feedback matrix
+//   and per-line one-pole damping. The eight lines are processed as two
+//   4-lane vectors (audio/simd.hpp), so a sample costs a handful of vector ops.
+// - Chorus: four modulated delay taps (two per side, staggered LFO phases),
+//   LFO and interpolation computed across the four taps in one vector.
+// - Buses are interleaved stereo float, sized for kMaxBusFrames frames;
+//   callers render in blocks of at most that size.
+// - The reverb bus can run a measured impulse response instead of the FDN
+//   (set_convolution, audio/convolver.hpp); the FDN is then bypassed.
+// - save_state/load_state copy the delay lines, LFO phases and filter state
+//   (common/snapshot.hpp), so a resumed render continues the reverb tail
+//   exactly. The convolution reverb is not checkpointed.
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common/snapshot.hpp"
+
+namespace audio {
+
+constexpr int kMaxBusFrames = 1024;
+
+class ConvolutionReverb;
+
+class FdnReverb {
+public:
+  explicit FdnReverb(int sampleRate, float rt60Sec = 2.2f,
+                     float damping = 0.35f);
+  // out += reverb(in) * wet, interleaved stereo.
+  void process(const float *in, float *out, int frames, float wet);
+
+  void save_state(StateWriter &w) const;
+  void load_state(StateReader &r);
+
+private:
+  static constexpr int kLines = 8;
+  std::vector<float> lines_[kLines];
+  int pos_[kLines] = {};
+  alignas(16) float gain_[kLines];         // per-line feedback (RT60)
+  alignas(16) float lowpass_[kLines] = {}; // damping filter state
+  float damping_;
+};
+
+class Chorus {
+public:
+  explicit Chorus(int sampleRate);
+  // out += chorus(in) * wet, interleaved stereo.
+  void process(const float *in, float *out, int frames, float wet);
+
+  void save_state(StateWriter &w) const;
+  void load_state(StateReader &r);
+
+private:
+  std::vector<float> delay_;
+  int write_ = 0;
+  float baseDelay_; // samples
+  float depth_;     // samples
+  alignas(16) float phase_[4];
+  alignas(16) float rate_[4]; // phase increment per sample
+};
+
+class SendEffects {
+public:
+  explicit SendEffects(int sampleRate);
+  ~SendEffects();
+
+  float *reverb_bus() { return reverbBus_.data(); }
+  float *chorus_bus() { return chorusBus_.data(); }
+
+  // Zero the first `frames` frames of both buses (frames <= kMaxBusFrames).
+  void clear(int frames);
+  // Run both effects on the buses and add their returns to `mix`.
+  void process(float *mix, int frames);
+  // Chorus only; the caller runs the reverb bus itself (OfflineRender's
+  // latency-compensated convolution).
+  void process_chorus(float *mix, int frames);
+
+  // Wet return levels (linear) of the two buses.
+  void set_returns(float reverb, float chorus) {
+    reverbReturn_ = reverb;
+    chorusReturn_ = chorus;
+  }
+  [[nodiscard]] float reverb_return() const { return reverbReturn_; }
+
+  // Replace the FDN on the reverb bus with a convolution reverb. Call before
+  // the audio thread starts using this object.
+  void set_convolution(std::unique_ptr<ConvolutionReverb> conv);
+
+  // Effect state for a checkpoint; throws with a convolution reverb set.
+  void save_state(StateWriter &w) const;
+  void load_state(StateReader &r);
+
+private:
+  float reverbReturn_ = 0.5f;
+  float chorusReturn_ = 0.6f;
+  FdnReverb reverb_;
+  Chorus chorus_;
+  std::unique_ptr<ConvolutionReverb> conv_;
+  std::vector<float> reverbBus_, chorusBus_;
+};
+
+} // namespace audio
@@ -0,0 +1,136 @@
+// src/audio/event_stream.cpp
+// Delta/varint encoder and the forward-decoding cursor.
+
+#include "audio/event_stream.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr std::uint8_t kStatusBit = 0x80;
+constexpr std::uint8_t kPortPrefix = 0xF0; // never a valid event status
+
+std::uint64_t to_units(double tSec) {
+  return tSec <= 0.0 ? 0
+                     : static_cast<std::uint64_t>(std::llround(
+                           tSec * audio::EventStream::kUnitsPerSec));
+}
+
+void put_varint(std::pmr::vector<std::uint8_t> &out, std::uint64_t v) {
+  // LEB128: low 7 bits first, high bit set on all but the last byte.
+  while (v >= 0x80) {
+    out.push_back(static_cast<std::uint8_t>(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back(static_cast<std::uint8_t>(v));
+}
+
+} // namespace
+
+namespace audio {
+
+EventStream::EventStream(const Schedule &events,
+                         std::pmr::memory_resource *mr)
+    : bytes_(mr), syncs_(mr), count_(events.size()) {
+  bytes_.reserve(events.size() * 4);
+  syncs_.reserve(events.size() / kSyncEvery + 1);
+
+  std::uint64_t prev = 0;
+  std::uint8_t running = 0;
+  int port = 0;
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    const ScheduledEvent &e = events[i];
+    // The schedule is time-sorted; max() only guards against rounding.
+    const std::uint64_t t = std::max(prev, to_units(e.tSec));
+    if (i % kSyncEvery == 0) {
+      syncs_.push_back(Sync{bytes_.size(), prev, t});
+      running = 0; // force an explicit status and port at every sync point
+      port = 0;
+    }
+    put_varint(bytes_, t - prev);
+
+    if (e.port != port) {
+      bytes_.push_back(kPortPrefix);
+      bytes_.push_back(e.port);
+      port = e.port;
+    }
+    const auto status = static_cast<std::uint8_t>(
+        kStatusBit | (static_cast<unsigned>(e.kind) << 4) | (e.ch & 0x0F));
+    if (status != running) {
+      bytes_.push_back(status);
+      running = status;
+    }
+    bytes_.push_back(e.data1 & 0x7F);
+    if (e.kind != EvKind::NoteOff)
+      bytes_.push_back(e.data2 & 0x7F);
+    prev = t;
+  }
+  last_ = prev;
+  bytes_.shrink_to_fit();
+}
+
+void EventStream::Cursor::read_delta() {
+  const std::uint8_t *p = s_->bytes_.data();
+  std::uint64_t v = 0;
+  int shift = 0;
+  std::uint8_t b;
+  do {
+    b = p[pos_++];
+    v |= std::uint64_t(b & 0x7F) << shift;
+    shift += 7;
+  } while (b & 0x80);
+  next_ += v;
+}
+
+void EventStream::Cursor::seek_sync(std::size_t sync) {
+  index_ = sync * kSyncEvery;
+  status_ = 0;
+  port_ = 0;
+  if (index_ >= s_->count_) {
+    pos_ = s_->bytes_.size();
+    next_ = s_->last_;
+    return;
+  }
+  const Sync &sp = s_->syncs_[sync];
+  pos_ = sp.offset;
+  next_ = sp.base;
+  read_delta();
+}
+
+ScheduledEvent EventStream::Cursor::next() {
+  const std::uint8_t *p = s_->bytes_.data();
+  if (p[pos_] == kPortPrefix) {
+    port_ = p[pos_ + 1];
+    pos_ += 2;
+  }
+  if (p[pos_] & kStatusBit)
+    status_ = p[pos_++];
+  ScheduledEvent e;
+  e.port = port_;
+  e.tSec = time();
+  e.ch = status_ & 0x0F;
+  e.kind = static_cast<EvKind>((status_ >> 4) & 0x07);
+  e.data1 = p[pos_++];
+  e.data2 = e.kind == EvKind::NoteOff ? 0 : p[pos_++];
+  if (++index_ < s_->count_)
+    read_delta();
+  return e;
+}
+
+void EventStream::Cursor::seek(double tSec) {
+  const std::uint64_t t = to_units(tSec);
+  // Last sync point strictly before `t` (events at exactly `t` may start
+  // before it), then decode forward.
+  const auto it = std::lower_bound(
+      s_->syncs_.begin(), s_->syncs_.end(), t,
+      [](const Sync &sp, std::uint64_t v) { return sp.time < v; });
+  const std::size_t sync =
+      it == s_->syncs_.begin() ? 0
+                               : std::size_t(it - s_->syncs_.begin()) - 1;
+  seek_sync(sync);
+  while (!done() && next_ < t)
+    next();
+}
+
+} // namespace audio
@@ -0,0 +1,106 @@
+// src/audio/event_stream.hpp
+// Compact, delta-encoded storage for a Schedule, for very long songs.
+//
+//   audio::EventStream stream(build_schedule(song, tempo));
+//   audio::EventStream::Cursor cur(stream);
+//   while (!cur.done() && cur.time() <= tEnd)   // in the audio callback
+//     synth.apply(cur.next());
+//   cur.seek(95.0);                              // via the sync points
+//
+// Encoding (close to SMF density, 3-5 bytes per event vs 16 per record):
+//   varint  delta time since the previous event, in units of 1/32768 s
+//   status  0x80 | kind << 4 | channel, omitted while it repeats (running
+//           status, as in SMF: data bytes are < 0x80)
+//   data1   note or controller number
+//   data2   velocity or controller value; omitted for NoteOff (the synth
+//           ignores release velocity, so it decodes as 0)
+// A port change (meta 0x21 songs) is a 0xF0 byte plus the port, sticky until
+// the next change, written before the event's status.
+//
+// Design notes:
+// - Times are rounded to whole units once, as absolute times; deltas are
+//   taken between rounded values, so decoding never drifts. One unit (~31 us)
+//   is under two samples at 44.1/48 kHz, finer than the callback's block
+//   dispatch, and deltas up to 0.5 s still fit in two varint bytes.
+// - Every kSyncEvery events the encoder writes an explicit status and port
+//   and records a sync point (byte offset, event index, absolute time).
+//   seek() binary searches the sync points, then decodes at most kSyncEvery
+//   events.
+// - Decoding is branch-light, allocation-free and only moves forward, so the
+//   cursor is safe to drive from the real-time callback.
+// - Buffers are std::pmr like Schedule, so batch tools can use an arena.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "audio/schedule.hpp"
+
+namespace audio {
+
+class EventStream {
+public:
+  static constexpr std::size_t kSyncEvery = 256;
+  static constexpr double kUnitsPerSec = 32768.0;
+
+  EventStream() = default;
+  // Empty, with its buffers to come from `mr` (so swaps with streams built
+  // on the same resource never reallocate).
+  explicit EventStream(std::pmr::memory_resource *mr)
+      : bytes_(mr), syncs_(mr) {}
+  explicit EventStream(
+      const Schedule &events,
+      std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+  [[nodiscard]] std::size_t size() const { return count_; }
+  [[nodiscard]] bool empty() const { return count_ == 0; }
+  // Time of the last event in seconds (0 when empty).
+  [[nodiscard]] double end_time() const { return double(last_) / kUnitsPerSec; }
+  // Encoded bytes plus the sync table.
+  [[nodiscard]] std::size_t memory_bytes() const {
+    return bytes_.capacity() + syncs_.capacity() * sizeof(Sync);
+  }
+
+  class Cursor {
+  public:
+    Cursor() = default;
+    explicit Cursor(const EventStream &s) : s_(&s) { seek_sync(0); }
+
+    [[nodiscard]] bool done() const { return index_ >= s_->count_; }
+    // Time of the next event in seconds; only valid while !done().
+    [[nodiscard]] double time() const { return double(next_) / kUnitsPerSec; }
+    // Index of the next event in the original schedule order.
+    [[nodiscard]] std::size_t index() const { return index_; }
+
+    // Decode the next event and advance; only valid while !done().
+    ScheduledEvent next();
+    // Position at the first event with time >= tSec.
+    void seek(double tSec);
+
+  private:
+    void seek_sync(std::size_t sync);
+    void read_delta();
+
+    const EventStream *s_ = nullptr;
+    std::size_t pos_ = 0;   // byte offset just after the next event's delta
+    std::size_t index_ = 0; // index of the next event
+    std::uint64_t next_ = 0;  // absolute time of the next event, in units
+    std::uint8_t status_ = 0; // running status
+    std::uint8_t port_ = 0;
+  };
+
+private:
+  struct Sync {
+    std::size_t offset; // byte offset of the event's delta varint
+    std::uint64_t base; // absolute time the delta is relative to
+    std::uint64_t time; // the event's own absolute time
+  };
+
+  std::pmr::vector<std::uint8_t> bytes_;
+  std::pmr::vector<Sync> syncs_; // syncs_[k] is event k * kSyncEvery
+  std::size_t count_ = 0;
+  std::uint64_t last_ = 0;
+};
+
+} // namespace audio
@@ -0,0 +1,193 @@
+// src/audio/fft.cpp
+// Radix-4/2 complex FFT and the real-input split/merge passes around it.
+
+#include "audio/fft.hpp"
+#include "audio/simd.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+int log2_exact(int n) {
+  int k = 0;
+  while ((1 << k) < n)
+    ++k;
+  return k;
+}
+
+} // namespace
+
+namespace audio {
+
+RealFft::RealFft(int n) : n_(n), half_(n / 2) {
+  if (n < 16 || (n & (n - 1)) != 0)
+    throw std::invalid_argument("FFT size must be a power of two >= 16");
+
+  const int bits = log2_exact(half_);
+  radix2First_ = (bits % 2) != 0;
+
+  bitrev_.resize(std::size_t(half_));
+  for (int i = 0; i < half_; ++i) {
+    int r = 0;
+    for (int b = 0; b < bits; ++b)
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    bitrev_[std::size_t(i)] = r;
+  }
+
+  // Radix-4 stage combining four length-m DFTs needs W^k, W^2k, W^3k for
+  // k < m, with W = e^{-2 pi i / 4m}. Stored stage by stage, re then im.
+  for (int m = radix2First_ ? 2 : 1; m < half_; m *= 4) {
+    for (int q = 1; q <= 3; ++q) {
+      for (int k = 0; k < m; ++k)
+        stageTw_.push_back(float(std::cos(kTwoPi * q * k / (4.0 * m))));
+      for (int k = 0; k < m; ++k)
+        stageTw_.push_back(float(-std::sin(kTwoPi * q * k / (4.0 * m))));
+    }
+  }
+
+  splitRe_.resize(std::size_t(half_));
+  splitIm_.resize(std::size_t(half_));
+  for (int k = 0; k < half_; ++k) {
+    splitRe_[std::size_t(k)] = float(std::cos(kTwoPi * k / n));
+    splitIm_[std::size_t(k)] = float(-std::sin(kTwoPi * k / n));
+  }
+
+  workRe_.resize(std::size_t(half_));
+  workIm_.resize(std::size_t(half_));
+}
+
+void RealFft::butterflies(float *re, float *im) const {
+  const int n = half_;
+  int m = 1;
+  if (radix2First_) {
+    for (int i = 0; i < n; i += 2) {
+      const float ar = re[i], ai = im[i], br = re[i + 1], bi = im[i + 1];
+      re[i] = ar + br;
+      im[i] = ai + bi;
+      re[i + 1] = ar - br;
+      im[i + 1] = ai - bi;
+    }
+    m = 2;
+  }
+
+  // With bit-reversed input, the four length-m blocks of each group hold the
+  // sub-DFTs of residues 0, 2, 1, 3 (mod 4) in that order.
+  const float *tw = stageTw_.data();
+  for (; m < n; m *= 4) {
+    const float *w1r = tw, *w1i = tw + m, *w2r = tw + 2 * m,
+                *w2i = tw + 3 * m, *w3r = tw + 4 * m, *w3i = tw + 5 * m;
+    tw += 6 * m;
+    for (int base = 0; base < n; base += 4 * m) {
+      float *r0 = re + base, *r1 = r0 + m, *r2 = r1 + m, *r3 = r2 + m;
+      float *i0 = im + base, *i1 = i0 + m, *i2 = i1 + m, *i3 = i2 + m;
+      int k = 0;
+      if (m >= 4) {
+        using namespace simd;
+        for (; k < m; k += 4) {
+          const F32x4 ar = load4(r0 + k), ai = load4(i0 + k);
+          const F32x4 br = load4(r1 + k), bi = load4(i1 + k);
+          const F32x4 cr = load4(r2 + k), ci = load4(i2 + k);
+          const F32x4 dr = load4(r3 + k), di = load4(i3 + k);
+          const F32x4 x1r = load4(w1r + k), x1i = load4(w1i + k);
+          const F32x4 x2r = load4(w2r + k), x2i = load4(w2i + k);
+          const F32x4 x3r = load4(w3r + k), x3i = load4(w3i + k);
+          const F32x4 t1r = cr * x1r - ci * x1i, t1i = cr * x1i + ci * x1r;
+          const F32x4 t2r = br * x2r - bi * x2i, t2i = br * x2i + bi * x2r;
+          const F32x4 t3r = dr * x3r - di * x3i, t3i = dr * x3i + di * x3r;
+          const F32x4 a0r = ar + t2r, a0i = ai + t2i;
+          const F32x4 a1r = ar - t2r, a1i = ai - t2i;
+          const F32x4 b0r = t1r + t3r, b0i = t1i + t3i;
+          const F32x4 b1r = t1r - t3r, b1i = t1i - t3i;
+          store4(r0 + k, a0r + b0r);
+          store4(i0 + k, a0i + b0i);
+          store4(r1 + k, a1r + b1i); // a1 - i*b1
+          store4(i1 + k, a1i - b1r);
+          store4(r2 + k, a0r - b0r);
+          store4(i2 + k, a0i - b0i);
+          store4(r3 + k, a1r - b1i); // a1 + i*b1
+          store4(i3 + k, a1i + b1r);
+        }
+      }
+      for (; k < m; ++k) {
+        const float ar = r0[k], ai = i0[k];
+        const float t1r = r2[k] * w1r[k] - i2[k] * w1i[k];
+        const float t1i = r2[k] * w1i[k] + i2[k] * w1r[k];
+        const float t2r = r1[k] * w2r[k] - i1[k] * w2i[k];
+        const float t2i = r1[k] * w2i[k] + i1[k] * w2r[k];
+        const float t3r = r3[k] * w3r[k] - i3[k] * w3i[k];
+        const float t3i = r3[k] * w3i[k] + i3[k] * w3r[k];
+        const float a0r = ar + t2r, a0i = ai + t2i;
+        const float a1r = ar - t2r, a1i = ai - t2i;
+        const float b0r = t1r + t3r, b0i = t1i + t3i;
+        const float b1r = t1r - t3r, b1i = t1i - t3i;
+        r0[k] = a0r + b0r;
+        i0[k] = a0i + b0i;
+        r1[k] = a1r + b1i;
+        i1[k] = a1i - b1r;
+        r2[k] = a0r - b0r;
+        i2[k] = a0i - b0i;
+        r3[k] = a1r - b1i;
+        i3[k] = a1i + b1r;
+      }
+    }
+  }
+}
+
+void RealFft::forward(const float *time, float *re, float *im) {
+  const int h = half_;
+  float *zr = workRe_.data(), *zi = workIm_.data();
+  for (int j = 0; j < h; ++j) {
+    const int r = bitrev_[std::size_t(j)];
+    zr[r] = time[2 * j];
+    zi[r] = time[2 * j + 1];
+  }
+  butterflies(zr, zi);
+
+  // X[k] = E[k] + w^k O[k], with E/O the spectra of even/odd samples:
+  //   E = (Z[k] + conj Z[h-k]) / 2,  O = (Z[k] - conj Z[h-k]) / 2i.
+  re[0] = zr[0] + zi[0]; // DC
+  im[0] = zr[0] - zi[0]; // Nyquist
+  for (int k = 1; k < h; ++k) {
+    const float ar = zr[k], ai = zi[k], br = zr[h - k], bi = zi[h - k];
+    const float er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+    const float or_ = 0.5f * (ai + bi), oi = -0.5f * (ar - br);
+    const float wr = splitRe_[std::size_t(k)], wi = splitIm_[std::size_t(k)];
+    re[k] = er + (wr * or_ - wi * oi);
+    im[k] = ei + (wr * oi + wi * or_);
+  }
+}
+
+void RealFft::inverse(const float *re, const float *im, float *time) {
+  const int h = half_;
+  float *zr = workRe_.data(), *zi = workIm_.data();
+
+  // Rebuild Z[k] = E[k] + i O[k] (times 2) and write it bit-reversed with
+  // re/im swapped: a forward FFT of the swapped input is the inverse FFT.
+  {
+    const float e = re[0] + im[0], o = re[0] - im[0];
+    zr[0] = o; // swapped: imag part first
+    zi[0] = e;
+  }
+  for (int k = 1; k < h; ++k) {
+    const float ar = re[k], ai = im[k], br = re[h - k], bi = -im[h - k];
+    const float er = ar + br, ei = ai + bi;
+    const float dr = ar - br, di = ai - bi;
+    // O = D * conj(w^k)
+    const float wr = splitRe_[std::size_t(k)], wi = -splitIm_[std::size_t(k)];
+    const float or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+    const int r = bitrev_[std::size_t(k)];
+    zr[r] = ei + or_; // Im(E + iO)
+    zi[r] = er - oi;  // Re(E + iO)
+  }
+  butterflies(zr, zi);
+
+  for (int j = 0; j < h; ++j) {
+    time[2 * j] = zi[j];
+    time[2 * j + 1] = zr[j];
+  }
+}
+
+} // namespace audio
@@ -0,0 +1,51 @@
+// src/audio/fft.hpp
+// Small real-input FFT for the convolution engine (no external dependency).
+//
+//   audio::RealFft fft(512);                 // power of two, >= 16
+//   fft.forward(time, re, im);               // 512 samples -> 256 bins
+//   fft.inverse(re, im, time);               // unscaled: result is 512 * x
+//
+// Design notes:
+// - A real FFT of size N runs as one complex FFT of size N/2 (even samples in
+//   the real part, odd samples in the imaginary part) plus a split pass.
+// - The complex FFT is iterative decimation-in-time: radix-4 stages, with one
+//   leading radix-2 stage when log2(N/2) is odd. Input is written in
+//   bit-reversed order while packing, so there is no separate permute pass.
+//   Each radix-4 stage has its own contiguous twiddle table, so the butterfly
+//   loop runs four butterflies per vector (audio/simd.hpp).
+// - Spectra use a packed split layout: re[0..N/2), im[0..N/2), where bin 0 is
+//   DC (real) and im[0] carries the Nyquist bin (also real). Split arrays
+//   keep spectral multiply-accumulate loops simple to vectorize.
+// - Not thread-safe: forward/inverse use an internal scratch buffer.
+
+#pragma once
+#include <vector>
+
+namespace audio {
+
+class RealFft {
+public:
+  // Throws std::invalid_argument unless n is a power of two >= 16.
+  explicit RealFft(int n);
+
+  [[nodiscard]] int size() const { return n_; }
+  [[nodiscard]] int bins() const { return half_; } // packed bins (N/2)
+
+  // time[N] -> re[N/2], im[N/2] (packed, see above).
+  void forward(const float *time, float *re, float *im);
+  // Packed spectrum -> time[N], scaled by N (callers fold 1/N in elsewhere).
+  void inverse(const float *re, const float *im, float *time);
+
+private:
+  void butterflies(float *re, float *im) const; // in place, size N/2
+
+  int n_;
+  int half_;
+  bool radix2First_;
+  std::vector<int> bitrev_;              // N/2 entries
+  std::vector<float> stageTw_;           // per radix-4 stage: w1, w2, w3
+  std::vector<float> splitRe_, splitIm_; // e^{-2 pi i k / N}, k < N/2
+  std::vector<float> workRe_, workIm_;
+};
+
+} // namespace audio
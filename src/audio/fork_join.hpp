@@ -0,0 +1,102 @@
+// src/audio/fork_join.hpp
+// Fork-join helper for the audio callback: the calling thread and N workers
+// pull job indices off a shared counter until all jobs of one block are done.
+//
+//   ForkJoinPool pool(3);
+//   pool.run(count, [](void *ctx, int i) { ... }, ctx);  // blocks until done
+//
+// Design notes:
+// - run() waits until every worker has checked in, so no worker can still be
+//   touching the job list when the next block starts.
+// - Jobs are a plain function pointer + context: no allocation per block.
+// - Workers sleep on a condition variable between blocks; waking them costs
+//   one short lock, which is why callers only go parallel when a block's
+//   render cost is worth it.
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace audio {
+
+class ForkJoinPool {
+public:
+  using JobFn = void (*)(void *ctx, int index);
+
+  explicit ForkJoinPool(int workers) {
+    for (int i = 0; i < workers; ++i)
+      threads_.emplace_back([this] { worker(); });
+  }
+
+  ~ForkJoinPool() {
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      quit_ = true;
+    }
+    cv_.notify_all();
+    for (auto &t : threads_)
+      t.join();
+  }
+
+  ForkJoinPool(const ForkJoinPool &) = delete;
+  ForkJoinPool &operator=(const ForkJoinPool &) = delete;
+
+  [[nodiscard]] int size() const { return static_cast<int>(threads_.size()); }
+
+  // Run fn(ctx, 0..count-1) across the workers and the calling thread.
+  void run(int count, JobFn fn, void *ctx) {
+    fn_ = fn;
+    ctx_ = ctx;
+    count_ = count;
+    busy_.store(size(), std::memory_order_relaxed);
+    next_.store(0, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      ++generation_;
+    }
+    cv_.notify_all();
+    drain();
+    while (busy_.load(std::memory_order_acquire) != 0)
+      std::this_thread::yield();
+  }
+
+private:
+  void drain() {
+    int i;
+    while ((i = next_.fetch_add(1, std::memory_order_acq_rel)) < count_)
+      fn_(ctx_, i);
+  }
+
+  void worker() {
+    std::uint64_t seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [&] { return quit_ || generation_ != seen; });
+        if (quit_)
+          return;
+        seen = generation_;
+      }
+      drain();
+      busy_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex m_;
+  std::condition_variable cv_;
+  std::uint64_t generation_ = 0;
+  bool quit_ = false;
+
+  JobFn fn_ = nullptr;
+  void *ctx_ = nullptr;
+  int count_ = 0;
+  std::atomic<int> next_{0};
+  std::atomic<int> busy_{0};
+};
+
+} // namespace audio
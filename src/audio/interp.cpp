@@ -0,0 +1,100 @@
+// src/audio/interp.cpp
+// Mode names and the polyphase windowed-sinc tables.
+
+#include "audio/interp.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kPassband = 0.9; // cutoff as a fraction of source Nyquist
+
+// Zeroth-order modified Bessel function (series), for the Kaiser window.
+double bessel_i0(double x) {
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; k < 32; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+    if (term < 1e-12 * sum)
+      break;
+  }
+  return sum;
+}
+
+} // namespace
+
+namespace audio {
+
+const char *interp_name(Interp m) {
+  switch (m) {
+  case Interp::Linear:
+    return "linear";
+  case Interp::Cubic:
+    return "cubic";
+  case Interp::Sinc8:
+    return "sinc8";
+  case Interp::Sinc16:
+    return "sinc16";
+  }
+  return "?";
+}
+
+std::optional<Interp> parse_interp(std::string_view name) {
+  for (Interp m : kAllInterps) {
+    if (name == interp_name(m))
+      return m;
+  }
+  return std::nullopt;
+}
+
+SincTable::SincTable(int taps) : taps_(taps) {
+  const double beta = taps >= 16 ? 8.0 : 6.0; // window sidelobe trade-off
+  const double half = taps / 2.0;
+  const double i0beta = bessel_i0(beta);
+  w_.resize(std::size_t(kBands) * (kPhases + 1) * std::size_t(taps));
+
+  for (int b = 0; b < kBands; ++b) {
+    // Band b covers ratios up to 2^(b/3); cut off at Nyquist / that ratio.
+    const double cutoff = kPassband / std::pow(2.0, b / 3.0);
+    for (int p = 0; p <= kPhases; ++p) {
+      const double frac = double(p) / kPhases;
+      float *w = &w_[(std::size_t(b) * (kPhases + 1) + std::size_t(p)) *
+                     std::size_t(taps)];
+      double sum = 0.0;
+      for (int j = 0; j < taps; ++j) {
+        const double t = j - (half - 1.0) - frac; // distance from read point
+        const double x = kPi * cutoff * t;
+        const double sinc = std::abs(x) < 1e-9 ? 1.0 : std::sin(x) / x;
+        const double r = t / half;
+        const double win =
+            std::abs(r) >= 1.0
+                ? 0.0
+                : bessel_i0(beta * std::sqrt(1.0 - r * r)) / i0beta;
+        w[j] = static_cast<float>(sinc * win);
+        sum += w[j];
+      }
+      for (int j = 0; j < taps; ++j) // unity DC gain for every phase
+        w[j] = static_cast<float>(w[j] / sum);
+    }
+  }
+}
+
+const SincTable &SincTable::get(int taps) {
+  static const SincTable t8(8), t16(16);
+  if (taps == 8)
+    return t8;
+  if (taps == 16)
+    return t16;
+  throw std::invalid_argument("SincTable supports 8 or 16 taps");
+}
+
+int SincTable::band_for(double ratio) {
+  if (ratio <= 1.0)
+    return 0;
+  const int b = static_cast<int>(std::ceil(3.0 * std::log2(ratio) - 1e-9));
+  return b < kBands ? b : kBands - 1;
+}
+
+} // namespace audio
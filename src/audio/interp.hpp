@@ -0,0 +1,102 @@
+// src/audio/interp.hpp
+// Sample interpolation kernels for the voice renderer (audio/synth.cpp).
+//
+// Modes (taps = input samples read per output sample):
+//   Linear  2 taps   tsf's own two-point interpolation (cheapest, aliases)
+//   Cubic   4 taps   Catmull-Rom cubic Hermite
+//   Sinc8   8 taps   Kaiser-windowed sinc, polyphase table
+//   Sinc16 16 taps   same, steeper transition band
+//
+// Design notes:
+// - Kernels vectorize across taps (audio/simd.hpp): cubic evaluates its four
+//   weight polynomials in one vector; sinc does one multiply-add per four
+//   taps against a pre-computed weight row.
+// - SincTable has kPhases fractional positions (+1 guard row) and linearly
+//   interpolates between neighbouring rows. Each table holds kBands cutoffs
+//   (source Nyquist scaled by 1/ratio in third-octave steps up to ratio 2),
+//   so pitched-up voices are low-passed before they are decimated.
+// - Every kernel reads x[0 .. taps), where x points `before` samples ahead
+//   of the integer read position; callers handle loop wrap and buffer edges.
+// - Measured cost per mode: see measure_interp_cost() in audio/synth.hpp.
+
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "audio/simd.hpp"
+
+namespace audio {
+
+enum class Interp : std::uint8_t { Linear, Cubic, Sinc8, Sinc16 };
+
+constexpr Interp kAllInterps[] = {Interp::Linear, Interp::Cubic,
+                                  Interp::Sinc8, Interp::Sinc16};
+
+[[nodiscard]] const char *interp_name(Interp m);
+[[nodiscard]] std::optional<Interp> parse_interp(std::string_view name);
+
+constexpr int interp_taps(Interp m) {
+  return m == Interp::Linear ? 2 : m == Interp::Cubic ? 4
+                               : m == Interp::Sinc8   ? 8
+                                                      : 16;
+}
+// Taps read before the integer position.
+constexpr int interp_before(Interp m) { return interp_taps(m) / 2 - 1; }
+
+class SincTable {
+public:
+  static constexpr int kPhases = 256;
+  static constexpr int kBands = 4;
+
+  // Shared, lazily built table for 8 or 16 taps.
+  static const SincTable &get(int taps);
+
+  // Band for a playback ratio (source samples per output sample).
+  static int band_for(double ratio);
+
+  // Weights for phase p in [0, kPhases] of band b (taps() floats).
+  [[nodiscard]] const float *row(int band, int phase) const {
+    return w_.data() +
+           (std::size_t(band) * (kPhases + 1) + std::size_t(phase)) *
+               std::size_t(taps_);
+  }
+  [[nodiscard]] int taps() const { return taps_; }
+
+private:
+  explicit SincTable(int taps);
+
+  int taps_;
+  std::vector<float> w_; // [band][phase][tap]
+};
+
+// Catmull-Rom through x[0..3], evaluated at x[1] + t (t in [0, 1)).
+inline float interp_cubic(const float *x, float t) {
+  using namespace simd;
+  // Weight polynomials ((a t + b) t + c) t + d, one lane per tap.
+  alignas(16) static const float a[4] = {-0.5f, 1.5f, -1.5f, 0.5f};
+  alignas(16) static const float b[4] = {1.0f, -2.5f, 2.0f, -0.5f};
+  alignas(16) static const float c[4] = {-0.5f, 0.0f, 0.5f, 0.0f};
+  alignas(16) static const float d[4] = {0.0f, 1.0f, 0.0f, 0.0f};
+  const F32x4 tv = splat4(t);
+  const F32x4 w =
+      ((load4(a) * tv + load4(b)) * tv + load4(c)) * tv + load4(d);
+  return hsum4(w * load4(x));
+}
+
+// Windowed sinc through x[0..Taps), phase rows r0/r1 blended by f.
+template <int Taps>
+inline float interp_sinc(const float *x, const float *r0, const float *r1,
+                         float f) {
+  using namespace simd;
+  const F32x4 fv = splat4(f);
+  F32x4 acc = splat4(0.0f);
+  for (int k = 0; k < Taps; k += 4) {
+    const F32x4 w0 = load4(r0 + k);
+    acc = acc + load4(x + k) * (w0 + fv * (load4(r1 + k) - w0));
+  }
+  return hsum4(acc);
+}
+
+} // namespace audio
@@ -0,0 +1,168 @@
+// src/audio/job_scheduler.cpp
+// Ready queue, preemption check and workers of the render scheduler.
+
+#include "audio/job_scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace audio {
+
+namespace {
+
+constexpr int kClassShift = 56;
+constexpr std::uint64_t kDeadlineMask = (std::uint64_t(1) << kClassShift) - 1;
+
+// Heap order: the smallest key (then the oldest job) at the front.
+struct Later {
+  template <class P> bool operator()(const P &a, const P &b) const {
+    return a->key > b->key || (a->key == b->key && a->id > b->id);
+  }
+};
+
+} // namespace
+
+RenderScheduler::RenderScheduler(int workers, SchedPolicy policy)
+    : policy_(policy), epoch_(Clock::now()) {
+  for (int i = 0; i < std::max(1, workers); ++i)
+    threads_.emplace_back([this] { worker(); });
+}
+
+RenderScheduler::~RenderScheduler() {
+  wait_idle();
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    quit_ = true;
+  }
+  workCv_.notify_all();
+  for (auto &t : threads_)
+    t.join();
+}
+
+JobId RenderScheduler::submit(std::unique_ptr<OfflineRender> render,
+                              JobClass cls, double deadlineSec,
+                              BlockSink sink, void *ctx) {
+  auto job = std::make_unique<Job>();
+  job->render = std::move(render);
+  job->cls = cls;
+  job->sink = sink;
+  job->ctx = ctx;
+  job->submitted = Clock::now();
+  // Key: class in the top byte, then the deadline in microseconds since the
+  // scheduler started (saturating: no deadline sorts last in its class).
+  std::uint64_t due = kDeadlineMask;
+  if (std::isfinite(deadlineSec)) {
+    const auto d = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(std::max(0.0, deadlineSec)));
+    job->deadline = job->submitted + d;
+    const double us = std::chrono::duration<double, std::micro>(
+                          job->deadline - epoch_)
+                          .count();
+    due = std::min(std::uint64_t(us), kDeadlineMask);
+  } else {
+    job->deadline = Clock::time_point::max();
+  }
+  std::lock_guard<std::mutex> lk(m_);
+  job->id = nextId_++;
+  job->key = policy_ == SchedPolicy::Fifo
+                 ? job->id
+                 : std::uint64_t(cls) << kClassShift | due;
+  const JobId id = job->id;
+  push_ready(std::move(job));
+  workCv_.notify_one();
+  return id;
+}
+
+JobResult RenderScheduler::wait(JobId id) {
+  std::unique_lock<std::mutex> lk(m_);
+  doneCv_.wait(lk, [&] { return results_.count(id) != 0; });
+  JobResult r = std::move(results_[id]);
+  results_.erase(id);
+  return r;
+}
+
+void RenderScheduler::wait_idle() {
+  std::unique_lock<std::mutex> lk(m_);
+  doneCv_.wait(lk, [&] { return ready_.empty() && running_ == 0; });
+}
+
+void RenderScheduler::push_ready(std::unique_ptr<Job> job) {
+  ready_.push_back(std::move(job));
+  std::push_heap(ready_.begin(), ready_.end(), Later{});
+  publish_head();
+}
+
+std::unique_ptr<RenderScheduler::Job> RenderScheduler::pop_ready() {
+  std::pop_heap(ready_.begin(), ready_.end(), Later{});
+  std::unique_ptr<Job> job = std::move(ready_.back());
+  ready_.pop_back();
+  publish_head();
+  return job;
+}
+
+// Caller holds m_. Workers read this between blocks without the lock.
+void RenderScheduler::publish_head() {
+  headKey_.store(ready_.empty() ? ~std::uint64_t(0) : ready_.front()->key,
+                 std::memory_order_relaxed);
+}
+
+void RenderScheduler::finish(std::unique_ptr<Job> job) {
+  const Clock::time_point now = Clock::now();
+  JobResult r;
+  r.cls = job->cls;
+  r.waitSec = std::chrono::duration<double>(job->started - job->submitted)
+                  .count();
+  r.latencySec = std::chrono::duration<double>(now - job->submitted).count();
+  r.missed = now > job->deadline;
+  r.preemptions = job->preemptions;
+  r.blocks = job->blocks;
+  r.render = std::move(job->render);
+  std::lock_guard<std::mutex> lk(m_);
+  results_.emplace(job->id, std::move(r));
+  --running_;
+  doneCv_.notify_all();
+}
+
+void RenderScheduler::worker() {
+  for (;;) {
+    std::unique_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lk(m_);
+      workCv_.wait(lk, [&] { return quit_ || !ready_.empty(); });
+      if (ready_.empty())
+        return; // quit_
+      job = pop_ready();
+      ++running_;
+    }
+    while (job) {
+      if (!job->hasStarted) {
+        job->hasStarted = true;
+        job->started = Clock::now();
+      }
+      const int n = job->render->step();
+      if (n > 0) {
+        ++job->blocks;
+        if (job->sink)
+          job->sink(job->ctx, job->id, job->render->block(), n);
+      }
+      if (job->render->done()) {
+        finish(std::move(job));
+        break;
+      }
+      // Block boundary: yield to a more urgent job, if one is waiting.
+      if (headKey_.load(std::memory_order_relaxed) >= job->key)
+        continue;
+      std::lock_guard<std::mutex> lk(m_);
+      if (ready_.empty() || ready_.front()->key >= job->key)
+        continue; // another worker took it
+      ++job->preemptions;
+      preemptions_.fetch_add(1, std::memory_order_relaxed);
+      std::unique_ptr<Job> next = pop_ready();
+      push_ready(std::move(job));
+      job = std::move(next);
+    }
+  }
+}
+
+} // namespace audio
@@ -0,0 +1,119 @@
+// src/audio/job_scheduler.hpp
+// A worker pool for offline renders (audio/offline.hpp) that keeps
+// interactive previews fast while bulk catalog renders run.
+//
+//   audio::RenderScheduler sched(4);              // 4 workers, EDF
+//   auto id = sched.submit(std::make_unique<audio::OfflineRender>(
+//                              font, schedule, 44100, 1.0, 2.0),
+//                          audio::JobClass::Interactive, 1.0);  // due in 1 s
+//   audio::JobResult r = sched.wait(id);          // r.latencySec, r.missed
+//
+// Design notes:
+// - Jobs are ordered by class first (Interactive before Bulk), then by
+//   deadline (earliest first), then by submission. Policy Fifo ignores both
+//   and runs jobs in submission order, for comparison.
+// - Workers render one block per turn. After each block they check one
+//   relaxed atomic, the key of the most urgent waiting job; if it beats the
+//   job in hand, the job goes back to the ready queue and the worker takes
+//   the other one. A parked job keeps its synth state and resumes from the
+//   next block, so preemption costs a lock and a heap push, never a
+//   re-render, and bulk throughput only loses what previews actually use.
+// - A preview therefore waits at most one block (<= kMaxBusFrames frames)
+//   for a worker, however many bulk jobs are queued or running.
+// - Blocks can be streamed out as they are rendered: the sink runs on the
+//   worker thread, once per block, in order for each job.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "audio/offline.hpp"
+
+namespace audio {
+
+enum class JobClass : std::uint8_t { Interactive, Bulk };
+enum class SchedPolicy : std::uint8_t { Fifo, Edf };
+
+using JobId = std::uint64_t;
+
+struct JobResult {
+  std::unique_ptr<OfflineRender> render; // finished
+  JobClass cls = JobClass::Bulk;
+  double waitSec = 0.0;    // submit -> first block started
+  double latencySec = 0.0; // submit -> last block rendered
+  bool missed = false;     // finished after its deadline
+  int preemptions = 0;     // times parked for a more urgent job
+  std::size_t blocks = 0;
+};
+
+class RenderScheduler {
+public:
+  // Worker thread: one rendered block of job `id` (interleaved stereo).
+  using BlockSink = void (*)(void *ctx, JobId id, const float *pcm,
+                             int frames);
+
+  explicit RenderScheduler(int workers, SchedPolicy policy = SchedPolicy::Edf);
+  ~RenderScheduler(); // finishes every submitted job first
+
+  RenderScheduler(const RenderScheduler &) = delete;
+  RenderScheduler &operator=(const RenderScheduler &) = delete;
+
+  // Queue `job`, due `deadlineSec` from now (infinity: no deadline).
+  JobId submit(std::unique_ptr<OfflineRender> job, JobClass cls,
+               double deadlineSec, BlockSink sink = nullptr,
+               void *ctx = nullptr);
+
+  // Block until job `id` is finished and take its result (once per id).
+  JobResult wait(JobId id);
+  // Block until no job is queued or running.
+  void wait_idle();
+
+  [[nodiscard]] SchedPolicy policy() const { return policy_; }
+  [[nodiscard]] std::uint64_t preemptions() const {
+    return preemptions_.load(std::memory_order_relaxed);
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Job {
+    JobId id = 0;
+    std::uint64_t key = 0; // lower runs first
+    std::unique_ptr<OfflineRender> render;
+    JobClass cls = JobClass::Bulk;
+    BlockSink sink = nullptr;
+    void *ctx = nullptr;
+    Clock::time_point submitted, deadline, started;
+    bool hasStarted = false;
+    int preemptions = 0;
+    std::size_t blocks = 0;
+  };
+
+  void worker();
+  void push_ready(std::unique_ptr<Job> job);
+  std::unique_ptr<Job> pop_ready();
+  void publish_head();
+  void finish(std::unique_ptr<Job> job);
+
+  SchedPolicy policy_;
+  Clock::time_point epoch_;
+  std::mutex m_;
+  std::condition_variable workCv_, doneCv_;
+  std::vector<std::unique_ptr<Job>> ready_; // heap, most urgent at front
+  std::unordered_map<JobId, JobResult> results_;
+  std::atomic<std::uint64_t> headKey_{~std::uint64_t(0)};
+  std::atomic<std::uint64_t> preemptions_{0};
+  JobId nextId_ = 1;
+  int running_ = 0;
+  bool quit_ = false;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace audio
@@ -0,0 +1,226 @@
+// src/audio/mipmap.cpp
+// Decimation filter, pyramid build and the on-disk cache.
+
+#include "audio/mipmap.hpp"
+#include "audio/simd.hpp"
+#include "common/hash.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x5350494D; // "MIPS"
+constexpr std::uint32_t kVersion = 1;        // bump when the filter changes
+constexpr int kHalf = 23;                    // taps each side of the centre
+constexpr int kTaps = 2 * kHalf + 1;         // 47
+constexpr int kTapsPadded = 48;              // multiple of the vector width
+constexpr double kCutoff = 0.45; // of the input Nyquist = 0.9 x output's
+
+struct Header {
+  std::uint32_t magic, version;
+  std::uint64_t key, count;
+};
+
+// Size of a cache file for `count` level-0 samples: header plus levels
+// 1..kLevels-1 without their guards.
+std::uintmax_t cache_bytes(std::size_t count) {
+  std::uintmax_t bytes = sizeof(Header);
+  for (int k = 1; k < audio::SamplePyramid::kLevels; ++k) {
+    count = (count + 1) / 2;
+    bytes += count * sizeof(float);
+  }
+  return bytes;
+}
+
+// Kaiser-windowed sinc low-pass, unity DC gain, zero-padded to 48 taps.
+const float *decimation_filter() {
+  static const auto taps = [] {
+    std::vector<float> w(kTapsPadded, 0.0f);
+    const double pi = 3.14159265358979323846, beta = 8.0;
+    auto i0 = [](double x) {
+      double sum = 1.0, term = 1.0;
+      for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+      }
+      return sum;
+    };
+    double sum = 0.0;
+    for (int j = 0; j < kTaps; ++j) {
+      const double t = j - kHalf;
+      const double x = pi * kCutoff * t;
+      const double sinc = t == 0 ? 1.0 : std::sin(x) / x;
+      const double r = t / (kHalf + 1);
+      w[std::size_t(j)] = static_cast<float>(
+          sinc * i0(beta * std::sqrt(1.0 - r * r)) / i0(beta));
+      sum += w[std::size_t(j)];
+    }
+    for (int j = 0; j < kTaps; ++j)
+      w[std::size_t(j)] = static_cast<float>(w[std::size_t(j)] / sum);
+    return w;
+  }();
+  return taps.data();
+}
+
+// Low-pass and keep every other sample; output has a zero guard appended.
+std::vector<float> decimate(const float *x, std::size_t n) {
+  using namespace audio::simd;
+  const float *w = decimation_filter();
+  const std::size_t m = (n + 1) / 2;
+  std::vector<float> y(m + audio::SamplePyramid::kGuard, 0.0f);
+  for (std::size_t i = 0; i < m; ++i) {
+    const std::size_t c = 2 * i;
+    if (c >= std::size_t(kHalf) && c + kTapsPadded - kHalf <= n) {
+      const float *src = x + (c - kHalf);
+      F32x4 acc = splat4(0.0f);
+      for (int j = 0; j < kTapsPadded; j += 4)
+        acc = acc + load4(src + j) * load4(w + j);
+      y[i] = hsum4(acc);
+    } else {
+      float acc = 0.0f; // edges: zeros outside the pool
+      for (int j = 0; j < kTaps; ++j) {
+        const long idx = long(c) - kHalf + j;
+        if (idx >= 0 && std::size_t(idx) < n)
+          acc += x[idx] * w[j];
+      }
+      y[i] = acc;
+    }
+  }
+  return y;
+}
+
+std::filesystem::path cache_dir() {
+  if (const char *d = std::getenv("MIDI_PLAYER_CACHE"); d && *d)
+    return d;
+  if (const char *d = std::getenv("XDG_CACHE_HOME"); d && *d)
+    return std::filesystem::path(d) / "midi_player";
+  if (const char *d = std::getenv("HOME"); d && *d)
+    return std::filesystem::path(d) / ".cache" / "midi_player";
+  return {};
+}
+
+} // namespace
+
+namespace audio {
+
+SamplePyramid::SamplePyramid(const float *pool, std::size_t count,
+                             std::nullptr_t)
+    : base_(pool), count_(count) {}
+
+SamplePyramid::SamplePyramid(const float *pool, std::size_t count)
+    : SamplePyramid(pool, count, nullptr) {
+  const float *prev = pool;
+  std::size_t prevCount = count;
+  for (int k = 1; k < kLevels; ++k) {
+    levels_.push_back(decimate(prev, prevCount));
+    prev = levels_.back().data();
+    prevCount = levels_.back().size() - kGuard;
+  }
+  charge_levels();
+}
+
+void SamplePyramid::charge_levels() {
+  std::size_t bytes = 0;
+  for (const auto &lv : levels_)
+    bytes += lv.capacity() * sizeof(float);
+  mem_.set(bytes);
+}
+
+std::shared_ptr<const SamplePyramid>
+SamplePyramid::load_or_build(const float *pool, std::size_t count,
+                             const std::filesystem::path &sf2Path) {
+  std::error_code ec;
+  const std::filesystem::path dir = cache_dir();
+  const std::string canon = std::filesystem::weakly_canonical(sf2Path, ec)
+                                .string();
+  const std::uint64_t fileSize = std::filesystem::file_size(sf2Path, ec);
+  const auto mtime = static_cast<std::int64_t>(
+      std::filesystem::last_write_time(sf2Path, ec)
+          .time_since_epoch()
+          .count());
+  std::uint64_t key = kFnv1aSeed;
+  key = fnv1a(canon.data(), canon.size(), key);
+  key = fnv1a(&fileSize, sizeof fileSize, key);
+  key = fnv1a(&mtime, sizeof mtime, key);
+  key = fnv1a(&count, sizeof count, key);
+  key = fnv1a(&kVersion, sizeof kVersion, key);
+
+  std::filesystem::path file;
+  if (!dir.empty()) {
+    char hex[17];
+    std::snprintf(hex, sizeof hex, "%016llx", (unsigned long long)key);
+    file = dir / (sf2Path.stem().string() + "-" + hex + ".mip");
+    std::shared_ptr<SamplePyramid> cached(
+        new SamplePyramid(pool, count, nullptr));
+    if (cached->read_cache(file, key))
+      return cached;
+  }
+
+  auto built = std::make_shared<SamplePyramid>(pool, count);
+  if (!file.empty()) {
+    std::filesystem::create_directories(dir, ec);
+    built->write_cache(file, key);
+  }
+  return built;
+}
+
+bool SamplePyramid::read_cache(const std::filesystem::path &file,
+                               std::uint64_t key) {
+  // A truncated or padded file (a crash mid-write, another build) is not
+  // trusted: its size must match the header's sample count exactly.
+  std::error_code ec;
+  const std::uintmax_t bytes = std::filesystem::file_size(file, ec);
+  if (ec || bytes != cache_bytes(count_))
+    return false;
+  std::ifstream in(file, std::ios::binary);
+  Header h{};
+  if (!in || !in.read(reinterpret_cast<char *>(&h), sizeof h) ||
+      h.magic != kMagic || h.version != kVersion || h.key != key ||
+      h.count != count_)
+    return false;
+
+  std::size_t n = count_;
+  for (int k = 1; k < kLevels; ++k) {
+    n = (n + 1) / 2;
+    std::vector<float> lv(n + kGuard, 0.0f);
+    if (!in.read(reinterpret_cast<char *>(lv.data()),
+                 std::streamsize(n * sizeof(float)))) {
+      levels_.clear();
+      return false;
+    }
+    levels_.push_back(std::move(lv));
+  }
+  charge_levels();
+  return true;
+}
+
+void SamplePyramid::write_cache(const std::filesystem::path &file,
+                                std::uint64_t key) const {
+  // Write a temp file and rename it, so readers never see a partial cache.
+  std::filesystem::path tmp = file;
+  tmp += ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    const Header h{kMagic, kVersion, key, count_};
+    out.write(reinterpret_cast<const char *>(&h), sizeof h);
+    for (const auto &lv : levels_)
+      out.write(reinterpret_cast<const char *>(lv.data()),
+                std::streamsize((lv.size() - kGuard) * sizeof(float)));
+  }
+  std::error_code ec;
+  if (std::filesystem::file_size(tmp, ec) != cache_bytes(count_)) {
+    std::filesystem::remove(tmp, ec);
+    return;
+  }
+  std::filesystem::rename(tmp, file, ec);
+  if (ec)
+    std::filesystem::remove(tmp, ec);
+}
+
+} // namespace audio
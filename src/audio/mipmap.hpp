@@ -0,0 +1,67 @@
+// src/audio/mipmap.hpp
+// Band-limited octave pyramid of a SoundFont's sample pool.
+//
+// Level 0 is tsf's own float pool; level k is level k-1 low-passed and
+// decimated by two, so a voice pitched up by 2^k can read level k at a
+// playback ratio below 2 instead of skipping samples in level 0.
+//
+//   auto pyr = audio::SamplePyramid::load_or_build(pool, count, sf2Path);
+//   const float *l2 = pyr->level(2);   // quarter-rate copy of the pool
+//
+// Design notes:
+// - The pool is filtered as one signal. SoundFont samples are separated by
+//   at least 46 zero samples, which covers the filter's half-length at level
+//   0; at higher levels a few guard samples may pick up a faint edge.
+// - Loop points are mapped per voice at note-on (audio/synth.cpp): the loop
+//   length is rounded at each level and the playback step is scaled by the
+//   same factor, so loops stay in tune.
+// - Building costs one vectorized FIR pass per level, so pyramids are cached
+//   on disk, keyed by font path, size, mtime and the pyramid format version.
+//   Cache directory: $MIDI_PLAYER_CACHE, else $XDG_CACHE_HOME/midi_player,
+//   else ~/.cache/midi_player. Cache I/O failures only cost a rebuild.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "common/mem_account.hpp"
+
+namespace audio {
+
+class SamplePyramid {
+public:
+  static constexpr int kLevels = 4; // level 0 + three half-rate copies
+  static constexpr std::size_t kGuard = 64; // zero samples after each level
+
+  // Build from the first `count` samples of `pool` (not copied for level 0).
+  SamplePyramid(const float *pool, std::size_t count);
+
+  // Like the constructor, but reuse/refresh the on-disk cache for sf2Path.
+  static std::shared_ptr<const SamplePyramid>
+  load_or_build(const float *pool, std::size_t count,
+                const std::filesystem::path &sf2Path);
+
+  [[nodiscard]] const float *level(int k) const {
+    return k == 0 ? base_ : levels_[std::size_t(k - 1)].data();
+  }
+  // Samples in level k (without the zero guard).
+  [[nodiscard]] std::size_t size(int k) const {
+    return k == 0 ? count_ : levels_[std::size_t(k - 1)].size() - kGuard;
+  }
+
+private:
+  SamplePyramid(const float *pool, std::size_t count, std::nullptr_t);
+  bool read_cache(const std::filesystem::path &file, std::uint64_t key);
+  void write_cache(const std::filesystem::path &file, std::uint64_t key) const;
+  void charge_levels();
+
+  const float *base_;
+  std::size_t count_;
+  std::vector<std::vector<float>> levels_; // levels 1..kLevels-1
+  MemCharge mem_{MemSubsystem::Pyramids};  // levels_ (level 0 is tsf's)
+};
+
+} // namespace audio
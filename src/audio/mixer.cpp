@@ -0,0 +1,561 @@
+// src/audio/mixer.cpp
+// N independent sessions -> one output driver (the playback device unless
+// the caller brings one). TinySoundFont is compiled in synth.cpp; here we
+// only use its public API.
+
+#include "audio/driver.hpp"
+#include "audio/effects.hpp"
+#include "audio/fork_join.hpp"
+#include "audio/mixer.hpp"
+#include "audio/offline.hpp"
+#include "audio/render_cost.hpp"
+#include "audio/schedule.hpp"
+#include "audio/simd.hpp"
+#include "audio/synth.hpp"
+#include "common/mem_account.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t kSampleRate = 44100;
+constexpr int kMaxBlockFrames = audio::kMaxBusFrames; // per-session scratch
+constexpr int kMaxVoicesPerSession = 64;
+constexpr double kTailSec = 2.0;
+// Go parallel once the summed session render time exceeds this fraction of
+// the callback period (i.e. of one core).
+constexpr double kParallelLoad = 0.6;
+constexpr double kLoadSmoothing = 0.1; // EMA factor for the load estimate
+constexpr double kWaitPollSec = 0.03;   // wait_all / wait_finished polling
+
+enum SessionState : int { Empty, Stopped, Playing, Finished, Queued };
+
+struct Session {
+  std::unique_ptr<audio::Synth> synth;
+  audio::Schedule events{mem_resource(MemSubsystem::Schedule)};
+  std::size_t nextIndex = 0;
+  double timeSec = 0.0;
+  double endTimeSec = 0.0;
+  // Interleaved stereo scratch, kMaxBlockFrames * 2 each: dry mix and this
+  // session's contribution to the shared reverb/chorus buses.
+  std::vector<float> buf, reverb, chorus;
+  double lastRenderSec = 0.0;
+  bool ending = false; // last block rendered; retired after the mix
+
+  // Admission control; demand is written under the control lock, the
+  // measured load by the callback.
+  double demandCores = 0.0;
+  audio::SongDemand demand;
+  bool startWhenAdmitted = false; // start() called while queued
+  std::atomic<double> loadCores{0.0}; // EMA of render time / period
+
+  std::atomic<int> state{Empty};
+  std::atomic<float> gain{1.0f};
+  std::atomic<float> pan{0.0f};
+};
+
+// Feed due events, render one block into s.buf (and, with `sends`, its
+// buses) and advance the clock. Only ever called for one session by one
+// thread at a time.
+void render_session(Session &s, int frames, double sampleRate, bool sends) {
+  const auto t0 = std::chrono::steady_clock::now();
+  const double dt = frames / sampleRate;
+  const double t1 = s.timeSec + dt;
+
+  while (s.nextIndex < s.events.size() && s.events[s.nextIndex].tSec <= t1)
+    s.synth->apply(s.events[s.nextIndex++]);
+
+  if (sends) {
+    audio::simd::clear_stereo(s.reverb.data(), std::size_t(frames));
+    audio::simd::clear_stereo(s.chorus.data(), std::size_t(frames));
+    s.synth->render(s.buf.data(), s.reverb.data(), s.chorus.data(), frames);
+  } else {
+    s.synth->render(s.buf.data(), nullptr, nullptr, frames);
+  }
+
+  // Last block: linear fade to silence; render() retires the session.
+  if (t1 >= s.endTimeSec) {
+    const double tailLeft = std::max(0.0, s.endTimeSec - s.timeSec);
+    const double start = std::min(1.0, tailLeft / dt);
+    for (int i = 0; i < frames; ++i) {
+      const float g = static_cast<float>(start * (1.0 - double(i) / frames));
+      for (std::vector<float> *b : {&s.buf, &s.reverb, &s.chorus}) {
+        (*b)[2 * i] *= g;
+        (*b)[2 * i + 1] *= g;
+      }
+    }
+    s.ending = true;
+  }
+
+  s.timeSec = t1;
+  s.lastRenderSec = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - t0)
+                        .count();
+}
+
+// ForkJoinPool job: render active session `i` for the current block.
+struct BlockJob {
+  Session *const *sessions;
+  int frames;
+  double sampleRate;
+  bool sends;
+};
+void render_job(void *ctx, int i) {
+  const auto *job = static_cast<const BlockJob *>(ctx);
+  render_session(*job->sessions[i], job->frames, job->sampleRate,
+                 job->sends);
+}
+
+inline void ensure(bool cond, const char *msg) {
+  if (!cond)
+    throw std::runtime_error(msg);
+}
+
+} // namespace
+
+namespace audio {
+
+struct Mixer::Impl {
+  explicit Impl(const std::filesystem::path &sf2Path)
+      : font(sf2Path, static_cast<int>(kSampleRate)),
+        fx(static_cast<int>(kSampleRate)) {}
+
+  Synth font;     // shared font; sessions are share()d copies of it
+  SendEffects fx; // one reverb + chorus for all sessions
+  bool sends = true; // false: dry, the buses are neither fed nor run
+  std::unique_ptr<Session[]> sessions;
+  int maxSessions = 0;
+  std::vector<Session *> active; // callback scratch, capacity = maxSessions
+  std::unique_ptr<ForkJoinPool> pool;
+  double loadEma = 0.0; // summed render time / callback period
+  std::mutex controlMutex;
+  CostModel model;              // under controlMutex
+  std::vector<SessionId> queue; // FIFO of Queued sessions, same lock
+
+  std::unique_ptr<Driver> device; // when the caller brought no driver
+  Driver *driver = nullptr;
+  // Odd while the callback runs: remove() waits out a block that may still
+  // be rendering the session it takes away.
+  std::atomic<std::uint64_t> callbackSeq{0};
+
+  Session &at(SessionId id) const {
+    if (id < 0 || id >= maxSessions ||
+        sessions[id].state.load(std::memory_order_acquire) == Empty) {
+      throw std::runtime_error("Unknown mixer session id " +
+                               std::to_string(id));
+    }
+    return sessions[id];
+  }
+
+  void render(float *out, int frames) {
+    active.clear();
+    for (int i = 0; i < maxSessions; ++i) {
+      // seq_cst, paired with remove(): see callbackSeq.
+      if (sessions[i].state.load() == Playing)
+        active.push_back(&sessions[i]);
+    }
+
+    const int n = static_cast<int>(active.size());
+    const bool parallel = pool && n > 1 && loadEma > kParallelLoad;
+    if (parallel) {
+      BlockJob job{active.data(), frames, kSampleRate, sends};
+      pool->run(n, render_job, &job);
+    } else {
+      for (Session *s : active)
+        render_session(*s, frames, kSampleRate, sends);
+    }
+
+    const auto n2 = static_cast<std::size_t>(frames);
+    simd::clear_stereo(out, n2);
+    if (sends)
+      fx.clear(frames);
+    double cost = 0.0;
+    for (Session *s : active) {
+      const float g = s->gain.load(std::memory_order_relaxed);
+      const float p = std::clamp(s->pan.load(std::memory_order_relaxed),
+                                 -1.0f, 1.0f);
+      // Balance law: center is unity on both sides.
+      const float gl = g * std::min(1.0f, 1.0f - p);
+      const float gr = g * std::min(1.0f, 1.0f + p);
+      simd::mix_stereo(out, s->buf.data(), n2, gl, gr);
+      if (sends) {
+        simd::mix_stereo(fx.reverb_bus(), s->reverb.data(), n2, gl, gr);
+        simd::mix_stereo(fx.chorus_bus(), s->chorus.data(), n2, gl, gr);
+      }
+      cost += s->lastRenderSec;
+    }
+    if (sends)
+      fx.process(out, frames); // effect cost is per mixer, not per session
+    simd::clip_stereo(out, n2);
+
+    const double periodSec = frames / static_cast<double>(kSampleRate);
+    loadEma += kLoadSmoothing * (cost / periodSec - loadEma);
+    for (Session *s : active) {
+      const double was = s->loadCores.load(std::memory_order_relaxed);
+      s->loadCores.store(
+          was + kLoadSmoothing * (s->lastRenderSec / periodSec - was),
+          std::memory_order_relaxed);
+    }
+    // Publish Finished only now: start() rewinds a finished session, so the
+    // callback must be done with its clock and buffers first. A session
+    // stopped meanwhile stays Stopped and ends on its next block.
+    for (Session *s : active) {
+      if (!s->ending)
+        continue;
+      s->ending = false;
+      int expected = Playing;
+      s->state.compare_exchange_strong(expected, Finished,
+                                       std::memory_order_acq_rel);
+    }
+  }
+
+  // Find a free slot, or -1. Control lock held.
+  SessionId free_slot() const {
+    for (int i = 0; i < maxSessions; ++i) {
+      if (sessions[i].state.load(std::memory_order_acquire) == Empty)
+        return i;
+    }
+    return -1;
+  }
+
+  // Build session `id` for a song, still invisible to the callback (the
+  // caller publishes it with a release store of its state). Control lock
+  // held: share() (tsf_copy) is not thread-safe.
+  void prepare(SessionId id, const midi::Song &song,
+               const midi::TempoMap &tempo) {
+    Session &s = sessions[id];
+    s.synth = std::make_unique<Synth>(font.share());
+    s.synth->set_max_voices(kMaxVoicesPerSession); // no allocs in callback
+
+    s.events =
+        build_schedule(song, tempo, mem_resource(MemSubsystem::Schedule));
+    s.nextIndex = 0;
+    s.timeSec = 0.0;
+    s.ending = false;
+    s.endTimeSec =
+        (s.events.empty() ? 0.0 : s.events.back().tSec) + kTailSec;
+    s.buf.assign(std::size_t(kMaxBlockFrames) * 2, 0.0f);
+    s.reverb.assign(s.buf.size(), 0.0f);
+    s.chorus.assign(s.buf.size(), 0.0f);
+    s.gain.store(1.0f, std::memory_order_relaxed);
+    s.pan.store(0.0f, std::memory_order_relaxed);
+    s.demand = estimate_demand(song, tempo, model, kMaxVoicesPerSession);
+    s.demandCores = model.cores(s.demand.peakVoices, font.interpolation(),
+                                int(kSampleRate));
+    s.startWhenAdmitted = false;
+    s.loadCores.store(0.0, std::memory_order_relaxed);
+  }
+
+  // Budget with the admitted sessions taken out. Control lock held.
+  Headroom budget() const {
+    Headroom h;
+    h.cores = pool ? pool->size() + 1 : 1;
+    h.capacity = h.cores * kAdmitBudget;
+    for (int i = 0; i < maxSessions; ++i) {
+      const Session &s = sessions[i];
+      const int st = s.state.load(std::memory_order_acquire);
+      const double load = s.loadCores.load(std::memory_order_relaxed);
+      if (st == Stopped || st == Playing)
+        h.committed += std::max(s.demandCores, load);
+      if (st == Playing)
+        h.measured += load;
+    }
+    h.available = h.capacity - h.committed;
+    h.queued = static_cast<int>(queue.size());
+    return h;
+  }
+
+  // The best tier in `tiers` whose estimate fits `room` cores (and one
+  // core's budget, as a session renders on one thread), or -1.
+  int fitting_tier(const Session &s, const std::vector<Interp> &tiers,
+                   double room) const {
+    for (std::size_t t = 0; t < tiers.size(); ++t) {
+      const double c =
+          model.cores(s.demand.peakVoices, tiers[t], int(kSampleRate));
+      if (c <= std::min(room, kAdmitBudget))
+        return static_cast<int>(t);
+    }
+    return -1;
+  }
+
+  // Move session `id` to `tier` and make it visible. Control lock held.
+  void admit(Session &s, Interp tier) {
+    s.synth->set_interpolation(tier);
+    s.demandCores = model.cores(s.demand.peakVoices, tier, int(kSampleRate));
+    s.state.store(s.startWhenAdmitted ? Playing : Stopped,
+                  std::memory_order_release);
+  }
+
+  // Admit queued sessions, in order, while they fit. Control lock held.
+  void admit_queued() {
+    while (!queue.empty()) {
+      Session &s = sessions[queue.front()];
+      const std::vector<Interp> tiers = tiers_from(s.synth->interpolation());
+      const int t = fitting_tier(s, tiers, budget().available);
+      if (t < 0)
+        return;
+      admit(s, tiers[std::size_t(t)]);
+      queue.erase(queue.begin());
+    }
+  }
+
+  static void data_callback(void *user, float *out, std::uint32_t frames) {
+    auto *self = static_cast<Impl *>(user);
+    self->callbackSeq.fetch_add(1); // odd: rendering
+    while (frames > 0) {
+      const std::uint32_t n =
+          std::min<std::uint32_t>(frames, std::uint32_t(kMaxBlockFrames));
+      self->render(out, static_cast<int>(n));
+      out += n * 2;
+      frames -= n;
+    }
+    self->callbackSeq.fetch_add(1, std::memory_order_release);
+  }
+
+  // Return once no callback that could have seen a session Playing before
+  // the caller's (seq_cst) state change is still running.
+  void wait_callback_done() const {
+    const std::uint64_t seq = callbackSeq.load();
+    if (seq & 1) {
+      while (callbackSeq.load(std::memory_order_acquire) == seq)
+        std::this_thread::yield();
+    }
+  }
+};
+
+Mixer::Mixer(const std::filesystem::path &sf2Path, int maxSessions)
+    : Mixer(sf2Path, MixerOptions{maxSessions}) {}
+
+Mixer::Mixer(const std::filesystem::path &sf2Path, const MixerOptions &opts)
+    : impl_(std::make_unique<Impl>(sf2Path)) {
+  const int maxSessions = opts.maxSessions;
+  ensure(maxSessions > 0, "Mixer needs at least one session slot");
+
+  impl_->font.set_interpolation(opts.interp); // inherited by share()
+  if (opts.mipmaps)
+    impl_->font.enable_mipmaps(); // (so is the pyramid)
+  impl_->sends = opts.sendEffects;
+  impl_->maxSessions = maxSessions;
+  impl_->sessions = std::make_unique<Session[]>(maxSessions);
+  impl_->active.reserve(maxSessions);
+
+  const int hw = static_cast<int>(std::thread::hardware_concurrency());
+  const int workers = std::min(maxSessions, std::max(hw, 1)) - 1;
+  if (workers > 0)
+    impl_->pool = std::make_unique<ForkJoinPool>(workers);
+
+  impl_->driver = opts.driver;
+  if (!impl_->driver) {
+    impl_->device = std::make_unique<DeviceDriver>();
+    impl_->driver = impl_->device.get();
+  }
+  impl_->driver->start(int(kSampleRate), &Impl::data_callback, impl_.get());
+}
+
+Mixer::~Mixer() {
+  impl_->driver->stop();
+  impl_->pool.reset();
+}
+
+SessionId Mixer::add(const midi::Song &song, const midi::TempoMap &tempo) {
+  std::lock_guard<std::mutex> lk(impl_->controlMutex);
+
+  const SessionId id = impl_->free_slot();
+  ensure(id >= 0, "Mixer is full (no free session slots)");
+
+  // The slot is invisible to the callback until the final release store.
+  impl_->prepare(id, song, tempo);
+  impl_->sessions[id].state.store(Stopped, std::memory_order_release);
+  return id;
+}
+
+AdmitResult Mixer::try_add(const midi::Song &song,
+                           const midi::TempoMap &tempo,
+                           const AdmitPolicy &policy) {
+  std::lock_guard<std::mutex> lk(impl_->controlMutex);
+  AdmitResult r;
+  const SessionId id = impl_->free_slot();
+  if (id < 0)
+    return r;
+
+  impl_->prepare(id, song, tempo);
+  Session &s = impl_->sessions[id];
+  const Interp best = impl_->font.interpolation();
+  const std::vector<Interp> tiers =
+      policy.downgrade ? tiers_from(best) : std::vector<Interp>{best};
+  r.demand = s.demand;
+
+  // Queued songs go first: a new one only jumps in when none are waiting.
+  const Headroom h = impl_->budget();
+  int t = impl_->queue.empty() ? impl_->fitting_tier(s, tiers, h.available)
+                               : -1;
+  if (t >= 0) {
+    r.verdict = t == 0 ? Admit::Admitted : Admit::Downgraded;
+  } else {
+    t = impl_->fitting_tier(s, tiers, h.capacity); // once the rest is done
+    if (t < 0 || !policy.queue) {
+      s.synth.reset();
+      audio::Schedule(mem_resource(MemSubsystem::Schedule)).swap(s.events);
+      r.tier = tiers[std::size_t(t < 0 ? tiers.size() - 1 : t)];
+      r.demandCores =
+          impl_->model.cores(s.demand.peakVoices, r.tier, int(kSampleRate));
+      return r; // slot stays Empty
+    }
+    r.verdict = Admit::Queued;
+  }
+  r.id = id;
+  r.tier = tiers[std::size_t(t)];
+  r.demandCores =
+      impl_->model.cores(s.demand.peakVoices, r.tier, int(kSampleRate));
+  if (r.verdict == Admit::Queued) {
+    s.synth->set_interpolation(r.tier); // best it can get; re-picked later
+    s.state.store(Queued, std::memory_order_release);
+    impl_->queue.push_back(id);
+  } else {
+    impl_->admit(s, r.tier);
+  }
+  return r;
+}
+
+Headroom Mixer::headroom() const {
+  std::lock_guard<std::mutex> lk(impl_->controlMutex);
+  return impl_->budget();
+}
+
+void Mixer::set_cost_model(const CostModel &model) {
+  std::lock_guard<std::mutex> lk(impl_->controlMutex);
+  impl_->model = model;
+}
+
+void Mixer::calibrate_cost_model(double seconds) {
+  std::lock_guard<std::mutex> lk(impl_->controlMutex);
+  CostModel m = CostModel::from(measure_interp_cost(impl_->font, seconds));
+  m.channelWeight = impl_->model.channelWeight;
+  impl_->model = m;
+}
+
+void Mixer::calibrate_channels(const midi::Song &song,
+                               const midi::TempoMap &tempo, double seconds) {
+  std::lock_guard<std::mutex> lk(impl_->controlMutex); // share() in here
+  const bool wasOn = cost_enabled();
+  cost_enable();
+  OfflineRender pre(impl_->font, build_schedule(song, tempo),
+                    int(kSampleRate), 0.0, seconds);
+  while (pre.step() > 0) {
+  }
+  if (!wasOn)
+    cost_disable(); // the sessions' callbacks skip the accounting again
+  impl_->model.calibrate_channels();
+}
+
+void Mixer::start(SessionId id) {
+  std::lock_guard<std::mutex> lk(impl_->controlMutex);
+  Session &s = impl_->at(id);
+  int st = s.state.load(std::memory_order_acquire);
+  if (st == Queued) {
+    s.startWhenAdmitted = true;
+    impl_->admit_queued();
+    return;
+  }
+  if (st == Finished) {
+    // Finished is published after the callback's last use of the session
+    // (Impl::render), so it is safe to rewind here.
+    s.synth->all_notes_off();
+    s.nextIndex = 0;
+    s.timeSec = 0.0;
+    st = Stopped;
+    s.state.store(Stopped, std::memory_order_release);
+  }
+  if (st == Stopped)
+    s.state.compare_exchange_strong(st, Playing, std::memory_order_acq_rel);
+}
+
+void Mixer::stop(SessionId id) {
+  // Locked: admission moves sessions out of Queued under the same lock.
+  std::lock_guard<std::mutex> lk(impl_->controlMutex);
+  Session &s = impl_->at(id);
+  if (s.state.load(std::memory_order_acquire) == Queued) {
+    s.startWhenAdmitted = false;
+    return;
+  }
+  int expected = Playing;
+  s.state.compare_exchange_strong(expected, Stopped,
+                                  std::memory_order_acq_rel);
+}
+
+void Mixer::remove(SessionId id) {
+  std::lock_guard<std::mutex> lk(impl_->controlMutex);
+  Session &s = impl_->at(id);
+  auto &q = impl_->queue;
+  q.erase(std::remove(q.begin(), q.end(), id), q.end());
+  // Out of the callback's sight first, then wait out a block in flight.
+  if (s.state.exchange(Stopped) == Playing)
+    impl_->wait_callback_done();
+  s.synth.reset();
+  audio::Schedule(mem_resource(MemSubsystem::Schedule)).swap(s.events);
+  s.state.store(Empty, std::memory_order_release);
+  impl_->admit_queued(); // its budget is free now
+}
+
+void Mixer::set_gain(SessionId id, float gain) {
+  impl_->at(id).gain.store(std::max(0.0f, gain), std::memory_order_relaxed);
+}
+
+void Mixer::set_pan(SessionId id, float pan) {
+  impl_->at(id).pan.store(std::clamp(pan, -1.0f, 1.0f),
+                          std::memory_order_relaxed);
+}
+
+bool Mixer::finished(SessionId id) const {
+  return impl_->at(id).state.load(std::memory_order_acquire) == Finished;
+}
+
+void Mixer::wait_all() const {
+  // Same polling approach as audio::play: the callback drives the clocks.
+  // Queued sessions are admitted here as the ones playing finish.
+  auto anyPlaying = [this] {
+    for (int i = 0; i < impl_->maxSessions; ++i) {
+      const int st = impl_->sessions[i].state.load(std::memory_order_acquire);
+      if (st == Playing || st == Queued)
+        return true;
+    }
+    return false;
+  };
+  while (anyPlaying()) {
+    impl_->driver->wait(kWaitPollSec);
+    std::lock_guard<std::mutex> lk(impl_->controlMutex);
+    impl_->admit_queued();
+  }
+}
+
+SessionId Mixer::wait_finished() const {
+  for (;;) {
+    bool waiting = false;
+    for (int i = 0; i < impl_->maxSessions; ++i) {
+      const int st = impl_->sessions[i].state.load(std::memory_order_acquire);
+      if (st == Finished)
+        return i;
+      waiting = waiting || st == Playing || st == Queued;
+    }
+    if (!waiting)
+      return -1;
+    impl_->driver->wait(kWaitPollSec);
+    std::lock_guard<std::mutex> lk(impl_->controlMutex);
+    impl_->admit_queued();
+  }
+}
+
+int Mixer::worker_count() const {
+  return impl_->pool ? impl_->pool->size() : 0;
+}
+
+} // namespace audio
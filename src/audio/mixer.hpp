@@ -0,0 +1,154 @@
+// src/audio/mixer.hpp
+// Host several independent songs ("sessions") on one output (a playback
+// device by default).
+// Each session owns its schedule, its clock and its own TinySoundFont instance
+// (a tsf_copy of one shared font, so samples are loaded only once).
+//
+// Public API:
+//   audio::Mixer mix(sf2Path);
+//   auto id = mix.add(song, tempo);   // session starts stopped
+//   mix.set_gain(id, 0.5f); mix.set_pan(id, -0.3f);
+//   mix.start(id);
+//   mix.wait_all();                   // blocks until all sessions finished
+//
+//   auto r = mix.try_add(song, tempo); // admission control: may downgrade,
+//   if (r.verdict != Admit::Rejected)  // queue or reject the song
+//     mix.start(r.id);                 // a queued one starts when admitted
+//   Headroom h = mix.headroom();       // free cores right now
+//   mix.remove(mix.wait_finished());   // free a slot for the next song
+//
+// Design notes:
+// - Control calls are lock-free with respect to the audio thread: session
+//   state, gain and pan are atomics; a slot is published with a release store
+//   after it has been fully built.
+// - The callback renders every playing session into its own float buffer,
+//   then sums them with SIMD (audio/simd.hpp). When the measured render cost
+//   of all sessions exceeds ~60% of one core's callback budget, sessions are
+//   rendered in parallel on a small worker pool (fork-join per callback).
+// - All sessions feed one shared reverb and chorus bus (audio/effects.hpp),
+//   so send effects cost the same for one session or ten.
+// - stop() pauses a session (voices are frozen, not released); start() on a
+//   finished session rewinds it and plays it again. remove() frees the slot
+//   for good; a long-running mixer (a server taking songs one after
+//   another) removes finished sessions, or add() and try_add() run out of
+//   slots. It waits for at most one callback.
+// - Output goes through an audio::Driver (audio/driver.hpp), so a mixer
+//   runs on the simulated driver as play() does; wait_all() and
+//   wait_finished() wait on the driver's clock.
+// - Admission control (audio/admission.hpp): try_add() estimates the song's
+//   peak demand in cores at each quality tier and admits it at the best
+//   tier that fits the free budget (kAdmitBudget of every render core, and
+//   of one core for the session itself, which never splits). A session
+//   counts the larger of its estimate and its measured load, so a bad
+//   estimate corrects itself once the session plays. Songs that fit later
+//   wait in a FIFO queue holding their slot; wait_all() and start() admit
+//   them as sessions finish. add() bypasses all of this.
+
+#pragma once
+#include <filesystem>
+#include <memory>
+
+#include "audio/admission.hpp"
+#include "audio/driver.hpp"
+#include "audio/interp.hpp"
+#include "midi/events.hpp"
+#include "midi/tempo.hpp"
+
+namespace audio {
+
+using SessionId = int;
+
+enum class Admit { Admitted, Downgraded, Queued, Rejected };
+
+struct AdmitPolicy {
+  bool downgrade = true; // allow cheaper interpolation than the mixer's
+  bool queue = true;     // wait for headroom instead of rejecting
+};
+
+struct AdmitResult {
+  Admit verdict = Admit::Rejected;
+  SessionId id = -1;          // valid unless rejected
+  Interp tier = Interp::Cubic; // admitted (or, queued, best possible) tier
+  double demandCores = 0.0;   // estimate at `tier`
+  SongDemand demand;
+};
+
+// Render budget in cores (1.0 = one core's real-time budget).
+struct Headroom {
+  int cores = 1;           // threads that render sessions (workers + 1)
+  double capacity = 0.0;   // cores * kAdmitBudget
+  double committed = 0.0;  // admitted sessions: max(estimate, measured)
+  double measured = 0.0;   // render load of the last blocks, all sessions
+  double available = 0.0;  // capacity - committed (may be negative)
+  int queued = 0;          // sessions waiting for admission
+};
+
+struct MixerOptions {
+  int maxSessions = 8;
+  // Every session's quality, as PlayOptions: the best tier admission
+  // control picks from, and whether the mip-map pyramid is built.
+  Interp interp = Interp::Cubic;
+  bool mipmaps = true;
+  bool sendEffects = true; // false: dry, the shared buses are skipped
+  Driver *driver = nullptr; // output; default: the playback device
+};
+
+class Mixer {
+public:
+  // Loads the SoundFont and opens/starts the device (silent until a session
+  // is started). Throws std::runtime_error on device or SF2 errors.
+  explicit Mixer(const std::filesystem::path &sf2Path, int maxSessions = 8);
+  Mixer(const std::filesystem::path &sf2Path, const MixerOptions &opts);
+  ~Mixer();
+
+  Mixer(const Mixer &) = delete;
+  Mixer &operator=(const Mixer &) = delete;
+
+  // Add a song as a new (stopped) session. Throws if all slots are in use.
+  SessionId add(const midi::Song &song, const midi::TempoMap &tempo);
+
+  // Add a song under admission control (see the notes above). Rejected
+  // songs take no slot; a mixer with no free slot rejects.
+  AdmitResult try_add(const midi::Song &song, const midi::TempoMap &tempo,
+                      const AdmitPolicy &policy = {});
+
+  // Current budget; safe to call from any thread.
+  [[nodiscard]] Headroom headroom() const;
+
+  // Replace the cost model try_add() estimates with (default: built-in).
+  void set_cost_model(const CostModel &model);
+  // Measure this font's interpolation costs (measure_interp_cost, about
+  // 4 * seconds); channel weights are kept.
+  void calibrate_cost_model(double seconds = 0.25);
+  // Render the first `seconds` of a song offline with cost accounting on,
+  // then take the channel weights from the cost tables (every song
+  // pre-rendered so far). Call before try_add() of that song; with
+  // --cost-report the pre-renders show up in the report.
+  void calibrate_channels(const midi::Song &song, const midi::TempoMap &tempo,
+                          double seconds = 2.0);
+
+  void start(SessionId id);
+  void stop(SessionId id);
+  // Stop the session and free its slot; `id` is unknown afterwards. Queued
+  // songs that fit the freed budget are admitted.
+  void remove(SessionId id);
+  void set_gain(SessionId id, float gain); // linear, 1.0 = unity
+  void set_pan(SessionId id, float pan);   // -1 = left, 0 = center, +1 = right
+
+  [[nodiscard]] bool finished(SessionId id) const;
+
+  // Block until no session is playing or queued any more.
+  void wait_all() const;
+  // Block until a session is finished and return its id (the lowest one),
+  // or -1 once none is finished, playing or queued.
+  [[nodiscard]] SessionId wait_finished() const;
+
+  // Number of helper threads available for parallel session rendering.
+  [[nodiscard]] int worker_count() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace audio
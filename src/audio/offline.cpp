@@ -0,0 +1,146 @@
+// src/audio/offline.cpp
+// Block-by-block offline render of one song.
+
+#include "audio/offline.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "common/hash.hpp"
+
+namespace {
+
+constexpr std::uint32_t kOfflineStateTag = 0x314B4350; // "PCK1"
+
+// Hash of the fields (not the padding) of every event.
+std::uint64_t schedule_hash(const audio::Schedule &events) {
+  std::uint64_t h = kFnv1aSeed;
+  for (const audio::ScheduledEvent &e : events) {
+    const std::uint8_t b[5] = {e.ch, e.data1, e.data2,
+                               std::uint8_t(e.kind), e.port};
+    h = fnv1a(&e.tSec, sizeof e.tSec, h);
+    h = fnv1a(b, sizeof b, h);
+  }
+  return h;
+}
+
+std::size_t render_frames(const audio::Schedule &events, double tailSec,
+                          double maxSec, int sampleRate) {
+  const double end =
+      std::min((events.empty() ? 0.0 : events.back().tSec) + tailSec, maxSec);
+  return std::size_t(std::max(0.0, end) * sampleRate);
+}
+
+} // namespace
+
+namespace audio {
+
+OfflineRender::OfflineRender(const Synth &font, Schedule events,
+                             int sampleRate, double tailSec, double maxSec)
+    : synth_(font.share()), fx_(sampleRate), events_(std::move(events)),
+      sampleRate_(sampleRate), tailSec_(tailSec), maxSec_(maxSec),
+      block_(std::size_t(kMaxBusFrames) * 2, 0.0f) {
+  frames_ = render_frames(events_, tailSec_, maxSec_, sampleRate_);
+}
+
+void OfflineRender::set_convolution(std::unique_ptr<ConvolutionReverb> conv,
+                                    bool onMaster, float wet) {
+  if (pos_ != 0)
+    throw std::logic_error("set_convolution after the render started");
+  conv_ = std::move(conv);
+  convMaster_ = onMaster;
+  // On the bus the IR stands in for the FDN, at the same return level.
+  convWet_ = onMaster ? wet : fx_.reverb_return();
+  if (onMaster)
+    convIn_.assign(std::size_t(kMaxBusFrames) * 2, 0.0f);
+  dry_.assign(std::size_t(conv_->latency_frames()) * 2, 0.0f);
+  dryPos_ = 0;
+  const double irSec = double(conv_->ir_frames()) / sampleRate_;
+  frames_ = render_frames(events_, std::max(tailSec_, irSec), maxSec_,
+                          sampleRate_);
+}
+
+// The next `frames` frames of the song at synthPos_, effects included. With
+// a convolution reverb the dry part comes out of the delay line, so `out`
+// holds the song at synthPos_ - latency.
+void OfflineRender::render(float *out, int frames) {
+  const double tEnd = double(synthPos_ + std::size_t(frames)) / sampleRate_;
+  while (next_ < events_.size() && events_[next_].tSec <= tEnd)
+    synth_.apply(events_[next_++]);
+  fx_.clear(frames);
+  synth_.render(out, fx_.reverb_bus(), fx_.chorus_bus(), frames);
+  synthPos_ += std::size_t(frames);
+  if (!conv_) {
+    fx_.process(out, frames);
+    return;
+  }
+  const float *wetIn = fx_.reverb_bus();
+  if (convMaster_) {
+    fx_.process(out, frames);
+    std::copy(out, out + std::size_t(frames) * 2, convIn_.begin());
+    wetIn = convIn_.data();
+  } else {
+    fx_.process_chorus(out, frames);
+  }
+  for (std::size_t i = 0; i < std::size_t(frames) * 2; ++i) {
+    std::swap(out[i], dry_[dryPos_]);
+    dryPos_ = dryPos_ + 1 == dry_.size() ? 0 : dryPos_ + 1;
+  }
+  conv_->process(wetIn, out, frames, convWet_);
+}
+
+int OfflineRender::step() {
+  if (done()) {
+    blockFrames_ = 0;
+    return 0;
+  }
+  // Fill the convolver (and the dry delay line) up to its latency once; the
+  // wet output of those frames belongs before the song start.
+  const std::size_t lead = conv_ ? std::size_t(conv_->latency_frames()) : 0;
+  while (synthPos_ < pos_ + lead) {
+    render(block_.data(), int(std::min<std::size_t>(pos_ + lead - synthPos_,
+                                                    kMaxBusFrames)));
+  }
+  const int n = int(std::min<std::size_t>(frames_ - pos_, kMaxBusFrames));
+  render(block_.data(), n);
+  pos_ += std::size_t(n);
+  blockFrames_ = n;
+  return n;
+}
+
+void OfflineRender::save_state(StateWriter &w) const {
+  if (conv_)
+    throw std::runtime_error("Cannot checkpoint a convolution reverb");
+  w.put(kOfflineStateTag);
+  w.put(sampleRate_);
+  w.put(std::uint64_t(frames_));
+  w.put(std::uint64_t(events_.size()));
+  w.put(schedule_hash(events_));
+  w.put(std::uint64_t(pos_));
+  w.put(std::uint64_t(next_));
+  synth_.save_state(w);
+  fx_.save_state(w);
+}
+
+void OfflineRender::load_state(StateReader &r) {
+  if (conv_)
+    throw std::runtime_error("Cannot checkpoint a convolution reverb");
+  r.expect(kOfflineStateTag, "render state tag");
+  r.expect(sampleRate_, "sample rate");
+  r.expect(std::uint64_t(frames_), "song length");
+  r.expect(std::uint64_t(events_.size()), "event count");
+  r.expect(schedule_hash(events_), "schedule");
+  const std::uint64_t pos = r.get<std::uint64_t>();
+  const std::uint64_t next = r.get<std::uint64_t>();
+  if (pos > frames_ || next > events_.size())
+    throw std::runtime_error("Checkpoint mismatch: position");
+  synth_.load_state(r);
+  fx_.load_state(r);
+  pos_ = synthPos_ = std::size_t(pos);
+  next_ = std::size_t(next);
+  blockFrames_ = 0;
+}
+
+} // namespace audio
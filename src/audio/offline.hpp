@@ -0,0 +1,99 @@
+// src/audio/offline.hpp
+// A song rendered offline, one block at a time, resumable between blocks.
+//
+//   audio::OfflineRender job(font, audio::build_schedule(song, tempo), 44100);
+//   while (job.step() > 0)                  // one block of <= kMaxBusFrames
+//     sink(job.block(), job.block_frames());
+//
+// Design notes:
+// - The job owns everything its render depends on: a share()d Synth (the
+//   font's samples are not copied), its own SendEffects and the schedule
+//   cursor. Between two step() calls nothing else touches that state, so a
+//   scheduler can park a job after any block and resume it later, on any
+//   thread, with bit-identical output.
+// - Events are applied per block up to the block end, as in the real-time
+//   callback, so offline output matches what the device path renders.
+// - The output is one block buffer, not the whole song: an hours-long
+//   catalog render streams through it (take it with block() after each
+//   step()).
+// - Construct jobs on one thread: share() is not thread-safe with respect
+//   to other share() calls on the same font.
+// - Checkpoints: save_state() between two steps captures the position, the
+//   event cursor, the synth (every voice) and the send effects. A fresh job
+//   built from the same font, schedule and settings continues from it after
+//   load_state() with the same output an uninterrupted render produces. The
+//   schedule itself is not saved, only a hash to check it against.
+// - A convolution reverb (set_convolution, Mode::Offline) runs kOfflineBlock
+//   frames ahead of the output: the first step() renders that much of the
+//   song into the convolver and a matching delay line for the dry signal,
+//   so the output lines up exactly, with no pre-delay. Such a render cannot
+//   be checkpointed.
+
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "audio/convolver.hpp"
+#include "audio/effects.hpp"
+#include "audio/schedule.hpp"
+#include "audio/synth.hpp"
+#include "common/snapshot.hpp"
+
+namespace audio {
+
+class OfflineRender {
+public:
+  // Render `events` plus `tailSec`, stopping early at `maxSec` (previews).
+  OfflineRender(const Synth &font, Schedule events, int sampleRate,
+                double tailSec = 1.0,
+                double maxSec = std::numeric_limits<double>::infinity());
+
+  // Convolve with `conv` (load_impulse_response(..., Mode::Offline)) in
+  // place of the FDN on the reverb bus, or with `onMaster` on the whole mix
+  // at `wet`, as audio::play does for --ir. Extends the render by the IR
+  // length. Call before the first step().
+  void set_convolution(std::unique_ptr<ConvolutionReverb> conv,
+                       bool onMaster = false, float wet = 0.3f);
+
+  // Render the next block; returns its frame count, 0 once finished.
+  int step();
+
+  [[nodiscard]] const float *block() const { return block_.data(); }
+  [[nodiscard]] int block_frames() const { return blockFrames_; }
+  [[nodiscard]] bool done() const { return pos_ >= frames_; }
+  [[nodiscard]] std::size_t position() const { return pos_; } // frames
+  [[nodiscard]] std::size_t frames() const { return frames_; } // total
+  [[nodiscard]] int sample_rate() const { return sampleRate_; }
+
+  // Checkpoint between blocks (common/snapshot.hpp). load_state throws
+  // std::runtime_error if the state belongs to another song or settings;
+  // both throw with a convolution reverb set.
+  void save_state(StateWriter &w) const;
+  void load_state(StateReader &r);
+
+private:
+  void render(float *out, int frames);
+
+  Synth synth_;
+  SendEffects fx_;
+  Schedule events_;
+  std::size_t next_ = 0; // next event to apply
+  int sampleRate_;
+  double tailSec_, maxSec_;
+  std::size_t pos_ = 0;
+  std::size_t synthPos_ = 0; // frames rendered: pos_ plus the IR latency
+  std::size_t frames_ = 0;
+  std::vector<float> block_; // kMaxBusFrames * 2
+  int blockFrames_ = 0;
+
+  std::unique_ptr<ConvolutionReverb> conv_;
+  bool convMaster_ = false;
+  float convWet_ = 0.0f;
+  std::vector<float> convIn_; // master input, kMaxBusFrames * 2
+  std::vector<float> dry_;    // delay line, latency_frames() * 2
+  std::size_t dryPos_ = 0;
+};
+
+} // namespace audio
@@ -2,18 +2,31 @@
 // Turn parsed MIDI into sound with TinySoundFont + miniaudio.
 // Blocking call: returns when the song (plus tail) has finished rendering.
 
-#define TSF_IMPLEMENTATION
 #define MINIAUDIO_IMPLEMENTATION
 #include "miniaudio.h"
-#include "tsf.h"
 
+#include "audio/convolver.hpp"
+#include "audio/driver.hpp"
+#include "audio/effects.hpp"
+#include "audio/event_stream.hpp"
+#include "audio/fork_join.hpp"
 #include "audio/player.hpp"
+#include "audio/schedule.hpp"
+#include "audio/simd.hpp"
+#include "audio/synth.hpp"
+#include "common/mem_account.hpp"
+#include "io/live_input.hpp"
+#include "midi/channel.hpp"
+#include "midi/note_index.hpp"
 #include "midi/tempo.hpp"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
-#include <chrono>
 #include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -21,100 +34,398 @@
 
 namespace {
 
-// A scheduled NoteOn/Off in seconds.
-struct ScheduledEvent {
-  double tSec;       // when to apply, in seconds
-  std::uint8_t ch;   // 0..15
-  std::uint8_t note; // 0..127
-  std::uint8_t vel;  // 0..127
-  bool on;           // true=NoteOn, false=NoteOff
+using audio::ScheduledEvent;
+
+// Every schedule and event stream in here comes from this one resource, so
+// take_splice() swaps their buffers instead of copying them.
+std::pmr::memory_resource *schedule_mem() {
+  return mem_resource(MemSubsystem::Schedule);
+}
+
+// One synth per MIDI port in use (meta 0x21): port p's channel c never
+// collides with another port's channel c. Multi-port songs render each port
+// into its own buffers, then sum.
+struct PortVoice {
+  audio::Synth *synth = nullptr;
+  std::vector<float> dry, reverb, chorus; // kMaxBusFrames * 2 (multi-port)
 };
 
-// Build a time-ordered event list from the song + tempo.
-std::vector<ScheduledEvent> build_schedule(const midi::Song &song,
-                                           const midi::TempoMap &tempo) {
-  std::vector<ScheduledEvent> evs;
-  evs.reserve(song.notes.size());
-  for (const auto &n : song.notes) {
-    const double t = midi::ticks_to_seconds(n.tick, tempo);
-    evs.push_back(
-        ScheduledEvent{t, n.ch, n.note, n.vel, n.type == midi::EvType::NoteOn});
-  }
-  // Sort by time; at identical time, do NoteOff before NoteOn (avoids hanging
-  // notes)
-  std::sort(evs.begin(), evs.end(),
-            [](const ScheduledEvent &a, const ScheduledEvent &b) {
-              if (a.tSec != b.tSec)
-                return a.tSec < b.tSec;
-              if (a.on != b.on)
-                return b.on; // false (Off) comes first
-              if (a.ch != b.ch)
-                return a.ch < b.ch;
-              return a.note < b.note;
-            });
-  return evs;
+// MIDI port -> port slot. Append-only: a port keeps its slot across
+// splices, so notes it started are released on the synth that plays them.
+struct PortMap {
+  std::array<std::uint8_t, 256> slot{}; // unused ports (and live input): 0
+  std::array<bool, 256> seen{};
+  std::size_t slots = 0; // slots handed out
+
+  // Give each port first used in `evs` the next slot, lowest port first;
+  // past kMaxPorts, further ports fold onto the last slot.
+  void add(const audio::Schedule &evs) {
+    std::array<bool, 256> used{};
+    for (const ScheduledEvent &e : evs)
+      used[e.port] = true;
+    for (std::size_t p = 0; p < used.size(); ++p) {
+      if (!used[p] || seen[p])
+        continue;
+      seen[p] = true;
+      slot[p] = static_cast<std::uint8_t>(
+          std::min(slots, audio::kMaxPorts - 1));
+      slots = std::min(slots + 1, audio::kMaxPorts);
+    }
+  }
+};
+
+// Hot reload bookkeeping: one bit per (port, channel, key).
+constexpr std::size_t kKeyBits = 256 * 16 * 128;
+constexpr std::size_t kKeyWords = kKeyBits / 64;
+constexpr std::size_t key_bit(int port, int ch, int key) {
+  return (std::size_t(port) * 16 + std::size_t(ch)) * 128 + std::size_t(key);
 }
+// Notes that start this soon after the prepare time count as sounding, so
+// a splice landing a callback later does not release them.
+constexpr double kSpliceWindowSec = 0.25;
+
+// Voices per port synth, allocated before the driver starts: tsf would
+// otherwise grow its voice array inside note_on on the audio thread.
+constexpr int kMaxVoicesPerPort = 256;
+
+// How often the waiting thread checks for the end, stop and reloads.
+constexpr double kPollSec = 0.03;
+
+// A new version of the song, prepared off the audio thread. The callback
+// swaps its buffers with the live ones, so the old schedule comes back in
+// this object and is freed by the waiting thread.
+struct Splice {
+  audio::Schedule events{schedule_mem()};
+  audio::EventStream stream{schedule_mem()};
+  bool compact = false;
+  double endTimeSec = 0.0;
+  double preparedAt = 0.0; // playhead when chase/sounding were taken
+  std::vector<ScheduledEvent> chase;   // controller state at preparedAt
+  std::vector<std::uint64_t> sounding; // kKeyWords; notes near preparedAt
+  std::array<std::uint8_t, 256> portSlot{}; // with this version's ports
+};
 
 // Shared playback state the audio thread uses.
 struct PlaybackState {
-  tsf *synth = nullptr;
-  std::vector<ScheduledEvent> events;
+  audio::Synth *synth = nullptr; // port slot 0; live input plays here too
+  std::vector<PortVoice> ports;  // slot -> synth (+ buffers if > 1 slot)
+  std::array<std::uint8_t, 256> portSlot{}; // MIDI port -> slot
+  std::vector<int> activePorts;  // callback scratch, capacity = ports
+  audio::ForkJoinPool *pool = nullptr; // renders ports in parallel
+  audio::SendEffects *fx = nullptr; // null = dry render
+  audio::ConvolutionReverb *master = nullptr; // optional master convolution
+  float masterWet = 0.0f;
+  std::vector<float> masterIn; // dry copy of the block, kMaxBusFrames * 2
+  audio::Schedule events{schedule_mem()};
   std::size_t nextIndex = 0; // next event to apply
+  // Compact mode: `events` is empty and the cursor walks `stream` instead.
+  audio::EventStream stream{schedule_mem()};
+  audio::EventStream::Cursor cursor;
+  bool compact = false;
   std::atomic<double> timeSec{0.0};
-  double endTimeSec = 0.0;
-  ma_uint32 sampleRate = 44100;
+  // Written by the callback on a splice, read by the waiting thread.
+  std::atomic<double> endTimeSec{0.0};
+  std::uint32_t sampleRate = 44100;
+  io::LiveInput *live = nullptr; // optional live source (runs until stopped)
+  // Hot reload: the waiting thread publishes `pending`, the callback takes
+  // it and hands it back through `retired`. `held` (kKeyWords, only with a
+  // reload source) tracks notes the schedule has switched on.
+  std::atomic<Splice *> pending{nullptr};
+  std::atomic<Splice *> retired{nullptr};
+  std::vector<std::uint64_t> held;
 };
 
-// Real-time callback: feed events up to t1, then render interleaved stereo s16.
-void data_callback(ma_device *device, void *pOutput, const void * /*pInput*/,
-                   ma_uint32 frameCount) {
-  auto *st = reinterpret_cast<PlaybackState *>(device->pUserData);
-  short *out = reinterpret_cast<short *>(pOutput);
+// Apply one live channel message to the synth.
+void apply_live(audio::Synth &synth, const midi::ChannelMsg &m) {
+  const int ch = m.status & 0x0F;
+  midi::NoteEv ev{};
+  if (midi::to_note_event(m.status, m.d1, m.d2, 0, ev)) {
+    if (ev.type == midi::EvType::NoteOn)
+      synth.note_on(ch, ev.note, ev.vel);
+    else
+      synth.note_off(ch, ev.note);
+    return;
+  }
+  switch (m.status & 0xF0) {
+  case 0xB0: // Control Change
+    synth.control(ch, m.d1, m.d2);
+    break;
+  case 0xC0: // Program Change
+    synth.program(ch, m.d1);
+    break;
+  case 0xE0: // Pitch Bend (14-bit, LSB first)
+    synth.pitch_bend(ch, m.d1 | (m.d2 << 7));
+    break;
+  default: // aftertouch / channel pressure: not modelled by tsf
+    break;
+  }
+}
+
+// Drain live events due before the end of this buffer; they all land on the
+// buffer's first frame.
+void drain_live(PlaybackState *st, double dt) {
+  const std::int64_t now = io::LiveInput::now_ns();
+  const std::int64_t horizon = now + static_cast<std::int64_t>(dt * 1e9);
+  auto &q = st->live->queue();
+  for (const io::LiveEvent *e = q.front(); e && e->dueNs <= horizon;
+       e = q.front()) {
+    apply_live(*st->synth, e->msg);
+    st->live->record_applied(*e, now);
+    q.pop();
+  }
+}
+
+void apply_event(PlaybackState *st, const ScheduledEvent &e) {
+  st->ports[st->portSlot[e.port]].synth->apply(e);
+  if (!st->held.empty() && e.kind != audio::EvKind::Control) {
+    const std::size_t b = key_bit(e.port, e.ch & 0x0F, e.data1 & 0x7F);
+    const std::uint64_t m = std::uint64_t(1) << (b % 64);
+    if (e.kind == audio::EvKind::NoteOn && e.data2 > 0)
+      st->held[b / 64] |= m;
+    else
+      st->held[b / 64] &= ~m;
+  }
+}
+
+// Swap in a prepared version at the playhead `now` (audio thread; no
+// allocation). Returns the new playhead: 0 when the old version had already
+// finished, so the new one plays from the top.
+double take_splice(PlaybackState *st, Splice *sp, double now) {
+  const double end = st->endTimeSec.load(std::memory_order_relaxed);
+  const bool restart = now >= end;
+  st->events.swap(sp->events);
+  std::swap(st->stream, sp->stream);
+  std::swap(st->compact, sp->compact);
+  st->endTimeSec.store(sp->endTimeSec, std::memory_order_relaxed);
+  if (st->compact)
+    st->cursor = audio::EventStream::Cursor(st->stream);
+  st->nextIndex = 0;
+  st->portSlot = sp->portSlot; // a superset of the old mapping
+  if (restart)
+    return 0.0;
+
+  // Release notes the new version does not have around the playhead.
+  for (std::size_t w = 0; w < kKeyWords; ++w) {
+    std::uint64_t gone = st->held[w] & ~sp->sounding[w];
+    st->held[w] &= ~gone;
+    for (; gone; gone &= gone - 1) {
+      const std::size_t b = w * 64 + std::size_t(__builtin_ctzll(gone));
+      const std::size_t port = b / (16 * 128);
+      st->ports[st->portSlot[port]].synth->note_off(int(b / 128 % 16),
+                                                    int(b % 128));
+    }
+  }
+  for (const ScheduledEvent &e : sp->chase)
+    apply_event(st, e);
+
+  // Resume after the prepare time. Events between it and the playhead apply
+  // now, except note-ons: the old version already played what was due.
+  const auto skip_or_apply = [st, now](const ScheduledEvent &e) {
+    if (e.tSec <= now && e.kind == audio::EvKind::NoteOn)
+      return;
+    apply_event(st, e);
+  };
+  if (st->compact) {
+    st->cursor.seek(sp->preparedAt);
+    while (!st->cursor.done() && st->cursor.time() <= sp->preparedAt)
+      st->cursor.next();
+    while (!st->cursor.done() && st->cursor.time() <= now)
+      skip_or_apply(st->cursor.next());
+  } else {
+    st->nextIndex = std::size_t(
+        std::upper_bound(st->events.begin(), st->events.end(),
+                         sp->preparedAt,
+                         [](double t, const ScheduledEvent &e) {
+                           return t < e.tSec;
+                         }) -
+        st->events.begin());
+    while (st->nextIndex < st->events.size() &&
+           st->events[st->nextIndex].tSec <= now)
+      skip_or_apply(st->events[st->nextIndex++]);
+  }
+  return now;
+}
+
+// ForkJoinPool job: render one active port into its own buffers.
+struct PortJob {
+  PlaybackState *st;
+  int frames;
+};
+void render_port(void *ctx, int i) {
+  const auto *job = static_cast<const PortJob *>(ctx);
+  PortVoice &p = job->st->ports[std::size_t(job->st->activePorts[i])];
+  const std::size_t n = std::size_t(job->frames);
+  if (job->st->fx) {
+    audio::simd::clear_stereo(p.reverb.data(), n);
+    audio::simd::clear_stereo(p.chorus.data(), n);
+    p.synth->render(p.dry.data(), p.reverb.data(), p.chorus.data(),
+                    job->frames);
+  } else {
+    p.synth->render(p.dry.data(), nullptr, nullptr, job->frames);
+  }
+}
 
-  const double t0 = st->timeSec.load(std::memory_order_relaxed);
+// Render all ports with voices (in parallel when there are several) and sum
+// them into `out` and the send buses.
+void render_ports(PlaybackState *st, float *out, int frames) {
+  st->activePorts.clear();
+  for (std::size_t i = 0; i < st->ports.size(); ++i) {
+    if (st->ports[i].synth->active_voices() > 0)
+      st->activePorts.push_back(static_cast<int>(i));
+  }
+  const int count = static_cast<int>(st->activePorts.size());
+  PortJob job{st, frames};
+  if (st->pool && count > 1) {
+    st->pool->run(count, render_port, &job);
+  } else {
+    for (int i = 0; i < count; ++i)
+      render_port(&job, i);
+  }
+
+  const std::size_t n = std::size_t(frames);
+  audio::simd::clear_stereo(out, n);
+  if (st->fx)
+    st->fx->clear(frames);
+  for (int slot : st->activePorts) {
+    const PortVoice &p = st->ports[std::size_t(slot)];
+    audio::simd::mix_stereo(out, p.dry.data(), n, 1.0f, 1.0f);
+    if (st->fx) {
+      audio::simd::mix_stereo(st->fx->reverb_bus(), p.reverb.data(), n, 1.0f,
+                              1.0f);
+      audio::simd::mix_stereo(st->fx->chorus_bus(), p.chorus.data(), n, 1.0f,
+                              1.0f);
+    }
+  }
+  if (st->fx)
+    st->fx->process(out, frames);
+}
+
+// Driver callback: in blocks of at most kMaxBusFrames, feed events up to
+// the block end, render dry + send buses, add the effect returns.
+// Output is interleaved stereo f32.
+void data_callback(void *user, float *out, std::uint32_t frameCount) {
+  auto *st = static_cast<PlaybackState *>(user);
+
+  double t0 = st->timeSec.load(std::memory_order_relaxed);
+  if (Splice *sp = st->pending.exchange(nullptr, std::memory_order_acquire)) {
+    t0 = take_splice(st, sp, t0);
+    st->retired.store(sp, std::memory_order_release);
+  }
   const double dt =
       static_cast<double>(frameCount) / static_cast<double>(st->sampleRate);
   const double t1 = t0 + dt;
 
-  // Apply all events that occur up to t1.
-  while (st->nextIndex < st->events.size() &&
-         st->events[st->nextIndex].tSec <= t1) {
-    const auto &e = st->events[st->nextIndex++];
-    if (e.on) {
-      // vel 0..127 -> 0..1 gain
-      tsf_note_on(st->synth, e.ch, e.note,
-                  (e.vel <= 127 ? e.vel : 127) / 127.0f);
+  if (st->live)
+    drain_live(st, dt);
+
+  double tBlock = t0;
+  for (std::uint32_t done = 0; done < frameCount;) {
+    const int n = static_cast<int>(
+        std::min<std::uint32_t>(frameCount - done, audio::kMaxBusFrames));
+    const double tEnd = tBlock + n / static_cast<double>(st->sampleRate);
+
+    // Apply all events that occur up to the end of this block.
+    if (st->compact) {
+      while (!st->cursor.done() && st->cursor.time() <= tEnd)
+        apply_event(st, st->cursor.next());
+    }
+    while (st->nextIndex < st->events.size() &&
+           st->events[st->nextIndex].tSec <= tEnd) {
+      apply_event(st, st->events[st->nextIndex++]);
+    }
+
+    float *blockOut = out + std::size_t(done) * 2;
+    if (st->ports.size() > 1) {
+      render_ports(st, blockOut, n);
+    } else if (st->fx) {
+      st->fx->clear(n);
+      st->synth->render(blockOut, st->fx->reverb_bus(), st->fx->chorus_bus(),
+                        n);
+      st->fx->process(blockOut, n);
     } else {
-      tsf_note_off(st->synth, e.ch, e.note);
+      st->synth->render(blockOut, nullptr, nullptr, n);
+    }
+    if (st->master) {
+      std::copy(blockOut, blockOut + std::size_t(n) * 2, st->masterIn.begin());
+      st->master->process(st->masterIn.data(), blockOut, n, st->masterWet);
     }
-  }
 
-  // Render audio for this buffer.
-  // TinySoundFont renders "frames * channels" samples for interleaved stereo.
-  tsf_render_short(st->synth, out, static_cast<int>(frameCount), 0);
+    done += static_cast<std::uint32_t>(n);
+    tBlock = tEnd;
+  }
 
   // Advance clock.
   st->timeSec.store(t1, std::memory_order_relaxed);
 
   // If we've passed the end + tail, we can fade quickly (optional, simple
   // ramp).
-  if (t1 >= st->endTimeSec) {
+  const double endTimeSec = st->endTimeSec.load(std::memory_order_relaxed);
+  if (!st->live && t1 >= endTimeSec) {
     // simple post-tail fade: multiply buffer to zero over last buffer
     // (kept tiny; real implementations would smooth more carefully)
-    const double tailLeft = std::max(0.0, st->endTimeSec - t0);
+    const double tailLeft = std::max(0.0, endTimeSec - t0);
     double scale = tailLeft / dt; // 1..0 across this callback
     if (scale < 0.0)
       scale = 0.0;
     const int samples = static_cast<int>(frameCount) * 2; // stereo interleaved
     for (int i = 0; i < samples; ++i) {
-      out[i] = static_cast<short>(out[i] * scale);
+      out[i] = static_cast<float>(out[i] * scale);
     }
   }
 }
 
-inline void ensure(bool cond, const char *msg) {
-  if (!cond)
-    throw std::runtime_error(msg);
+// Prepare a new version for a splice at playhead `now` (waiting thread). An
+// incomplete version (a stream still arriving) never ends on its own. Ports
+// it uses for the first time get slots from `ports`; their synths already
+// exist (play() makes kMaxPorts of them for a reload source).
+std::unique_ptr<Splice> prepare_splice(const midi::Song &song,
+                                       const midi::TempoMap &tempo, double now,
+                                       bool compact, bool complete,
+                                       double tailSec, PortMap &ports) {
+  auto sp = std::make_unique<Splice>();
+  sp->events = audio::build_schedule(song, tempo, schedule_mem());
+  ports.add(sp->events);
+  sp->portSlot = ports.slot;
+  sp->endTimeSec =
+      complete ? (sp->events.empty() ? 0.0 : sp->events.back().tSec) + tailSec
+               : std::numeric_limits<double>::infinity();
+  sp->preparedAt = now;
+
+  // Controller chase: the last value of each (port, ch, cc) up to now, in
+  // schedule order. Channel mode messages (CC120+) stay out: replaying an
+  // all-notes-off would cut the notes we keep.
+  std::vector<std::uint64_t> seen(kKeyWords, 0);
+  const auto upto = std::upper_bound(
+      sp->events.begin(), sp->events.end(), now,
+      [](double t, const ScheduledEvent &e) { return t < e.tSec; });
+  for (auto it = upto; it != sp->events.begin();) {
+    const ScheduledEvent &e = *--it;
+    if (e.kind != audio::EvKind::Control || e.data1 >= 120)
+      continue;
+    const std::size_t b = key_bit(e.port, e.ch & 0x0F, e.data1);
+    if (seen[b / 64] & (std::uint64_t(1) << (b % 64)))
+      continue;
+    seen[b / 64] |= std::uint64_t(1) << (b % 64);
+    sp->chase.push_back(e);
+  }
+  std::reverse(sp->chase.begin(), sp->chase.end());
+
+  sp->sounding.assign(kKeyWords, 0);
+  const midi::NoteIndex notes(song);
+  const auto a = static_cast<std::uint32_t>(midi::seconds_to_ticks(now, tempo));
+  const auto b = static_cast<std::uint32_t>(
+      midi::seconds_to_ticks(now + kSpliceWindowSec, tempo) + 1.0);
+  notes.for_each_in(a, b, [&](const midi::Note &n) {
+    const std::size_t bit = key_bit(n.port, n.ch, n.key);
+    sp->sounding[bit / 64] |= std::uint64_t(1) << (bit % 64);
+  });
+
+  if (compact || sp->events.size() > audio::kCompactEventsAbove) {
+    sp->stream = audio::EventStream(sp->events, schedule_mem());
+    audio::Schedule(schedule_mem()).swap(sp->events);
+    sp->compact = true;
+  }
+  return sp;
 }
 
 } // namespace
@@ -122,76 +433,148 @@ inline void ensure(bool cond, const char *msg) {
 namespace audio {
 
 void play(const midi::Song &song, const midi::TempoMap &tempo,
-          const std::filesystem::path &sf2Path) {
+          const std::filesystem::path &sf2Path, const PlayOptions &opts) {
   // --- Build schedule & compute duration ---
-  std::vector<ScheduledEvent> evs = build_schedule(song, tempo);
+  audio::Schedule evs = build_schedule(song, tempo, schedule_mem());
   double durationSec = 0.0;
   if (!evs.empty())
     durationSec = evs.back().tSec;
-  const double tailSec = 2.0; // let reverb/decay ring out a moment
-
-  // --- Init TinySoundFont ---
-  tsf *synth = tsf_load_filename(sf2Path.string().c_str());
-  ensure(synth != nullptr, "Failed to load SoundFont (.sf2)");
+  double tailSec = 2.0; // let reverb/decay ring out a moment
 
-  const ma_uint32 sampleRate = 44100; // safe, common default
-  tsf_set_output(synth, TSF_STEREO_INTERLEAVED, static_cast<int>(sampleRate),
-                 0.0f);
-  tsf_set_volume(synth, 0.8f); // modest headroom
+  // --- Init TinySoundFont (GM piano everywhere, drums on ch10) ---
+  const std::uint32_t sampleRate = 44100; // safe, common default
+  Synth synth(sf2Path, static_cast<int>(sampleRate));
+  synth.set_interpolation(opts.interp);
+  if (opts.mipmaps)
+    synth.enable_mipmaps();
 
-  // For now, set every channel to GM1 Acoustic Grand (program 0).
-  // Later we can parse Program Change messages and set per-channel presets.
-  for (int ch = 0; ch < 16; ++ch) {
-    tsf_channel_set_presetnumber(synth, ch, 0 /*Acoustic Grand*/,
-                                 true /*drums auto on ch10*/);
+  // Extra ports get share()d copies (samples and pyramid loaded once); the
+  // lowest port used plays on the main synth. A later version may use new
+  // ports, so with a reload source every slot gets its synth up front:
+  // share() is not something to call on the audio thread.
+  PortMap portMap;
+  portMap.add(evs);
+  const std::size_t slots = opts.reload ? kMaxPorts : portMap.slots;
+  std::vector<std::unique_ptr<Synth>> extraPorts;
+  PlaybackState state;
+  state.portSlot = portMap.slot;
+  state.ports.push_back(PortVoice{&synth, {}, {}, {}});
+  while (state.ports.size() < slots) {
+    extraPorts.push_back(std::make_unique<Synth>(synth.share()));
+    state.ports.push_back(PortVoice{extraPorts.back().get(), {}, {}, {}});
+  }
+  for (PortVoice &p : state.ports)
+    p.synth->set_max_voices(kMaxVoicesPerPort); // no allocs in callback
+  std::unique_ptr<ForkJoinPool> pool;
+  if (state.ports.size() > 1) {
+    for (PortVoice &p : state.ports) {
+      p.dry.assign(std::size_t(kMaxBusFrames) * 2, 0.0f);
+      p.reverb.assign(p.dry.size(), 0.0f);
+      p.chorus.assign(p.dry.size(), 0.0f);
+    }
+    state.activePorts.reserve(state.ports.size());
+    const int hw = static_cast<int>(std::thread::hardware_concurrency());
+    const int workers =
+        std::min(static_cast<int>(state.ports.size()), std::max(hw, 1)) - 1;
+    if (workers > 0)
+      pool = std::make_unique<ForkJoinPool>(workers);
+    state.pool = pool.get();
   }
 
-  // --- Miniaudio device setup ---
-  ma_device_config config = ma_device_config_init(ma_device_type_playback);
-  config.playback.format = ma_format_s16; // matches tsf_render_short
-  config.playback.channels = 2;           // stereo
-  config.sampleRate = sampleRate;
-  config.dataCallback = data_callback;
+  // One reverb + one chorus for the whole song, fed by CC91/CC93.
+  std::unique_ptr<SendEffects> fx;
+  if (opts.sendEffects)
+    fx = std::make_unique<SendEffects>(static_cast<int>(sampleRate));
 
-  PlaybackState state;
-  state.synth = synth;
+  // Convolution reverb: on the reverb bus (replacing the FDN) or the master.
+  std::unique_ptr<ConvolutionReverb> master;
+  if (!opts.impulseResponse.empty()) {
+    auto conv = load_impulse_response(opts.impulseResponse,
+                                      static_cast<int>(sampleRate));
+    tailSec = std::max(tailSec, double(conv->ir_frames()) / sampleRate);
+    if (opts.irOnMaster || !fx)
+      master = std::move(conv);
+    else
+      fx->set_convolution(std::move(conv));
+  }
+
+  state.synth = &synth;
+  state.fx = fx.get();
+  state.master = master.get();
+  state.masterWet = opts.irWet;
+  if (master)
+    state.masterIn.assign(std::size_t(kMaxBusFrames) * 2, 0.0f);
+  if (opts.compactEvents || evs.size() > kCompactEventsAbove) {
+    state.stream = EventStream(evs, schedule_mem());
+    state.cursor = EventStream::Cursor(state.stream);
+    state.compact = true;
+    Schedule(schedule_mem()).swap(evs); // release the expanded records
+  }
   state.events = std::move(evs);
   state.nextIndex = 0;
   state.timeSec = 0.0;
-  state.endTimeSec = durationSec + tailSec;
+  state.endTimeSec = opts.reload && !opts.reload->complete()
+                         ? std::numeric_limits<double>::infinity()
+                         : durationSec + tailSec;
   state.sampleRate = sampleRate;
-  config.pUserData = &state;
+  state.live = opts.live;
+  if (opts.reload)
+    state.held.assign(kKeyWords, 0);
 
-  ma_device device;
-  if (ma_device_init(nullptr, &config, &device) != MA_SUCCESS) {
-    tsf_close(synth);
-    throw std::runtime_error("Failed to open playback device");
+  // --- Output: the playback device unless the caller brought a driver ---
+  std::unique_ptr<Driver> device;
+  Driver *driver = opts.driver;
+  if (!driver) {
+    device = std::make_unique<DeviceDriver>();
+    driver = device.get();
   }
-
-  // Start streaming.
-  if (ma_device_start(&device) != MA_SUCCESS) {
-    ma_device_uninit(&device);
-    tsf_close(synth);
-    throw std::runtime_error("Failed to start playback device");
+  driver->start(static_cast<int>(sampleRate), data_callback, &state);
+  if (opts.live) {
+    // Everything after the callback is output buffering.
+    opts.live->set_output_latency_ns(
+        static_cast<std::int64_t>(driver->output_latency_sec() * 1e9));
   }
 
   // --- Block until done ---
-  // We'll poll the audio-time clock; it advances only inside the callback.
-  const auto start = std::chrono::steady_clock::now();
-  while (state.timeSec.load(std::memory_order_relaxed) < state.endTimeSec) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(30));
-    // Optional safety: break if wall clock is wildly longer than expected.
-    const auto elapsed =
-        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
-            .count();
-    if (elapsed > state.endTimeSec + 10.0)
+  // We'll poll the audio-time clock; it advances only inside the callback,
+  // which the driver runs while we wait() on it.
+  // Live and watch modes have no natural end: run until the caller raises
+  // opts.stop, splicing in new versions of the song as they arrive.
+  const bool untilStopped = opts.live || opts.reload;
+  std::unique_ptr<Splice> inflight; // published, not yet handed back
+  while (untilStopped &&
+         !(opts.stop && opts.stop->load(std::memory_order_relaxed))) {
+    driver->wait(kPollSec);
+    if (!opts.reload)
+      continue;
+    if (inflight && state.retired.exchange(nullptr, std::memory_order_acquire))
+      inflight.reset(); // frees the previous version's schedule
+    const midi::Song *nextSong = nullptr;
+    const midi::TempoMap *nextTempo = nullptr;
+    if (!inflight && opts.reload->poll(nextSong, nextTempo)) {
+      inflight = prepare_splice(*nextSong, *nextTempo,
+                                state.timeSec.load(std::memory_order_relaxed),
+                                opts.compactEvents, opts.reload->complete(),
+                                tailSec, portMap);
+      state.pending.store(inflight.get(), std::memory_order_release);
+    }
+    // A finished source (end of a stream) ends playback with the song.
+    if (!opts.live && !inflight && opts.reload->finished() &&
+        state.timeSec.load(std::memory_order_relaxed) >= state.endTimeSec)
+      break;
+  }
+  while (!untilStopped &&
+         state.timeSec.load(std::memory_order_relaxed) < state.endTimeSec) {
+    driver->wait(kPollSec);
+    // Optional safety: break if the driver clock is wildly past the end.
+    if (driver->now_sec() > state.endTimeSec + 10.0)
       break; // sanity escape
   }
 
   // Stop and clean up.
-  ma_device_stop(&device);
-  ma_device_uninit(&device);
-  tsf_close(synth);
+  driver->stop();
+  if (opts.memReport)
+    print_mem_report(std::cout);
 }
 
 } // namespace audio
@@ -5,6 +5,7 @@
 //
 // Public API (one function):
 //   audio::play(song, tempo, sf2Path);
+//   audio::play(song, tempo, sf2Path, opts);   // with PlayOptions
 //
 // Design notes:
 // - We keep the implementation behind this interface so main.cpp stays tiny.
@@ -13,18 +14,109 @@
 // - First cut: GM "piano on every channel". Program Changes are ignored for
 // now;
 //   we can parse/program-map later without touching this header.
+// - Rendering is float: dry mix plus one shared reverb and chorus bus
+//   (CC91/CC93 sends), see audio/synth.hpp and audio/effects.hpp.
+// - An optional convolution reverb runs on the reverb bus or on the master
+//   mix; its background tail thread lives as long as play() runs.
+// - Songs that address several MIDI ports (meta 0x21) get one synth per port
+//   (share()d, so samples load once). Ports with sounding voices render in
+//   parallel on a fork-join pool (audio/fork_join.hpp) and are summed.
+// - Output goes through a Driver (audio/driver.hpp): the device by default,
+//   or a null / simulated one, so timing can be exercised without hardware
+//   and, simulated, without waiting in real time.
+// - Hot reload swaps the schedule between two callback blocks: the new
+//   version is prepared on the waiting thread (schedule, controller chase,
+//   notes sounding at the playhead) and handed over through an atomic
+//   pointer, so the callback only swaps buffers and releases notes the new
+//   version no longer has.
 
 #pragma once
+#include <atomic>
+#include <cstddef>
 #include <filesystem>
 
+#include "audio/driver.hpp"
+#include "audio/interp.hpp"
 #include "midi/events.hpp"
 #include "midi/tempo.hpp"
 
+namespace io {
+class LiveInput;
+}
+
 namespace audio {
 
+// Hot reload (--watch): play() polls this from its wait loop and splices each
+// new version of the song in at the playhead, without restarting the device.
+class ReloadSource {
+public:
+  virtual ~ReloadSource() = default;
+  // Return true and point song/tempo at a new version when one is ready; the
+  // pointees must stay valid until the next call.
+  virtual bool poll(const midi::Song *&song, const midi::TempoMap *&tempo) = 0;
+  // False while the current version may still grow (a stream before EOF):
+  // playback then waits past its last event instead of fading out.
+  virtual bool complete() const { return true; }
+  // True once no further versions will come: play() then returns when the
+  // song ends, unless live input keeps it running.
+  virtual bool finished() const { return false; }
+};
+
+// Optional knobs for play(); defaults reproduce plain file playback.
+struct PlayOptions {
+  // Live events from another process, mixed into the same synth. With a live
+  // source, play() keeps running after the song ends until *stop is true.
+  io::LiveInput *live = nullptr;
+  const std::atomic<bool> *stop = nullptr;
+
+  // New versions of the song to splice in while playing. Like a live source,
+  // it keeps play() running until *stop (or until it is finished()); a
+  // complete version arriving after the song ended plays from the top. All
+  // kMaxPorts port synths are made up front, so MIDI ports first used by a
+  // later version get their own synth too.
+  ReloadSource *reload = nullptr;
+
+  // Shared reverb/chorus buses driven by CC91/CC93 (see audio/effects.hpp).
+  bool sendEffects = true;
+
+  // Convolution reverb from a WAV impulse response (audio/convolver.hpp).
+  // By default it replaces the FDN on the reverb send bus; with irOnMaster it
+  // is applied to the whole mix instead (irWet = return level).
+  std::filesystem::path impulseResponse;
+  bool irOnMaster = false;
+  float irWet = 0.3f;
+
+  // Sample interpolation; cubic fits the real-time budget with headroom,
+  // sinc8/sinc16 are meant for offline renders (see measure_interp_cost).
+  Interp interp = Interp::Cubic;
+
+  // Band-limited octave pyramids for notes far above their root key
+  // (audio/mipmap.hpp); built on first use of a font, then cached on disk.
+  bool mipmaps = true;
+
+  // Keep the schedule as a delta-encoded byte stream (audio/event_stream.hpp)
+  // instead of 16-byte records. Songs above kCompactEventsAbove events use
+  // it regardless.
+  bool compactEvents = false;
+
+  // Print the per-subsystem memory report (common/mem_account.hpp) when
+  // playback ends, while the synth and schedule are still alive.
+  bool memReport = false;
+
+  // Output and clock (audio/driver.hpp); null opens the playback device.
+  // A SimulatedDriver renders the whole song at full speed.
+  Driver *driver = nullptr;
+};
+
+constexpr std::size_t kCompactEventsAbove = std::size_t(1) << 20;
+
+// Distinct MIDI ports (meta 0x21) that get their own synth, 16 channels each;
+// further ports share the last one.
+constexpr std::size_t kMaxPorts = 8;
+
 // Blocking playback. Throws std::runtime_error on device or SF2 errors.
 // This function only returns after playback completes (or on error).
 void play(const midi::Song &song, const midi::TempoMap &tempo,
-          const std::filesystem::path &sf2Path);
+          const std::filesystem::path &sf2Path, const PlayOptions &opts = {});
 
 } // namespace audio
@@ -0,0 +1,163 @@
+// src/audio/render_cost.cpp
+// Per-preset and per-channel render cost tables and the ranked report.
+
+#include "audio/render_cost.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+
+namespace audio {
+
+namespace detail {
+std::atomic<bool> g_costOn{false};
+}
+
+namespace {
+
+struct CostRow {
+  std::atomic<std::uint64_t> ticks{0}, voiceFrames{0}, noteOns{0}, voices{0};
+};
+CostRow g_presets[kCostPresets];
+CostRow g_channels[kCostChannels];
+
+std::mutex g_namesMutex;
+std::vector<PresetName> g_names;
+
+std::size_t preset_row(int preset) {
+  return std::min(std::size_t(preset < 0 ? 0 : preset), kCostPresets - 1);
+}
+
+CostTotals load(const CostRow &r) {
+  CostTotals t;
+  t.ticks = r.ticks.load(std::memory_order_relaxed);
+  t.voiceFrames = r.voiceFrames.load(std::memory_order_relaxed);
+  t.noteOns = r.noteOns.load(std::memory_order_relaxed);
+  t.voices = r.voices.load(std::memory_order_relaxed);
+  return t;
+}
+
+struct Ranked {
+  int index;
+  CostTotals t;
+};
+
+// Rank rows with any activity by render time, heaviest first.
+std::vector<Ranked> ranked(const CostRow *rows, std::size_t n) {
+  std::vector<Ranked> out;
+  for (std::size_t i = 0; i < n; ++i) {
+    const CostTotals t = load(rows[i]);
+    if (t.ticks || t.noteOns)
+      out.push_back({int(i), t});
+  }
+  std::stable_sort(out.begin(), out.end(),
+                   [](const Ranked &a, const Ranked &b) {
+                     return a.t.ticks > b.t.ticks;
+                   });
+  return out;
+}
+
+void print_header(std::ostream &os, const char *first) {
+  os << "  " << std::left << std::setw(30) << first << std::right
+     << std::setw(10) << "M" + std::string(cost_unit()) << std::setw(7)
+     << "share" << std::setw(13) << "per v-frame" << std::setw(9)
+     << "note-ons" << std::setw(8) << "v/on" << "\n";
+}
+
+void print_row(std::ostream &os, const CostTotals &t, std::uint64_t total) {
+  const double share = total ? 100.0 * double(t.ticks) / double(total) : 0.0;
+  const double perFrame =
+      t.voiceFrames ? double(t.ticks) / double(t.voiceFrames) : 0.0;
+  const double perNote = t.noteOns ? double(t.voices) / double(t.noteOns) : 0;
+  os << std::setw(10) << std::setprecision(2) << double(t.ticks) / 1e6
+     << std::setw(7) << std::setprecision(1) << share << std::setw(13)
+     << std::setprecision(1) << perFrame << std::setw(9) << t.noteOns
+     << std::setw(8) << std::setprecision(2) << perNote << "\n";
+}
+
+} // namespace
+
+void cost_enable() { detail::g_costOn.store(true); }
+void cost_disable() { detail::g_costOn.store(false); }
+
+const char *cost_unit() {
+#if defined(__x86_64__) || defined(__i386__)
+  return "cycles";
+#else
+  return "ns";
+#endif
+}
+
+void cost_name_presets(std::vector<PresetName> names) {
+  std::lock_guard<std::mutex> lock(g_namesMutex);
+  g_names = std::move(names);
+}
+
+void cost_add_render(int preset, int channel, std::uint64_t ticks,
+                     std::uint64_t frames) {
+  CostRow &p = g_presets[preset_row(preset)];
+  CostRow &c = g_channels[std::size_t(channel) & (kCostChannels - 1)];
+  p.ticks.fetch_add(ticks, std::memory_order_relaxed);
+  p.voiceFrames.fetch_add(frames, std::memory_order_relaxed);
+  c.ticks.fetch_add(ticks, std::memory_order_relaxed);
+  c.voiceFrames.fetch_add(frames, std::memory_order_relaxed);
+}
+
+void cost_add_note_on(int preset, int channel, int voices) {
+  CostRow &p = g_presets[preset_row(preset)];
+  CostRow &c = g_channels[std::size_t(channel) & (kCostChannels - 1)];
+  p.noteOns.fetch_add(1, std::memory_order_relaxed);
+  p.voices.fetch_add(std::uint64_t(voices), std::memory_order_relaxed);
+  c.noteOns.fetch_add(1, std::memory_order_relaxed);
+  c.voices.fetch_add(std::uint64_t(voices), std::memory_order_relaxed);
+}
+
+CostTotals cost_preset_totals(int preset) {
+  return load(g_presets[preset_row(preset)]);
+}
+
+CostTotals cost_channel_totals(int channel) {
+  return load(g_channels[std::size_t(channel) & (kCostChannels - 1)]);
+}
+
+void print_cost_report(std::ostream &os, std::size_t top) {
+  const std::vector<Ranked> presets = ranked(g_presets, kCostPresets);
+  const std::vector<Ranked> channels = ranked(g_channels, kCostChannels);
+  std::uint64_t total = 0;
+  for (const Ranked &r : channels)
+    total += r.t.ticks;
+
+  const auto flags = os.flags();
+  os << std::fixed << "Render cost by preset (" << cost_unit()
+     << " per voice-frame; voices per note-on):\n";
+  print_header(os, "bank:prog name");
+  std::lock_guard<std::mutex> lock(g_namesMutex);
+  for (std::size_t i = 0; i < presets.size() && i < top; ++i) {
+    const Ranked &r = presets[i];
+    const bool named = std::size_t(r.index) < g_names.size();
+    std::string label = named ? g_names[std::size_t(r.index)].name
+                              : "#" + std::to_string(r.index);
+    if (named) {
+      const PresetName &n = g_names[std::size_t(r.index)];
+      label = std::to_string(n.bank) + ":" + std::to_string(n.program) + " " +
+              label;
+    }
+    os << "  " << std::left << std::setw(30) << label.substr(0, 29)
+       << std::right;
+    print_row(os, r.t, total);
+  }
+  if (presets.size() > top)
+    os << "  (" << presets.size() - top << " more presets)\n";
+
+  os << "Render cost by MIDI channel:\n";
+  print_header(os, "channel");
+  for (const Ranked &r : channels) {
+    os << "  " << std::left << std::setw(30)
+       << std::to_string(r.index + 1) + (r.index == 9 ? " (drums)" : "")
+       << std::right;
+    print_row(os, r.t, total);
+  }
+  os.flags(flags);
+}
+
+} // namespace audio
@@ -0,0 +1,93 @@
+// src/audio/render_cost.hpp
+// Where the render time goes (--cost-report): voice-render cycles
+// attributed to the preset and the MIDI channel each voice plays, plus how
+// many voices each note-on starts, as ranked tables.
+//
+//   audio::cost_enable();                 // before playback
+//   audio::play(song, tempo, sf2Path);    // Synth counts as it renders
+//   audio::print_cost_report(std::cout);  // heaviest presets/channels first
+//
+// Design notes:
+// - Synth reads the time stamp counter (rdtsc) around every voice's render
+//   call in a block and adds the difference to that voice's preset and
+//   channel. One pair of reads per voice per block (up to 1024 frames),
+//   so the overhead stays far below the voice's own cost. Other CPUs fall
+//   back to steady_clock nanoseconds; cost_unit() says which.
+// - Totals are relaxed atomics in fixed tables (kCostPresets presets, 16
+//   channels): no allocation or locks on the audio thread, and ports that
+//   render in parallel add up. All ports share the 16 channel rows.
+// - Presets are keyed by their index in the font and named by the font that
+//   was loaded last (the player loads one). Indexes past kCostPresets share
+//   the last row.
+// - Disabled, the cost is one relaxed load per render block and note-on.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace audio {
+
+constexpr std::size_t kCostPresets = 1024;
+constexpr std::size_t kCostChannels = 16;
+
+struct PresetName {
+  std::string name;
+  int bank = 0;
+  int program = 0;
+};
+
+struct CostTotals {
+  std::uint64_t ticks = 0;       // render time, see cost_unit()
+  std::uint64_t voiceFrames = 0; // frames rendered, summed over voices
+  std::uint64_t noteOns = 0;     // note-ons that started at least one voice
+  std::uint64_t voices = 0;      // voices those note-ons started
+};
+
+namespace detail {
+extern std::atomic<bool> g_costOn;
+}
+
+void cost_enable();
+void cost_disable(); // the totals are kept
+inline bool cost_enabled() {
+  return detail::g_costOn.load(std::memory_order_relaxed);
+}
+
+// Time stamp for cost_add_render(): TSC ticks on x86, else nanoseconds.
+inline std::uint64_t cost_clock() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count());
+#endif
+}
+const char *cost_unit(); // "cycles" or "ns"
+
+// Names for preset indexes, in font order (called when a font is loaded).
+void cost_name_presets(std::vector<PresetName> names);
+
+// Audio thread: one voice rendered `frames` frames in `ticks`.
+void cost_add_render(int preset, int channel, std::uint64_t ticks,
+                     std::uint64_t frames);
+// Audio thread: a note-on on `channel` started `voices` voices of `preset`.
+void cost_add_note_on(int preset, int channel, int voices);
+
+CostTotals cost_preset_totals(int preset);
+CostTotals cost_channel_totals(int channel);
+
+// Presets and channels ranked by render time, with their share of the total,
+// time per voice-frame and voices per note-on. At most `top` presets.
+void print_cost_report(std::ostream &os, std::size_t top = 20);
+
+} // namespace audio
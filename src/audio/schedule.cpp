@@ -0,0 +1,48 @@
+// src/audio/schedule.cpp
+// Song + TempoMap -> sorted ScheduledEvent list.
+
+#include "audio/schedule.hpp"
+#include "io/perf_counters.hpp"
+
+#include <algorithm>
+
+namespace audio {
+
+Schedule build_schedule(const midi::Song &song, const midi::TempoMap &tempo,
+                        std::pmr::memory_resource *mr) {
+  io::PerfScope perf(io::PerfStage::Schedule);
+  Schedule evs(mr);
+  evs.reserve(song.notes.size() + song.ctrls.size());
+  for (const auto &n : song.notes) {
+    const double t = midi::ticks_to_seconds(n.tick, tempo);
+    evs.push_back(ScheduledEvent{
+        t, n.ch, n.note, n.vel,
+        n.type == midi::EvType::NoteOn ? EvKind::NoteOn : EvKind::NoteOff,
+        n.port});
+  }
+  for (const auto &c : song.ctrls) {
+    const double t = midi::ticks_to_seconds(c.tick, tempo);
+    evs.push_back(
+        ScheduledEvent{t, c.ch, c.cc, c.value, EvKind::Control, c.port});
+  }
+  // Sort by time; at identical time, Control < NoteOff < NoteOn (avoids
+  // hanging notes). Stable so controllers keep their file order.
+  std::stable_sort(evs.begin(), evs.end(),
+                   [](const ScheduledEvent &a, const ScheduledEvent &b) {
+                     if (a.tSec != b.tSec)
+                       return a.tSec < b.tSec;
+                     if (a.kind != b.kind)
+                       return a.kind < b.kind;
+                     if (a.kind == EvKind::Control)
+                       return false; // keep file order
+                     if (a.port != b.port)
+                       return a.port < b.port;
+                     if (a.ch != b.ch)
+                       return a.ch < b.ch;
+                     return a.data1 < b.data1;
+                   });
+  perf.set_units(evs.size());
+  return evs;
+}
+
+} // namespace audio
@@ -0,0 +1,44 @@
+// src/audio/schedule.hpp
+// Flatten a parsed Song into a time-ordered list of synth events (seconds).
+// Shared by every playback front-end (single-song player, mixer sessions).
+//
+// Design notes:
+// - Times are precomputed once via the TempoMap so the audio thread only
+//   compares doubles; it never touches ticks or tempo segments.
+// - Ordering at identical times is Control, then NoteOff, then NoteOn:
+//   controllers (volume, sends) are in place before the notes they affect,
+//   and a repeated note on the same key does not cut itself off.
+// - Schedule is a std::pmr::vector: batch tools pass a per-file arena
+//   (common/arena.hpp); players use the default heap.
+
+#pragma once
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "midi/events.hpp"
+#include "midi/tempo.hpp"
+
+namespace audio {
+
+// Event kinds, declared in their tie-break order.
+enum class EvKind : std::uint8_t { Control, NoteOff, NoteOn };
+
+// A scheduled channel event in seconds.
+struct ScheduledEvent {
+  double tSec;        // when to apply, in seconds
+  std::uint8_t ch;    // 0..15
+  std::uint8_t data1; // note number, or controller number
+  std::uint8_t data2; // velocity, or controller value
+  EvKind kind;
+  std::uint8_t port = 0; // MIDI port (meta 0x21); each port has 16 channels
+};
+
+using Schedule = std::pmr::vector<ScheduledEvent>;
+
+// Build a time-ordered event list from the song + tempo, allocated from mr.
+Schedule build_schedule(
+    const midi::Song &song, const midi::TempoMap &tempo,
+    std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+} // namespace audio
@@ -0,0 +1,150 @@
+// src/audio/simd.hpp
+// Small vectorized buffer kernels for the mixing stages.
+// - SSE2 on x86-64 (always available there), NEON on AArch64, scalar elsewhere.
+// - All buffers are interleaved stereo float (L R L R ...), unaligned is fine.
+//
+// Design notes:
+// - Header-only so the compiler can inline them into the callback loops.
+// - F32x4 is a tiny 4-lane wrapper for kernels that vectorize across parallel
+//   lines or taps (FDN delay lines, chorus taps) instead of across time.
+// - The scalar tail handles frame counts that are not a multiple of the
+//   vector width; callers never need to pad.
+
+#pragma once
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AUDIO_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUDIO_SIMD_NEON 1
+#endif
+
+namespace audio::simd {
+
+// dst[i] = 0 for frames * 2 samples.
+inline void clear_stereo(float *dst, std::size_t frames) {
+  const std::size_t n = frames * 2;
+  std::size_t i = 0;
+#if defined(AUDIO_SIMD_SSE2)
+  const __m128 z = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, z);
+#elif defined(AUDIO_SIMD_NEON)
+  const float32x4_t z = vdupq_n_f32(0.0f);
+  for (; i + 4 <= n; i += 4)
+    vst1q_f32(dst + i, z);
+#endif
+  for (; i < n; ++i)
+    dst[i] = 0.0f;
+}
+
+// dst += src * (gainL, gainR), interleaved stereo.
+// One vector holds two frames, so the gain vector is (gL, gR, gL, gR).
+inline void mix_stereo(float *dst, const float *src, std::size_t frames,
+                       float gainL, float gainR) {
+  const std::size_t n = frames * 2;
+  std::size_t i = 0;
+#if defined(AUDIO_SIMD_SSE2)
+  const __m128 g = _mm_setr_ps(gainL, gainR, gainL, gainR);
+  for (; i + 8 <= n; i += 8) {
+    __m128 a0 = _mm_loadu_ps(dst + i), a1 = _mm_loadu_ps(dst + i + 4);
+    __m128 b0 = _mm_loadu_ps(src + i), b1 = _mm_loadu_ps(src + i + 4);
+    _mm_storeu_ps(dst + i, _mm_add_ps(a0, _mm_mul_ps(b0, g)));
+    _mm_storeu_ps(dst + i + 4, _mm_add_ps(a1, _mm_mul_ps(b1, g)));
+  }
+#elif defined(AUDIO_SIMD_NEON)
+  const float gv[4] = {gainL, gainR, gainL, gainR};
+  const float32x4_t g = vld1q_f32(gv);
+  for (; i + 4 <= n; i += 4)
+    vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+#endif
+  for (; i < n; i += 2) {
+    dst[i] += src[i] * gainL;
+    dst[i + 1] += src[i + 1] * gainR;
+  }
+}
+
+// Hard clip to [-1, 1] in place (final stage before the device).
+inline void clip_stereo(float *buf, std::size_t frames) {
+  const std::size_t n = frames * 2;
+  std::size_t i = 0;
+#if defined(AUDIO_SIMD_SSE2)
+  const __m128 lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f);
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(buf + i,
+                  _mm_min_ps(hi, _mm_max_ps(lo, _mm_loadu_ps(buf + i))));
+#elif defined(AUDIO_SIMD_NEON)
+  const float32x4_t lo = vdupq_n_f32(-1.0f), hi = vdupq_n_f32(1.0f);
+  for (; i + 4 <= n; i += 4)
+    vst1q_f32(buf + i, vminq_f32(hi, vmaxq_f32(lo, vld1q_f32(buf + i))));
+#endif
+  for (; i < n; ++i)
+    buf[i] = buf[i] < -1.0f ? -1.0f : (buf[i] > 1.0f ? 1.0f : buf[i]);
+}
+
+// --- 4-lane float vector -------------------------------------------------
+
+struct F32x4 {
+#if defined(AUDIO_SIMD_SSE2)
+  __m128 v;
+#elif defined(AUDIO_SIMD_NEON)
+  float32x4_t v;
+#else
+  float v[4];
+#endif
+};
+
+#if defined(AUDIO_SIMD_SSE2)
+inline F32x4 load4(const float *p) { return {_mm_loadu_ps(p)}; }
+inline void store4(float *p, F32x4 a) { _mm_storeu_ps(p, a.v); }
+inline F32x4 splat4(float x) { return {_mm_set1_ps(x)}; }
+inline F32x4 operator+(F32x4 a, F32x4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline F32x4 operator-(F32x4 a, F32x4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline F32x4 operator*(F32x4 a, F32x4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline F32x4 abs4(F32x4 a) {
+  return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+}
+inline float hsum4(F32x4 a) {
+  __m128 s = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+  s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+  return _mm_cvtss_f32(s);
+}
+#elif defined(AUDIO_SIMD_NEON)
+inline F32x4 load4(const float *p) { return {vld1q_f32(p)}; }
+inline void store4(float *p, F32x4 a) { vst1q_f32(p, a.v); }
+inline F32x4 splat4(float x) { return {vdupq_n_f32(x)}; }
+inline F32x4 operator+(F32x4 a, F32x4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline F32x4 operator-(F32x4 a, F32x4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline F32x4 operator*(F32x4 a, F32x4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline F32x4 abs4(F32x4 a) { return {vabsq_f32(a.v)}; }
+inline float hsum4(F32x4 a) {
+  float32x2_t s = vadd_f32(vget_low_f32(a.v), vget_high_f32(a.v));
+  return vget_lane_f32(vpadd_f32(s, s), 0);
+}
+#else
+inline F32x4 load4(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store4(float *p, F32x4 a) {
+  for (int i = 0; i < 4; ++i)
+    p[i] = a.v[i];
+}
+inline F32x4 splat4(float x) { return {{x, x, x, x}}; }
+#define AUDIO_SIMD_LANEWISE(OP)                                                \
+  F32x4 r;                                                                     \
+  for (int i = 0; i < 4; ++i)                                                  \
+    r.v[i] = a.v[i] OP b.v[i];                                                 \
+  return r;
+inline F32x4 operator+(F32x4 a, F32x4 b) { AUDIO_SIMD_LANEWISE(+) }
+inline F32x4 operator-(F32x4 a, F32x4 b) { AUDIO_SIMD_LANEWISE(-) }
+inline F32x4 operator*(F32x4 a, F32x4 b) { AUDIO_SIMD_LANEWISE(*) }
+#undef AUDIO_SIMD_LANEWISE
+inline F32x4 abs4(F32x4 a) {
+  for (int i = 0; i < 4; ++i)
+    a.v[i] = a.v[i] < 0.0f ? -a.v[i] : a.v[i];
+  return a;
+}
+inline float hsum4(F32x4 a) { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+#endif
+
+} // namespace audio::simd
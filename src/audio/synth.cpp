@@ -0,0 +1,635 @@
+// src/audio/synth.cpp
+// TinySoundFont lives here (TSF_IMPLEMENTATION) so the send-bus renderer can
+// reach tsf's voice list and the interpolating voice renderer can reuse tsf's
+// envelope/LFO/filter helpers; everything else uses the public tsf API.
+
+#define TSF_IMPLEMENTATION
+#include "tsf.h"
+
+#include "audio/mipmap.hpp"
+#include "audio/render_cost.hpp"
+#include "audio/simd.hpp"
+#include "audio/synth.hpp"
+#include "io/perf_counters.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+constexpr int kScratchFrames = 1024; // render chunk when buses are in use
+constexpr float kDefaultReverbSend = 40.0f / 127.0f;
+constexpr float kDefaultChorusSend = 0.0f;
+constexpr std::uint32_t kSynthStateTag = 0x314E5953; // "SYN1"
+
+// Read `Taps` input samples around `pos` into `tmp`, wrapping at the loop end
+// and zero-filling outside the sample. Only used near edges.
+template <int Taps, int Before>
+const float *gather(const float *input, unsigned int pos, bool looping,
+                    unsigned int loopStart, unsigned int loopEnd,
+                    unsigned int end, float *tmp) {
+  const long loopLen = long(loopEnd) - long(loopStart) + 1;
+  for (int j = 0; j < Taps; ++j) {
+    long idx = long(pos) - Before + j;
+    if (looping)
+      while (idx > long(loopEnd))
+        idx -= loopLen;
+    tmp[j] = (idx < 0 || (!looping && idx > long(end))) ? 0.0f : input[idx];
+  }
+  return tmp;
+}
+
+// tsf_voice_render() for TSF_STEREO_INTERLEAVED with a pluggable
+// interpolation kernel and sample source (pyramid level). Envelope, LFO,
+// filter and loop handling are the same as tsf's, block by block
+// (TSF_RENDER_EFFECTSAMPLEBLOCK).
+template <audio::Interp Mode>
+void render_voice(tsf *f, tsf_voice *v, const audio::VoiceSource &src,
+                  float *out, int numSamples) {
+  constexpr int kTaps = audio::interp_taps(Mode);
+  constexpr int kBefore = audio::interp_before(Mode);
+  constexpr bool kSinc = Mode == audio::Interp::Sinc8 ||
+                         Mode == audio::Interp::Sinc16;
+  const audio::SincTable *table =
+      kSinc ? &audio::SincTable::get(kTaps) : nullptr;
+
+  tsf_region *region = v->region;
+  const float *input = src.samples;
+  const bool updateModEnv = region->modEnvToPitch || region->modEnvToFilterFc;
+  const bool updateModLFO =
+      v->modlfo.delta && (region->modLfoToPitch || region->modLfoToFilterFc ||
+                          region->modLfoToVolume);
+  const bool updateVibLFO = v->viblfo.delta && region->vibLfoToPitch;
+  const bool looping = v->loopStart < v->loopEnd;
+  const unsigned int loopStart = v->loopStart, loopEnd = v->loopEnd;
+  const double endDbl = double(src.end), loopEndDbl = loopEnd + 1.0;
+  // Integer positions up to this index have all their taps in place.
+  const unsigned int fastLimit = looping ? loopEnd : src.end;
+  double srcPos = v->sourceSamplePosition;
+  tsf_voice_lowpass lowpass = v->lowpass;
+
+  const bool dynamicLowpass =
+      region->modLfoToFilterFc || region->modEnvToFilterFc;
+  const bool dynamicPitch = region->modLfoToPitch || region->modEnvToPitch ||
+                            region->vibLfoToPitch;
+  const bool dynamicGain = region->modLfoToVolume != 0;
+  const float sampleRate = f->outSampleRate;
+  const double outputFactor = v->pitchOutputFactor * src.step;
+  double pitchRatio =
+      tsf_timecents2Secsd(v->pitchInputTimecents) * outputFactor;
+  float noteGain = tsf_decibelsToGain(v->noteGainDB);
+  float tmp[kTaps];
+
+  while (numSamples) {
+    int block = std::min(numSamples, TSF_RENDER_EFFECTSAMPLEBLOCK);
+    numSamples -= block;
+
+    if (dynamicLowpass) {
+      const float fres = region->initialFilterFc +
+                         v->modlfo.level * region->modLfoToFilterFc +
+                         v->modenv.level * region->modEnvToFilterFc;
+      const float fc =
+          fres <= 13500 ? tsf_cents2Hertz(fres) / sampleRate : 1.0f;
+      lowpass.active = fc < 0.499f;
+      if (lowpass.active)
+        tsf_voice_lowpass_setup(&lowpass, fc);
+    }
+    if (dynamicPitch) {
+      pitchRatio = tsf_timecents2Secsd(
+                       v->pitchInputTimecents +
+                       (v->modlfo.level * region->modLfoToPitch +
+                        v->viblfo.level * region->vibLfoToPitch +
+                        v->modenv.level * region->modEnvToPitch)) *
+                   outputFactor;
+    }
+    if (dynamicGain)
+      noteGain = tsf_decibelsToGain(v->noteGainDB + v->modlfo.level *
+                                                        region->modLfoToVolume *
+                                                        0.1f);
+
+    const float gainMono = noteGain * v->ampenv.level;
+    const float gainLeft = gainMono * v->panFactorLeft;
+    const float gainRight = gainMono * v->panFactorRight;
+    const int band = kSinc ? audio::SincTable::band_for(pitchRatio) : 0;
+
+    tsf_voice_envelope_process(&v->ampenv, block, sampleRate);
+    if (updateModEnv)
+      tsf_voice_envelope_process(&v->modenv, block, sampleRate);
+    if (updateModLFO)
+      tsf_voice_lfo_process(&v->modlfo, block);
+    if (updateVibLFO)
+      tsf_voice_lfo_process(&v->viblfo, block);
+
+    while (block-- && srcPos < endDbl) {
+      const auto pos = static_cast<unsigned int>(srcPos);
+      const float alpha = static_cast<float>(srcPos - pos);
+      const float *x =
+          (pos >= unsigned(kBefore) && pos + (kTaps - kBefore - 1) <= fastLimit)
+              ? input + (pos - kBefore)
+              : gather<kTaps, kBefore>(input, pos, looping, loopStart,
+                                       loopEnd, src.end, tmp);
+      float val;
+      if constexpr (Mode == audio::Interp::Linear) {
+        val = x[0] + (x[1] - x[0]) * alpha;
+      } else if constexpr (Mode == audio::Interp::Cubic) {
+        val = audio::interp_cubic(x, alpha);
+      } else {
+        // alpha can round up to 1.0f; row p + 1 must stay within the
+        // kPhases + 1 rows.
+        const float ph = alpha * audio::SincTable::kPhases;
+        const int p =
+            std::min(static_cast<int>(ph), audio::SincTable::kPhases - 1);
+        val = audio::interp_sinc<kTaps>(x, table->row(band, p),
+                                        table->row(band, p + 1), ph - p);
+      }
+
+      if (lowpass.active)
+        val = tsf_voice_lowpass_process(&lowpass, val);
+      *out++ += val * gainLeft;
+      *out++ += val * gainRight;
+
+      srcPos += pitchRatio;
+      if (srcPos >= loopEndDbl && looping)
+        srcPos -= (loopEnd - loopStart + 1.0);
+    }
+
+    if (srcPos >= endDbl || v->ampenv.segment == TSF_SEGMENT_DONE) {
+      tsf_voice_kill(v);
+      return;
+    }
+  }
+
+  v->sourceSamplePosition = srcPos;
+  if (lowpass.active || dynamicLowpass)
+    v->lowpass = lowpass;
+}
+
+// tsf's own renderer, for linear interpolation straight from the pool.
+void render_voice_tsf(tsf *f, tsf_voice *v, const audio::VoiceSource &,
+                      float *out, int numSamples) {
+  tsf_voice_render(f, v, out, numSamples);
+}
+
+tsf *load_font(const std::filesystem::path &sf2Path) {
+  io::PerfScope perf(io::PerfStage::Sf2Load);
+  return tsf_load_filename(sf2Path.string().c_str());
+}
+
+// One past the last pool sample any region can reach (tsf does not keep the
+// pool size itself).
+std::size_t referenced_samples(const tsf *f) {
+  std::size_t n = 0;
+  for (int p = 0; p < f->presetNum; ++p) {
+    const tsf_preset &preset = f->presets[p];
+    for (int r = 0; r < preset.regionNum; ++r)
+      n = std::max<std::size_t>(n, preset.regions[r].end);
+  }
+  return n;
+}
+
+} // namespace
+
+namespace audio {
+
+Synth::Synth(const std::filesystem::path &sf2Path, int sampleRate)
+    : Synth(load_font(sf2Path), sampleRate) {
+  if (!f_)
+    throw std::runtime_error("Failed to load SoundFont (.sf2)");
+  sf2Path_ = sf2Path;
+  tsf_set_output(f_.get(), TSF_STEREO_INTERLEAVED, sampleRate_, 0.0f);
+  tsf_set_volume(f_.get(), 0.8f); // modest headroom
+  init_channels();
+
+  std::size_t regionBytes = std::size_t(f_->presetNum) * sizeof(tsf_preset);
+  for (int p = 0; p < f_->presetNum; ++p)
+    regionBytes += std::size_t(f_->presets[p].regionNum) * sizeof(tsf_region);
+  samplesMem_.set(referenced_samples(f_.get()) * sizeof(float));
+  regionsMem_.set(regionBytes);
+
+  std::vector<PresetName> names;
+  for (int p = 0; p < f_->presetNum; ++p) {
+    const tsf_preset &pr = f_->presets[p];
+    names.push_back({pr.presetName, int(pr.bank), int(pr.preset)});
+  }
+  cost_name_presets(std::move(names));
+}
+
+Synth::Synth(tsf *f, int sampleRate)
+    : f_(f), sampleRate_(sampleRate), renderVoice_(&render_voice_tsf),
+      scratch_(std::size_t(kScratchFrames) * 2, 0.0f) {
+  std::fill(std::begin(reverbSend_), std::end(reverbSend_),
+            kDefaultReverbSend);
+  std::fill(std::begin(chorusSend_), std::end(chorusSend_),
+            kDefaultChorusSend);
+}
+
+Synth::~Synth() = default;
+
+void Synth::Closer::operator()(tsf *f) const { tsf_close(f); }
+
+Synth Synth::share() const {
+  tsf *copy = tsf_copy(f_.get()); // output mode + gain copied, channels not
+  if (!copy)
+    throw std::runtime_error("Failed to create a synth instance (tsf_copy)");
+  Synth s(copy, sampleRate_);
+  s.sf2Path_ = sf2Path_;
+  s.pyramid_ = pyramid_;
+  s.init_channels();
+  s.set_interpolation(interp_);
+  return s;
+}
+
+void Synth::init_channels() {
+  // For now, set every channel to GM1 Acoustic Grand (program 0).
+  for (int ch = 0; ch < kMidiChannels; ++ch) {
+    tsf_channel_set_presetnumber(f_.get(), ch, 0 /*Acoustic Grand*/,
+                                 ch == 9 /*GM drums on ch10*/);
+  }
+}
+
+void Synth::set_max_voices(int n) {
+  tsf_set_max_voices(f_.get(), n);
+  voiceSrc_.resize(std::size_t(f_->voiceNum));
+  charge_voices();
+}
+
+void Synth::charge_voices() {
+  voicesMem_.set(std::size_t(f_->voiceNum) * sizeof(tsf_voice) +
+                 voiceSrc_.capacity() * sizeof(VoiceSource));
+}
+
+void Synth::enable_mipmaps() {
+  pyramid_ = SamplePyramid::load_or_build(
+      f_->fontSamples, referenced_samples(f_.get()), sf2Path_);
+  set_interpolation(interp_); // linear now needs the pyramid-aware renderer
+}
+
+void Synth::set_interpolation(Interp mode) {
+  interp_ = mode;
+  switch (mode) {
+  case Interp::Linear:
+    renderVoice_ = pyramid_ ? &render_voice<Interp::Linear>
+                            : &render_voice_tsf;
+    break;
+  case Interp::Cubic:
+    renderVoice_ = &render_voice<Interp::Cubic>;
+    break;
+  case Interp::Sinc8:
+    SincTable::get(8); // build the table now, not in the audio callback
+    renderVoice_ = &render_voice<Interp::Sinc8>;
+    break;
+  case Interp::Sinc16:
+    SincTable::get(16);
+    renderVoice_ = &render_voice<Interp::Sinc16>;
+    break;
+  }
+}
+
+void Synth::apply(const ScheduledEvent &e) {
+  switch (e.kind) {
+  case EvKind::NoteOn:
+    note_on(e.ch, e.data1, e.data2);
+    break;
+  case EvKind::NoteOff:
+    note_off(e.ch, e.data1);
+    break;
+  case EvKind::Control:
+    control(e.ch, e.data1, e.data2);
+    break;
+  }
+}
+
+void Synth::note_on(int ch, int key, int vel) {
+  // vel 0..127 -> 0..1 gain
+  const unsigned int playIndex = f_->voicePlayIndex;
+  tsf_channel_note_on(f_.get(), ch, key, (vel <= 127 ? vel : 127) / 127.0f);
+  if (f_->voicePlayIndex != playIndex) // voices started (not a note-off)
+    select_levels(playIndex);
+  if (cost_enabled() && f_->voicePlayIndex != playIndex) {
+    int started = 0, preset = -1;
+    for (int i = 0; i < f_->voiceNum; ++i) {
+      const tsf_voice &v = f_->voices[i];
+      if (v.playingPreset != -1 && v.playIndex == playIndex) {
+        ++started;
+        preset = v.playingPreset;
+      }
+    }
+    cost_add_note_on(preset, ch, started);
+  }
+}
+
+void Synth::select_levels(unsigned int playIndex) {
+  // tsf grew its voices: only without set_max_voices (offline renders);
+  // real-time callers cap them first so this never allocates there.
+  if (voiceSrc_.size() < std::size_t(f_->voiceNum)) {
+    voiceSrc_.resize(std::size_t(f_->voiceNum));
+    charge_voices();
+  }
+  for (int i = 0; i < f_->voiceNum; ++i) {
+    tsf_voice *v = &f_->voices[i];
+    if (v->playingPreset == -1 || v->playIndex != playIndex)
+      continue;
+    VoiceSource &src = voiceSrc_[std::size_t(i)];
+    src = {f_->fontSamples, v->region->end, 1.0};
+    if (!pyramid_)
+      continue;
+
+    // Highest level (each halves the rate) that keeps the ratio >= 1 there,
+    // i.e. the ratio in [1, 2) at that level, or the top level.
+    double ratio =
+        tsf_timecents2Secsd(v->pitchInputTimecents) * v->pitchOutputFactor;
+    int k = 0;
+    while (k + 1 < SamplePyramid::kLevels && ratio >= 2.0) {
+      ratio *= 0.5;
+      ++k;
+    }
+    if (k == 0)
+      continue;
+
+    // Map positions to the level. The loop length is rounded to whole
+    // samples there, and the step is scaled by the same factor so the loop
+    // plays at the right pitch.
+    const double scale = std::ldexp(1.0, -k);
+    src.samples = pyramid_->level(k);
+    src.end = static_cast<unsigned int>(
+        std::min<std::size_t>(std::size_t(std::ceil(v->region->end * scale)),
+                              pyramid_->size(k)));
+    src.step = scale;
+    v->sourceSamplePosition *= scale;
+    if (v->loopStart < v->loopEnd) {
+      const double len = double(v->loopEnd) - v->loopStart + 1.0;
+      const double lenK = std::max(1.0, std::round(len * scale));
+      v->loopStart =
+          static_cast<unsigned int>(std::lround(v->loopStart * scale));
+      v->loopEnd = v->loopStart + static_cast<unsigned int>(lenK) - 1;
+      src.step = lenK / len;
+    }
+  }
+}
+
+void Synth::note_off(int ch, int key) {
+  tsf_channel_note_off(f_.get(), ch, key);
+}
+
+void Synth::control(int ch, int cc, int value) {
+  if (ch < 0 || ch >= kMidiChannels)
+    return;
+  if (cc == 91) // Effects 1 depth: reverb send
+    reverbSend_[ch] = value / 127.0f;
+  else if (cc == 93) // Effects 3 depth: chorus send
+    chorusSend_[ch] = value / 127.0f;
+  tsf_channel_midi_control(f_.get(), ch, cc, value); // ignores 91/93
+}
+
+void Synth::program(int ch, int program) {
+  tsf_channel_set_presetnumber(f_.get(), ch, program, ch == 9);
+}
+
+void Synth::pitch_bend(int ch, int value14) {
+  tsf_channel_set_pitchwheel(f_.get(), ch, value14);
+}
+
+void Synth::all_notes_off() { tsf_note_off_all(f_.get()); }
+
+int Synth::active_voices() const { return tsf_active_voice_count(f_.get()); }
+
+void Synth::render_voices(float *out, int frames, int channel) {
+  const bool timed = cost_enabled();
+  for (int i = 0; i < f_->voiceNum; ++i) {
+    tsf_voice *v = &f_->voices[i];
+    if (v->playingPreset == -1 ||
+        (channel >= 0 && (v->playingChannel & (kMidiChannels - 1)) != channel))
+      continue;
+    const auto idx = std::size_t(i);
+    const VoiceSource src = idx < voiceSrc_.size() && voiceSrc_[idx].samples
+                                ? voiceSrc_[idx]
+                                : VoiceSource{f_->fontSamples,
+                                              v->region->end, 1.0};
+    if (!timed) {
+      renderVoice_(f_.get(), v, src, out, frames);
+      continue;
+    }
+    // The voice may end inside the call, so take its keys first.
+    const int preset = v->playingPreset;
+    const int ch = v->playingChannel & (kMidiChannels - 1);
+    const std::uint64_t t0 = cost_clock();
+    renderVoice_(f_.get(), v, src, out, frames);
+    cost_add_render(preset, ch, cost_clock() - t0, std::uint64_t(frames));
+  }
+}
+
+void Synth::render(float *dry, float *reverbBus, float *chorusBus,
+                   int frames) {
+  io::PerfScope perf(io::PerfStage::Render);
+  perf.set_units(std::uint64_t(frames));
+  if (!reverbBus && !chorusBus) {
+    simd::clear_stereo(dry, std::size_t(frames));
+    render_voices(dry, frames, -1);
+    return;
+  }
+
+  while (frames > 0) {
+    const int n = std::min(frames, kScratchFrames);
+    simd::clear_stereo(dry, std::size_t(n));
+
+    // Pass 1: voices of channels without sends go straight to the dry mix;
+    // remember which send channels are active.
+    std::uint32_t sendMask = 0, dryMask = 0;
+    for (int i = 0; i < f_->voiceNum; ++i) {
+      const tsf_voice *v = &f_->voices[i];
+      if (v->playingPreset == -1)
+        continue;
+      const int ch = v->playingChannel & (kMidiChannels - 1);
+      const bool sends = (reverbBus && reverbSend_[ch] > 0.0f) ||
+                         (chorusBus && chorusSend_[ch] > 0.0f);
+      (sends ? sendMask : dryMask) |= 1u << ch;
+    }
+    for (int ch = 0; dryMask != 0; ++ch, dryMask >>= 1) {
+      if (dryMask & 1u)
+        render_voices(dry, n, ch);
+    }
+
+    // Pass 2: one scratch render per send channel, split three ways.
+    for (int ch = 0; sendMask != 0; ++ch, sendMask >>= 1) {
+      if (!(sendMask & 1u))
+        continue;
+      float *buf = scratch_.data();
+      simd::clear_stereo(buf, std::size_t(n));
+      render_voices(buf, n, ch);
+      simd::mix_stereo(dry, buf, std::size_t(n), 1.0f, 1.0f);
+      if (reverbBus)
+        simd::mix_stereo(reverbBus, buf, std::size_t(n), reverbSend_[ch],
+                         reverbSend_[ch]);
+      if (chorusBus)
+        simd::mix_stereo(chorusBus, buf, std::size_t(n), chorusSend_[ch],
+                         chorusSend_[ch]);
+    }
+
+    dry += n * 2;
+    if (reverbBus)
+      reverbBus += n * 2;
+    if (chorusBus)
+      chorusBus += n * 2;
+    frames -= n;
+  }
+}
+
+// Which sample pool a voice reads: -1 none yet, 0 the font, k pyramid level.
+int Synth::source_level(const float *samples) const {
+  if (!samples)
+    return -1;
+  if (samples == f_->fontSamples)
+    return 0;
+  for (int k = 1; pyramid_ && k < SamplePyramid::kLevels; ++k) {
+    if (samples == pyramid_->level(k))
+      return k;
+  }
+  throw std::logic_error("Voice reads from an unknown sample pool");
+}
+
+void Synth::save_state(StateWriter &w) const {
+  w.put(kSynthStateTag);
+  w.put(std::uint32_t(sizeof(tsf_voice)));
+  w.put(std::uint32_t(sizeof(tsf_channel)));
+  w.put(sampleRate_);
+  w.put(int(interp_));
+  w.put(std::uint8_t(pyramid_ != nullptr));
+  w.put_raw(reverbSend_, sizeof reverbSend_);
+  w.put_raw(chorusSend_, sizeof chorusSend_);
+
+  const tsf_channels *chs = f_->channels;
+  w.put(chs ? chs->channelNum : 0);
+  w.put(chs ? chs->activeChannel : 0);
+  if (chs)
+    w.put_raw(chs->channels, std::size_t(chs->channelNum) *
+                                 sizeof(tsf_channel));
+
+  // Voices verbatim (envelopes, LFOs, filter, position), except that the
+  // region pointer is stored as its index in the playing preset and the
+  // sample source as its pool level.
+  w.put(f_->voicePlayIndex);
+  w.put(f_->maxVoiceNum);
+  w.put(f_->voiceNum);
+  for (int i = 0; i < f_->voiceNum; ++i) {
+    tsf_voice v = f_->voices[i];
+    int region = -1;
+    if (v.playingPreset != -1 && v.region)
+      region = int(v.region - f_->presets[v.playingPreset].regions);
+    v.region = nullptr;
+    w.put(region);
+    w.put(v);
+    const auto idx = std::size_t(i);
+    const VoiceSource src =
+        idx < voiceSrc_.size() ? voiceSrc_[idx] : VoiceSource{};
+    w.put(std::int8_t(source_level(src.samples)));
+    w.put(src.end);
+    w.put(src.step);
+  }
+}
+
+void Synth::load_state(StateReader &r) {
+  r.expect(kSynthStateTag, "synth state tag");
+  r.expect(std::uint32_t(sizeof(tsf_voice)), "tsf_voice layout");
+  r.expect(std::uint32_t(sizeof(tsf_channel)), "tsf_channel layout");
+  r.expect(sampleRate_, "sample rate");
+  const int interp = r.get<int>();
+  if (interp < int(Interp::Linear) || interp > int(Interp::Sinc16))
+    throw std::runtime_error("Checkpoint mismatch: interpolation mode");
+  set_interpolation(Interp(interp));
+  r.expect(std::uint8_t(pyramid_ != nullptr), "sample pyramids");
+  r.get_raw(reverbSend_, sizeof reverbSend_);
+  r.get_raw(chorusSend_, sizeof chorusSend_);
+
+  const int channelNum = r.get<int>();
+  const int activeChannel = r.get<int>();
+  if (channelNum < 0 || channelNum > 0xFFFF || activeChannel < 0 ||
+      (channelNum && activeChannel >= channelNum))
+    throw std::runtime_error("Checkpoint mismatch: channel count");
+  if (channelNum) {
+    if (!tsf_channel_init(f_.get(), channelNum - 1))
+      throw std::runtime_error("Out of memory restoring channels");
+    f_->channels->channelNum = channelNum;
+    f_->channels->activeChannel = activeChannel;
+    r.get_raw(f_->channels->channels,
+              std::size_t(channelNum) * sizeof(tsf_channel));
+  }
+
+  f_->voicePlayIndex = r.get<unsigned int>();
+  const int maxVoiceNum = r.get<int>();
+  const int voiceNum = r.get<int>();
+  if (voiceNum < 0 || voiceNum > 0xFFFF)
+    throw std::runtime_error("Checkpoint mismatch: voice count");
+  if (voiceNum > f_->voiceNum) { // grow only, like tsf itself
+    auto *voices = static_cast<tsf_voice *>(TSF_REALLOC(
+        f_->voices, std::size_t(voiceNum) * sizeof(tsf_voice)));
+    if (!voices)
+      throw std::runtime_error("Out of memory restoring voices");
+    f_->voices = voices;
+  }
+  f_->voiceNum = voiceNum;
+  f_->maxVoiceNum = maxVoiceNum;
+  voiceSrc_.assign(std::size_t(voiceNum), VoiceSource{});
+  for (int i = 0; i < voiceNum; ++i) {
+    const int region = r.get<int>();
+    tsf_voice v = r.get<tsf_voice>();
+    if (v.playingPreset != -1) {
+      if (v.playingPreset < 0 || v.playingPreset >= f_->presetNum ||
+          region < 0 || region >= f_->presets[v.playingPreset].regionNum)
+        throw std::runtime_error("Checkpoint mismatch: voice region");
+      v.region = &f_->presets[v.playingPreset].regions[region];
+    }
+    f_->voices[i] = v;
+    VoiceSource &src = voiceSrc_[std::size_t(i)];
+    const int level = r.get<std::int8_t>();
+    src.end = r.get<unsigned int>();
+    src.step = r.get<double>();
+    if (level >= SamplePyramid::kLevels || (level > 0 && !pyramid_))
+      throw std::runtime_error("Checkpoint mismatch: sample level");
+    src.samples = level < 0    ? nullptr
+                  : level == 0 ? f_->fontSamples
+                               : pyramid_->level(level);
+  }
+  charge_voices();
+}
+
+std::vector<InterpCost> measure_interp_cost(const Synth &synth,
+                                            double seconds) {
+  constexpr int kBlock = 512;
+  // Four octaves of a wide chord on channel 1, many notes far above their
+  // root key, so ratios > 1 (and the sinc bands) are exercised too.
+  constexpr int kNotes[] = {36, 43, 48, 52, 55, 60, 64, 67, 72,
+                            76, 79, 84, 88, 91, 96, 100};
+  std::vector<float> buf(std::size_t(kBlock) * 2);
+  std::vector<InterpCost> costs;
+  for (Interp mode : kAllInterps) {
+    Synth s = synth.share();
+    s.set_max_voices(64);
+    s.set_interpolation(mode);
+    const int blocks =
+        std::max(1, static_cast<int>(seconds * s.sample_rate() / kBlock));
+    double voiceSamples = 0.0, sec = 0.0;
+    for (int rep = 0; rep < blocks; rep += s.sample_rate() / kBlock) {
+      for (int key : kNotes) // re-strike every second: keep voices sounding
+        s.note_on(0, key, 100);
+      for (int b = 0; b < s.sample_rate() / kBlock && rep + b < blocks; ++b) {
+        const int voices = s.active_voices();
+        const auto t0 = std::chrono::steady_clock::now();
+        s.render(buf.data(), nullptr, nullptr, kBlock);
+        sec += std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - t0)
+                   .count();
+        voiceSamples += double(voices) * kBlock;
+      }
+      s.all_notes_off();
+    }
+    const double ns = voiceSamples > 0.0 ? sec * 1e9 / voiceSamples : 0.0;
+    costs.push_back(
+        {mode, ns, ns > 0.0 ? 1e9 / (ns * s.sample_rate()) : 0.0});
+  }
+  return costs;
+}
+
+} // namespace audio
@@ -0,0 +1,154 @@
+// src/audio/synth.hpp
+// Thin C++ owner around one TinySoundFont instance plus the per-channel state
+// tsf does not model itself (CC91 reverb / CC93 chorus send levels).
+//
+// Usage:
+//   audio::Synth synth(sf2Path, 44100);     // loads the font
+//   audio::Synth layer = synth.share();     // tsf_copy: shares samples
+//   synth.apply(ev);                        // ScheduledEvent from schedule.hpp
+//   synth.render(dry, reverbBus, chorusBus, frames);
+//
+// Design notes:
+// - The TinySoundFont implementation is compiled in synth.cpp, which lets us
+//   walk tsf's voice list directly: voices of channels with a non-zero send
+//   are rendered channel-by-channel into a scratch buffer and then split to
+//   the dry mix and the two buses. Channels without sends render straight
+//   into the dry mix, so the extra cost is per active channel, not per voice.
+// - Every channel starts on GM program 0; channel 10 (index 9) uses the drum
+//   bank. Reverb send defaults to 40 and chorus to 0, as on GM/GS modules.
+// - Sample interpolation is selectable (audio/interp.hpp). Linear uses tsf's
+//   own voice renderer unchanged; the other modes use a copy of that loop in
+//   synth.cpp with the kernel as a template parameter, so the per-sample path
+//   has no mode switch.
+// - Optional band-limited sample pyramids (audio/mipmap.hpp): at note-on a
+//   voice pitched up by an octave or more is moved to the pyramid level that
+//   brings its playback ratio back below 2 (enable_mipmaps()).
+// - Memory is charged to common/mem_account.hpp: the sample pool and region
+//   tables by the instance that loaded the font (share()d copies reuse
+//   them), the voice array by every instance as tsf grows it.
+// - save_state/load_state checkpoint everything a render continues from:
+//   channel state, every tsf_voice (envelopes, LFOs, filter, sample
+//   position), send levels and the voices' pyramid levels. The font itself
+//   is not saved: load into an instance of the same font and settings.
+// - All methods except share() are meant for one thread (the audio thread).
+
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "audio/interp.hpp"
+#include "audio/schedule.hpp"
+#include "common/mem_account.hpp"
+#include "common/snapshot.hpp"
+
+struct tsf;
+struct tsf_voice;
+
+namespace audio {
+
+constexpr int kMidiChannels = 16;
+
+class SamplePyramid;
+
+// Where one voice reads its samples: pool level, its end, and the factor its
+// playback step is scaled by (1 at level 0).
+struct VoiceSource {
+  const float *samples = nullptr;
+  unsigned int end = 0;
+  double step = 1.0;
+};
+
+class Synth {
+public:
+  // Load a SoundFont. Throws std::runtime_error on failure.
+  Synth(const std::filesystem::path &sf2Path, int sampleRate);
+  ~Synth();
+
+  Synth(Synth &&other) noexcept = default;
+  Synth &operator=(Synth &&other) noexcept = default;
+  Synth(const Synth &) = delete;
+  Synth &operator=(const Synth &) = delete;
+
+  // An independent instance that shares this one's samples (tsf_copy).
+  // Not thread-safe with respect to other share() calls on the same font.
+  [[nodiscard]] Synth share() const;
+
+  // Cap polyphony and pre-allocate voices (no allocation in note_on after).
+  void set_max_voices(int n);
+
+  // Build (or load from the disk cache) the octave pyramid of this font's
+  // samples; voices started afterwards use it. Instances made by share()
+  // after this call share the pyramid.
+  void enable_mipmaps();
+  [[nodiscard]] bool mipmaps() const { return pyramid_ != nullptr; }
+
+  // Interpolation used for every voice from the next render() on.
+  void set_interpolation(Interp mode);
+  [[nodiscard]] Interp interpolation() const { return interp_; }
+
+  void apply(const ScheduledEvent &e);
+  void note_on(int ch, int key, int vel);
+  void note_off(int ch, int key);
+  void control(int ch, int cc, int value);
+  void program(int ch, int program);
+  void pitch_bend(int ch, int value14);
+  void all_notes_off();
+
+  // Render `frames` interleaved stereo frames. `dry` is overwritten; if the
+  // bus pointers are non-null, channel signals are *added* to them scaled by
+  // their CC91/CC93 levels (pass nullptr for a plain dry render).
+  void render(float *dry, float *reverbBus, float *chorusBus, int frames);
+
+  // Checkpoint (common/snapshot.hpp). load_state throws std::runtime_error
+  // if the state was saved with another sample rate, tsf build or mipmap
+  // setting, and leaves this instance unusable then.
+  void save_state(StateWriter &w) const;
+  void load_state(StateReader &r);
+
+  [[nodiscard]] int active_voices() const;
+  [[nodiscard]] int sample_rate() const { return sampleRate_; }
+  [[nodiscard]] tsf *handle() const { return f_.get(); }
+
+private:
+  struct Closer {
+    void operator()(tsf *f) const;
+  };
+  using VoiceRenderFn = void (*)(tsf *, tsf_voice *, const VoiceSource &,
+                                 float *, int);
+
+  Synth(tsf *f, int sampleRate);
+  void init_channels();
+  void select_levels(unsigned int playIndex); // pyramid level per new voice
+  void render_voices(float *out, int frames, int channel); // -1 = all
+  void charge_voices();
+  int source_level(const float *samples) const;
+
+  std::unique_ptr<tsf, Closer> f_;
+  int sampleRate_ = 44100;
+  std::filesystem::path sf2Path_; // pyramid cache key
+  Interp interp_ = Interp::Linear;
+  VoiceRenderFn renderVoice_;
+  std::shared_ptr<const SamplePyramid> pyramid_;
+  std::vector<VoiceSource> voiceSrc_; // parallel to tsf's voice array
+  float reverbSend_[kMidiChannels];
+  float chorusSend_[kMidiChannels];
+  std::vector<float> scratch_; // one channel's stereo block
+  MemCharge samplesMem_{MemSubsystem::Samples}; // only on the loading one
+  MemCharge regionsMem_{MemSubsystem::Regions};
+  MemCharge voicesMem_{MemSubsystem::Voices};
+};
+
+// Cost of one interpolation mode, measured by rendering a wide chord.
+struct InterpCost {
+  Interp mode;
+  double nsPerVoiceSample; // wall time per voice per output sample
+  double voicesPerCore;    // voices one core sustains in real time
+};
+
+// Render `seconds` of a fixed chord on a share()d copy of `synth` once per
+// mode and time it. Offline only: call before any device is started.
+std::vector<InterpCost> measure_interp_cost(const Synth &synth,
+                                            double seconds = 2.0);
+
+} // namespace audio
@@ -0,0 +1,106 @@
+// src/common/arena.hpp
+// Per-file memory arena for batch tools, plus a counting resource wrapper.
+//
+//   FileArena arena;                         // one per worker thread
+//   for (const auto &path : files) {
+//     midi::Song song = midi::parse_smf(bytes, arena.resource());
+//     auto tempo = midi::build_tempo_map(song, arena.resource());
+//     auto evs = audio::build_schedule(song, tempo, arena.resource());
+//     ...
+//     // song/tempo/evs go out of scope (their frees are no-ops), then:
+//     arena.reset();                         // O(1) drop of everything
+//   }
+//
+// Contract:
+//  - Not thread-safe: one arena per worker.
+//  - Everything allocated from resource() must be destroyed before reset().
+//  - The initial buffer is reused by every file. When a file overflows it,
+//    reset() grows the buffer to that file's high-water mark, so steady state
+//    costs no upstream allocation at all.
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+// Forwards to an upstream resource and counts what goes through it.
+class CountingResource : public std::pmr::memory_resource {
+public:
+  explicit CountingResource(
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+      : up_(upstream) {}
+
+  std::size_t allocations() const { return allocs_; }
+  std::size_t bytes() const { return bytes_; }   // currently outstanding
+  std::size_t peak() const { return peak_; }     // high-water mark
+  std::size_t total() const { return total_; }   // ever allocated
+
+private:
+  void *do_allocate(std::size_t n, std::size_t align) override {
+    void *p = up_->allocate(n, align);
+    ++allocs_;
+    bytes_ += n;
+    total_ += n;
+    if (bytes_ > peak_)
+      peak_ = bytes_;
+    return p;
+  }
+  void do_deallocate(void *p, std::size_t n, std::size_t align) override {
+    up_->deallocate(p, n, align);
+    bytes_ -= n;
+  }
+  bool do_is_equal(const std::pmr::memory_resource &o) const noexcept override {
+    return this == &o;
+  }
+
+  std::pmr::memory_resource *up_;
+  std::size_t allocs_ = 0, bytes_ = 0, peak_ = 0, total_ = 0;
+};
+
+class FileArena {
+public:
+  explicit FileArena(
+      std::size_t initialBytes = std::size_t(1) << 20,
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+      : up_(upstream), counter_(upstream) {
+    rebuild(initialBytes);
+  }
+  ~FileArena() {
+    mono_.reset();
+    up_->deallocate(buf_, size_, alignof(std::max_align_t));
+  }
+  FileArena(const FileArena &) = delete;
+  FileArena &operator=(const FileArena &) = delete;
+
+  std::pmr::memory_resource *resource() { return mono_.get(); }
+
+  // Drop everything allocated since the last reset.
+  void reset() {
+    const std::size_t used = counter_.peak();
+    if (used == 0) {
+      mono_->release(); // rewinds to the start of the initial buffer
+      return;
+    }
+    // Overflowed: the next file of this size should fit in one buffer.
+    rebuild(size_ + used);
+  }
+
+  [[nodiscard]] std::size_t capacity() const { return size_; }
+
+private:
+  void rebuild(std::size_t bytes) {
+    mono_.reset();
+    if (buf_)
+      up_->deallocate(buf_, size_, alignof(std::max_align_t));
+    counter_ = CountingResource(up_);
+    buf_ = up_->allocate(bytes, alignof(std::max_align_t));
+    size_ = bytes;
+    mono_ = std::make_unique<std::pmr::monotonic_buffer_resource>(
+        buf_, size_, &counter_);
+  }
+
+  std::pmr::memory_resource *up_;
+  CountingResource counter_; // counts overflow chunks only
+  void *buf_ = nullptr; // from up_, so upstream accounting sees it
+  std::size_t size_ = 0;
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> mono_;
+};
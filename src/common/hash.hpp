@@ -0,0 +1,18 @@
+// src/common/hash.hpp
+// FNV-1a (64-bit): cheap, stable content hashes for cache keys and change
+// detection. Not for hash tables fed untrusted keys.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+constexpr std::uint64_t kFnv1aSeed = 0xCBF29CE484222325ull;
+
+inline std::uint64_t fnv1a(const void *data, std::size_t len,
+                           std::uint64_t h = kFnv1aSeed) {
+  const auto *p = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < len; ++i) {
+    h ^= p[i];
+    h *= 0x100000001B3ull;
+  }
+  return h;
+}
@@ -0,0 +1,184 @@
+// src/common/mem_account.hpp
+// Process-wide memory accounting by subsystem: current and peak bytes for
+// file bytes, parsed songs, tempo maps, schedules, the SoundFont sample pool,
+// region tables, voice arrays and mipmap pyramids (--mem-report).
+//
+//   midi::Song song(mem_resource(MemSubsystem::Song));  // pmr: counted
+//   MemCharge file(MemSubsystem::FileBytes, bytes.capacity()); // explicit
+//   print_mem_report(std::cout);
+//
+// Design notes:
+// - Two ways in. Containers that already take a std::pmr resource get
+//   mem_resource(s), which forwards to the heap and counts. Memory owned by
+//   C code or plain vectors (tsf's pools, file buffers) is charged with a
+//   MemCharge held next to it: it adds its size on construction or set()
+//   and gives it back on destruction.
+// - Counters are relaxed atomics, so charging is lock-free and safe on the
+//   audio thread (tsf may grow its voice array inside a note-on).
+// - One resource per subsystem for the whole process: every container of a
+//   subsystem compares equal, so moves and swaps between them never copy.
+// - Explicit charges are the owner's count of its buffers, not malloc's
+//   (no allocator headers or rounding); shared data (tsf_copy'd fonts,
+//   pyramids) is charged once, by whoever owns it.
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory_resource>
+#include <ostream>
+#include <utility>
+
+enum class MemSubsystem : std::uint8_t {
+  FileBytes, // raw SMF bytes held in memory or mapped
+  Song,      // parsed event vectors (midi::Song)
+  TempoMap,
+  Schedule,  // audio::Schedule and EventStream buffers
+  Samples,   // SoundFont sample pool (tsf's float samples)
+  Regions,   // preset and region tables
+  Voices,    // tsf voice arrays plus per-voice sources
+  Pyramids,  // band-limited sample pyramids (audio/mipmap.hpp)
+};
+constexpr std::size_t kMemSubsystems = 8;
+
+inline const char *mem_subsystem_name(MemSubsystem s) {
+  static constexpr const char *kNames[kMemSubsystems] = {
+      "file bytes", "song",    "tempo map", "schedule",
+      "samples",    "regions", "voices",    "pyramids"};
+  return kNames[std::size_t(s)];
+}
+
+struct MemUsage {
+  std::size_t current = 0;
+  std::size_t peak = 0;
+};
+
+namespace detail {
+
+struct alignas(64) MemCounter {
+  std::atomic<std::size_t> current{0};
+  std::atomic<std::size_t> peak{0};
+};
+
+inline std::array<MemCounter, kMemSubsystems> g_memCounters;
+
+} // namespace detail
+
+inline void mem_add(MemSubsystem s, std::size_t bytes) {
+  detail::MemCounter &c = detail::g_memCounters[std::size_t(s)];
+  const std::size_t now =
+      c.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  std::size_t peak = c.peak.load(std::memory_order_relaxed);
+  while (now > peak &&
+         !c.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+    ;
+}
+
+inline void mem_sub(MemSubsystem s, std::size_t bytes) {
+  detail::g_memCounters[std::size_t(s)].current.fetch_sub(
+      bytes, std::memory_order_relaxed);
+}
+
+inline MemUsage mem_usage(MemSubsystem s) {
+  const detail::MemCounter &c = detail::g_memCounters[std::size_t(s)];
+  return MemUsage{c.current.load(std::memory_order_relaxed),
+                  c.peak.load(std::memory_order_relaxed)};
+}
+
+// Heap resource that charges one subsystem.
+class AccountingResource : public std::pmr::memory_resource {
+public:
+  explicit AccountingResource(
+      MemSubsystem s,
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+      : s_(s), up_(upstream) {}
+
+private:
+  void *do_allocate(std::size_t n, std::size_t align) override {
+    void *p = up_->allocate(n, align);
+    mem_add(s_, n);
+    return p;
+  }
+  void do_deallocate(void *p, std::size_t n, std::size_t align) override {
+    up_->deallocate(p, n, align);
+    mem_sub(s_, n);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &o) const noexcept override {
+    return this == &o;
+  }
+
+  MemSubsystem s_;
+  std::pmr::memory_resource *up_;
+};
+
+inline std::pmr::memory_resource *mem_resource(MemSubsystem s) {
+  static AccountingResource resources[kMemSubsystems] = {
+      AccountingResource(MemSubsystem::FileBytes),
+      AccountingResource(MemSubsystem::Song),
+      AccountingResource(MemSubsystem::TempoMap),
+      AccountingResource(MemSubsystem::Schedule),
+      AccountingResource(MemSubsystem::Samples),
+      AccountingResource(MemSubsystem::Regions),
+      AccountingResource(MemSubsystem::Voices),
+      AccountingResource(MemSubsystem::Pyramids)};
+  return &resources[std::size_t(s)];
+}
+
+// An explicit charge for memory the accounting resources never see. Move-only;
+// the bytes are given back when it is destroyed.
+class MemCharge {
+public:
+  explicit MemCharge(MemSubsystem s, std::size_t bytes = 0) : s_(s) {
+    set(bytes);
+  }
+  ~MemCharge() { set(0); }
+  MemCharge(MemCharge &&o) noexcept
+      : s_(o.s_), bytes_(std::exchange(o.bytes_, 0)) {}
+  MemCharge &operator=(MemCharge &&o) noexcept {
+    if (this != &o) {
+      set(0);
+      s_ = o.s_;
+      bytes_ = std::exchange(o.bytes_, 0);
+    }
+    return *this;
+  }
+  MemCharge(const MemCharge &) = delete;
+  MemCharge &operator=(const MemCharge &) = delete;
+
+  // Re-size the charge (e.g. after the owner grew its buffer).
+  void set(std::size_t bytes) {
+    if (bytes > bytes_)
+      mem_add(s_, bytes - bytes_);
+    else if (bytes < bytes_)
+      mem_sub(s_, bytes_ - bytes);
+    bytes_ = bytes;
+  }
+  [[nodiscard]] std::size_t bytes() const { return bytes_; }
+
+private:
+  MemSubsystem s_;
+  std::size_t bytes_ = 0;
+};
+
+inline void print_mem_report(std::ostream &os) {
+  const auto kib = [](std::size_t b) { return double(b) / 1024.0; };
+  const auto flags = os.flags();
+  os << "Memory by subsystem:\n"
+     << "  subsystem     current KiB     peak KiB\n";
+  MemUsage total;
+  for (std::size_t i = 0; i < kMemSubsystems; ++i) {
+    const auto s = MemSubsystem(i);
+    const MemUsage u = mem_usage(s);
+    total.current += u.current;
+    total.peak += u.peak;
+    os << "  " << std::left << std::setw(12) << mem_subsystem_name(s)
+       << std::right << std::fixed << std::setprecision(1) << std::setw(13)
+       << kib(u.current) << std::setw(13) << kib(u.peak) << "\n";
+  }
+  os << "  " << std::left << std::setw(12) << "total" << std::right
+     << std::setw(13) << kib(total.current) << std::setw(13) << kib(total.peak)
+     << "   (peaks summed)\n";
+  os.flags(flags);
+}
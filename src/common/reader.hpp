@@ -1,33 +1,45 @@
 // src/reader.hpp
 // Tiny safe cursor for big-endian reads + MIDI VLQ.
+// Non-owning: the bytes (a file buffer or a mapped pack entry) must outlive
+// the cursor.
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
 #include <vector>
 
+// Thrown when a read runs past the end: malformed input for whole files, or
+// "wait for more bytes" for the streaming parser (midi::SmfStreamParser).
+struct BytesEof : std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
 struct Bytes {
-  std::vector<std::uint8_t> data;
+  const std::uint8_t *data = nullptr;
+  std::size_t size = 0;
   std::size_t off = 0; // current read position
 
-  explicit Bytes(const std::vector<std::uint8_t> &src) : data(src), off(0) {}
+  Bytes(const std::uint8_t *p, std::size_t n) : data(p), size(n) {}
+  explicit Bytes(const std::vector<std::uint8_t> &src)
+      : Bytes(src.data(), src.size()) {}
 
   [[nodiscard]] std::uint8_t u8() {
-    if (off + 1 > data.size())
-      throw std::runtime_error("EOF while reading u8");
+    if (off + 1 > size)
+      throw BytesEof("EOF while reading u8");
     return data[off++];
   }
 
   [[nodiscard]] std::uint16_t be16() {
-    if (off + 2 > data.size())
-      throw std::runtime_error("EOF while reading be16");
+    if (off + 2 > size)
+      throw BytesEof("EOF while reading be16");
     std::uint16_t hi = data[off], lo = data[off + 1];
     off += 2;
     return static_cast<std::uint16_t>((hi << 8) | lo);
   }
 
   [[nodiscard]] std::uint32_t be32() {
-    if (off + 4 > data.size())
-      throw std::runtime_error("EOF while reading be32");
+    if (off + 4 > size)
+      throw BytesEof("EOF while reading be32");
     std::uint32_t b0 = data[off], b1 = data[off + 1], b2 = data[off + 2],
                   b3 = data[off + 3];
     off += 4;
@@ -35,8 +47,8 @@ struct Bytes {
   }
 
   void skip(std::size_t n) {
-    if (off + n > data.size())
-      throw std::runtime_error("EOF while skipping bytes");
+    if (off + n > size)
+      throw BytesEof("EOF while skipping bytes");
     off += n;
   }
 };
@@ -0,0 +1,87 @@
+// src/common/snapshot.hpp
+// Byte writer/reader for render-state checkpoints (Synth, SendEffects and
+// OfflineRender save_state/load_state).
+//
+//   StateWriter w;
+//   w.put(pos);                       // any trivially copyable value
+//   w.put_array(buf.data(), buf.size());
+//   StateReader r(w.bytes());
+//   pos = r.get<std::size_t>();
+//   r.get_array(buf.data(), buf.size());
+//
+// Values are stored in native byte order and layout: a checkpoint resumes on
+// the build (and CPU architecture) that wrote it, which is all a killed
+// render needs. Formats guard themselves with a tag and struct sizes.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class StateWriter {
+public:
+  template <class T> void put(const T &v) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    put_raw(&v, sizeof v);
+  }
+  template <class T> void put_array(const T *p, std::size_t n) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    put(std::uint64_t(n));
+    put_raw(p, n * sizeof(T));
+  }
+  void put_raw(const void *p, std::size_t n) {
+    const auto *b = static_cast<const std::uint8_t *>(p);
+    bytes_.insert(bytes_.end(), b, b + n);
+  }
+
+  [[nodiscard]] const std::vector<std::uint8_t> &bytes() const {
+    return bytes_;
+  }
+
+private:
+  std::vector<std::uint8_t> bytes_;
+};
+
+// Throws std::runtime_error on a truncated or mismatched checkpoint.
+class StateReader {
+public:
+  StateReader(const std::uint8_t *p, std::size_t n) : data_(p), size_(n) {}
+  explicit StateReader(const std::vector<std::uint8_t> &src)
+      : StateReader(src.data(), src.size()) {}
+
+  template <class T> [[nodiscard]] T get() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T v;
+    get_raw(&v, sizeof v);
+    return v;
+  }
+  // The stored count must be `n`: arrays are sized by the reader's own
+  // configuration (sample rate, voice count), never by the file.
+  template <class T> void get_array(T *p, std::size_t n) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (get<std::uint64_t>() != n)
+      throw std::runtime_error("Checkpoint does not match this render");
+    get_raw(p, n * sizeof(T));
+  }
+  void get_raw(void *p, std::size_t n) {
+    if (off_ + n > size_)
+      throw std::runtime_error("Truncated checkpoint");
+    std::memcpy(p, data_ + off_, n);
+    off_ += n;
+  }
+  // Compare a tag or size written by the same code path.
+  template <class T> void expect(const T &v, const char *what) {
+    if (get<T>() != v)
+      throw std::runtime_error(std::string("Checkpoint mismatch: ") + what);
+  }
+
+  [[nodiscard]] bool at_end() const { return off_ == size_; }
+
+private:
+  const std::uint8_t *data_;
+  std::size_t size_;
+  std::size_t off_ = 0;
+};
@@ -0,0 +1,53 @@
+// src/common/spsc_queue.hpp
+// Bounded single-producer / single-consumer ring buffer.
+// Lock-free and allocation-free after construction, so the consumer side is
+// safe to use from the real-time audio callback.
+//
+// Contract:
+//  - Exactly one thread calls push(); exactly one thread calls front()/pop().
+//  - Capacity is rounded up to a power of two; one slot stays empty.
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+template <typename T> class SpscQueue {
+public:
+  explicit SpscQueue(std::size_t capacity) {
+    std::size_t n = 2;
+    while (n < capacity + 1)
+      n <<= 1;
+    buf_.resize(n);
+    mask_ = n - 1;
+  }
+
+  // Producer: false if the queue is full (the item is dropped).
+  bool push(const T &v) {
+    const std::size_t h = head_.load(std::memory_order_relaxed);
+    const std::size_t next = (h + 1) & mask_;
+    if (next == tail_.load(std::memory_order_acquire))
+      return false;
+    buf_[h] = v;
+    head_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer: oldest item, or nullptr when empty. Valid until pop().
+  const T *front() const {
+    const std::size_t t = tail_.load(std::memory_order_relaxed);
+    if (t == head_.load(std::memory_order_acquire))
+      return nullptr;
+    return &buf_[t];
+  }
+
+  void pop() {
+    const std::size_t t = tail_.load(std::memory_order_relaxed);
+    tail_.store((t + 1) & mask_, std::memory_order_release);
+  }
+
+private:
+  std::vector<T> buf_;
+  std::size_t mask_ = 0;
+  alignas(64) std::atomic<std::size_t> head_{0}; // written by producer
+  alignas(64) std::atomic<std::size_t> tail_{0}; // written by consumer
+};
@@ -16,7 +16,16 @@ inline std::vector<std::uint8_t> read_all(const std::string &path) {
   f.seekg(0, std::ios::end);
   std::streamsize sz = f.tellg();
   if (sz < 0) {
-    throw std::runtime_error("Could not get size of file: " + path);
+    // Not seekable (a pipe or FIFO): read until EOF instead.
+    f.clear();
+    std::vector<std::uint8_t> buf;
+    char chunk[65536];
+    while (f.read(chunk, sizeof chunk) || f.gcount() > 0)
+      buf.insert(buf.end(), chunk, chunk + f.gcount());
+    if (f.bad()) {
+      throw std::runtime_error("Could not read file: " + path);
+    }
+    return buf;
   }
   std::vector<std::uint8_t> buf(static_cast<std::size_t>(sz));
   f.seekg(0, std::ios::beg);
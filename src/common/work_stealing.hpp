@@ -0,0 +1,112 @@
+// src/common/work_stealing.hpp
+// Parallel loop over [0, count) with work stealing, for batch scans where
+// items vary wildly in cost (a 200-byte ringtone next to a 2 MB orchestral
+// score).
+//
+//   parallel_for_stealing(files.size(), workers, [&](int w, std::size_t i) {
+//     perWorker[w].add(scan(files[i]));   // w is stable per thread
+//   });
+//
+// Design notes:
+// - Each worker starts with an equal slice of the index range and takes
+//   items from its front. A worker that runs dry steals the back half of
+//   another worker's remaining slice, so one huge file never leaves the
+//   other cores idle behind it.
+// - A slice is one 64-bit atomic (begin << 32 | end): popping and stealing
+//   are single CAS operations, no locks. Slices live on separate cache
+//   lines.
+// - `w` identifies the calling worker (0 is the caller's own thread), so
+//   callers can keep per-worker accumulators without synchronisation and
+//   merge them after the call returns.
+// - Blocks until every item has run. Counts above 2^32 - 1 are not
+//   supported.
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace detail {
+
+struct alignas(64) StealSlice {
+  std::atomic<std::uint64_t> range{0}; // begin << 32 | end
+};
+
+inline std::uint64_t steal_pack(std::uint64_t b, std::uint64_t e) {
+  return b << 32 | e;
+}
+
+// Take the front item of `s`; false if it is empty.
+inline bool steal_pop(StealSlice &s, std::size_t &item) {
+  std::uint64_t cur = s.range.load(std::memory_order_relaxed);
+  for (;;) {
+    const std::uint64_t b = cur >> 32, e = cur & 0xFFFFFFFFu;
+    if (b >= e)
+      return false;
+    if (s.range.compare_exchange_weak(cur, steal_pack(b + 1, e),
+                                      std::memory_order_acquire,
+                                      std::memory_order_relaxed)) {
+      item = std::size_t(b);
+      return true;
+    }
+  }
+}
+
+// Move the back half of `victim` into `mine` (which is empty).
+inline bool steal_half(StealSlice &victim, StealSlice &mine) {
+  std::uint64_t cur = victim.range.load(std::memory_order_relaxed);
+  for (;;) {
+    const std::uint64_t b = cur >> 32, e = cur & 0xFFFFFFFFu;
+    if (b >= e)
+      return false;
+    const std::uint64_t mid = b + (e - b) / 2; // leaves the victim >= 0
+    if (victim.range.compare_exchange_weak(cur, steal_pack(b, mid),
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed)) {
+      mine.range.store(steal_pack(mid, e), std::memory_order_release);
+      return true;
+    }
+  }
+}
+
+} // namespace detail
+
+template <class Fn>
+void parallel_for_stealing(std::size_t count, int workers, Fn &&fn) {
+  workers = std::max(1, workers);
+  std::vector<detail::StealSlice> slices(static_cast<std::size_t>(workers));
+  for (int w = 0; w < workers; ++w) {
+    const std::uint64_t b = count * std::size_t(w) / std::size_t(workers);
+    const std::uint64_t e = count * std::size_t(w + 1) / std::size_t(workers);
+    slices[std::size_t(w)].range.store(detail::steal_pack(b, e),
+                                       std::memory_order_relaxed);
+  }
+
+  const auto run = [&](int w) {
+    detail::StealSlice &mine = slices[std::size_t(w)];
+    std::size_t item = 0;
+    for (;;) {
+      while (detail::steal_pop(mine, item))
+        fn(w, item);
+      // Dry: scan the others once, starting after ourselves.
+      bool stole = false;
+      for (int k = 1; k < workers && !stole; ++k) {
+        stole = detail::steal_half(slices[std::size_t((w + k) % workers)],
+                                   mine);
+      }
+      if (!stole)
+        return; // whatever is left is already owned by a running worker
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(std::size_t(workers - 1));
+  for (int w = 1; w < workers; ++w)
+    threads.emplace_back(run, w);
+  run(0);
+  for (auto &t : threads)
+    t.join();
+}
@@ -0,0 +1,98 @@
+// src/io/file_watch.cpp
+// inotify directory watch (Linux) with a size/mtime polling fallback.
+
+#include "io/file_watch.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace io {
+
+FileWatcher::FileWatcher(std::filesystem::path file)
+    : file_(std::move(file)), name_(file_.filename().string()) {
+#if defined(__linux__)
+  fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd_ < 0) {
+    throw std::runtime_error(std::string("inotify_init1: ") +
+                             std::strerror(errno));
+  }
+  const std::filesystem::path dir =
+      file_.has_parent_path() ? file_.parent_path() : ".";
+  if (::inotify_add_watch(fd_, dir.c_str(),
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+    const int err = errno;
+    ::close(fd_);
+    throw std::runtime_error("Cannot watch " + dir.string() + ": " +
+                             std::strerror(err));
+  }
+#else
+  std::error_code ec;
+  size_ = std::filesystem::file_size(file_, ec);
+  mtime_ = std::filesystem::last_write_time(file_, ec);
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#if defined(__linux__)
+  if (fd_ >= 0)
+    ::close(fd_);
+#endif
+}
+
+#if defined(__linux__)
+
+bool FileWatcher::poll_events() {
+  alignas(inotify_event) char buf[4096];
+  bool hit = false;
+  for (;;) {
+    const ssize_t n = ::read(fd_, buf, sizeof buf);
+    if (n <= 0)
+      break; // EAGAIN: drained
+    for (ssize_t off = 0; off < n;) {
+      const auto *ev = reinterpret_cast<const inotify_event *>(buf + off);
+      if (ev->len > 0 && name_ == ev->name)
+        hit = true;
+      off += ssize_t(sizeof(inotify_event) + ev->len);
+    }
+  }
+  return hit;
+}
+
+#else
+
+bool FileWatcher::poll_events() {
+  std::error_code ec;
+  const std::uintmax_t size = std::filesystem::file_size(file_, ec);
+  if (ec)
+    return false; // mid-rename; try again next poll
+  const auto mtime = std::filesystem::last_write_time(file_, ec);
+  if (ec || (size == size_ && mtime == mtime_))
+    return false;
+  size_ = size;
+  mtime_ = mtime;
+  return true;
+}
+
+#endif
+
+bool FileWatcher::changed() {
+  const auto now = std::chrono::steady_clock::now();
+  if (poll_events()) {
+    dirty_ = true;
+    lastEvent_ = now;
+  }
+  if (!dirty_ || now - lastEvent_ < std::chrono::milliseconds(kSettleMs))
+    return false;
+  dirty_ = false;
+  return true;
+}
+
+} // namespace io
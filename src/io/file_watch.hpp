@@ -0,0 +1,54 @@
+// src/io/file_watch.hpp
+// Notice when a file is rewritten on disk (the --watch hot reload).
+//
+//   io::FileWatcher w(path);
+//   if (w.changed()) reload(io::read_all(path));   // poll from any loop
+//
+// Design notes:
+// - On Linux this is inotify on the file's directory, not the file: editors
+//   and DAWs often save by writing a temp file and renaming it over the
+//   original, which replaces the inode a file watch would be attached to.
+//   We react to IN_CLOSE_WRITE and IN_MOVED_TO/IN_CREATE for our name only.
+// - Elsewhere it falls back to comparing size and mtime on each poll.
+// - changed() never blocks. It reports a burst of writes once, after the
+//   file has been quiet for kSettleMs, so a save that lands in several
+//   writes is not read half-way (the reload also survives that, see
+//   midi::IncrementalSmf, but it would be wasted work).
+// - Throws std::runtime_error if the watch cannot be set up.
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace io {
+
+class FileWatcher {
+public:
+  static constexpr int kSettleMs = 100;
+
+  explicit FileWatcher(std::filesystem::path file);
+  ~FileWatcher();
+  FileWatcher(const FileWatcher &) = delete;
+  FileWatcher &operator=(const FileWatcher &) = delete;
+
+  // True once per settled burst of changes to the file.
+  bool changed();
+
+  [[nodiscard]] const std::filesystem::path &path() const { return file_; }
+
+private:
+  bool poll_events(); // true if an event for our file was pending
+
+  std::filesystem::path file_;
+  std::string name_; // file name inside the watched directory
+  int fd_ = -1;      // inotify instance (Linux)
+  bool dirty_ = false;
+  std::chrono::steady_clock::time_point lastEvent_{};
+  // Polling fallback.
+  std::uintmax_t size_ = 0;
+  std::filesystem::file_time_type mtime_{};
+};
+
+} // namespace io
@@ -15,6 +15,8 @@
 // Throws std::runtime_error on errors (propagated from util.hpp).
 
 #pragma once
+#include <algorithm>
+#include <cctype>
 #include <cstdint>
 #include <filesystem>
 #include <string>
@@ -34,4 +36,13 @@ inline std::vector<std::uint8_t> read_all(const std::filesystem::path &p) {
   return ::read_all(p.string());
 }
 
+// True for the extensions directory scans pick up: .mid, .midi, .smf (any
+// case).
+inline bool is_midi_path(const std::filesystem::path &p) {
+  std::string ext = p.extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(),
+                 [](unsigned char c) { return char(std::tolower(c)); });
+  return ext == ".mid" || ext == ".midi" || ext == ".smf";
+}
+
 } // namespace io
@@ -0,0 +1,216 @@
+// src/io/live_input.cpp
+// POSIX implementation of the live MIDI input stage (see live_input.hpp).
+
+#include "io/live_input.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::uint8_t kStampMarker = 0xF5; // undefined system common byte
+constexpr int kPollTimeoutMs = 50;          // how often the reader checks quit
+
+std::runtime_error sys_error(const std::string &what) {
+  return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+namespace io {
+
+std::int64_t LiveInput::now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+LiveInput::LiveInput(const std::string &spec, std::size_t queueCapacity)
+    : spec_(spec), queue_(queueCapacity) {
+  open_source();
+  reader_ = std::thread([this] { reader_loop(); });
+}
+
+#if defined(_WIN32)
+
+void LiveInput::open_source() {
+  throw std::runtime_error("Live MIDI input is not supported on this platform");
+}
+void LiveInput::reader_loop() {}
+LiveInput::~LiveInput() = default;
+
+#else
+
+void LiveInput::open_source() {
+  const auto colon = spec_.find(':');
+  if (colon == std::string::npos) {
+    throw std::runtime_error("Live input must be unix:<path>, fifo:<path> or "
+                             "udp:<port>, got: " + spec_);
+  }
+  const std::string kind = spec_.substr(0, colon);
+  const std::string arg = spec_.substr(colon + 1);
+
+  if (kind == "unix") {
+    sockaddr_un addr{};
+    if (arg.empty() || arg.size() >= sizeof(addr.sun_path)) {
+      throw std::runtime_error("Bad UNIX socket path: " + arg);
+    }
+    // Only a stale socket from a previous run is replaced, never a file.
+    struct stat st {};
+    if (::lstat(arg.c_str(), &st) == 0) {
+      if (!S_ISSOCK(st.st_mode))
+        throw std::runtime_error("Not a socket: " + arg);
+      if (::unlink(arg.c_str()) != 0)
+        throw sys_error("unlink(" + arg + ")");
+    }
+    fd_ = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd_ < 0)
+      throw sys_error("socket(AF_UNIX)");
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, arg.c_str(), arg.size() + 1);
+    if (::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+      ::close(fd_);
+      throw sys_error("bind(" + arg + ")");
+    }
+    unlinkPath_ = arg;
+    datagram_ = true;
+  } else if (kind == "udp") {
+    int port = 0;
+    try {
+      port = std::stoi(arg);
+    } catch (const std::exception &) {
+      port = 0;
+    }
+    if (port <= 0 || port > 65535) {
+      throw std::runtime_error("Bad UDP port: " + arg);
+    }
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0)
+      throw sys_error("socket(AF_INET)");
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // localhost only
+    if (::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+      ::close(fd_);
+      throw sys_error("bind(127.0.0.1:" + arg + ")");
+    }
+    datagram_ = true;
+  } else if (kind == "fifo") {
+    struct stat st {};
+    if (::stat(arg.c_str(), &st) != 0) {
+      if (::mkfifo(arg.c_str(), 0666) != 0)
+        throw sys_error("mkfifo(" + arg + ")");
+    } else if (!S_ISFIFO(st.st_mode)) {
+      throw std::runtime_error("Not a FIFO: " + arg);
+    }
+    fd_ = ::open(arg.c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd_ < 0)
+      throw sys_error("open(" + arg + ")");
+    // Hold a writer ourselves: otherwise every writer disconnect is an EOF
+    // and poll() would spin on POLLHUP.
+    fifoKeepAlive_ = ::open(arg.c_str(), O_WRONLY | O_NONBLOCK);
+    if (fifoKeepAlive_ < 0) {
+      const auto err = sys_error("open(" + arg + ", O_WRONLY)");
+      ::close(fd_);
+      throw err;
+    }
+    datagram_ = false;
+  } else {
+    throw std::runtime_error("Unknown live input kind '" + kind +
+                             "' (use unix:, fifo: or udp:)");
+  }
+}
+
+LiveInput::~LiveInput() {
+  quit_.store(true, std::memory_order_relaxed);
+  if (reader_.joinable())
+    reader_.join();
+  if (fifoKeepAlive_ >= 0)
+    ::close(fifoKeepAlive_);
+  if (fd_ >= 0)
+    ::close(fd_);
+  if (!unlinkPath_.empty())
+    ::unlink(unlinkPath_.c_str());
+}
+
+void LiveInput::reader_loop() {
+  std::uint8_t buf[4096];
+  pollfd pfd{fd_, POLLIN, 0};
+  while (!quit_.load(std::memory_order_relaxed)) {
+    if (::poll(&pfd, 1, kPollTimeoutMs) <= 0)
+      continue;
+    const ssize_t n = ::read(fd_, buf, sizeof(buf));
+    if (n > 0)
+      handle_bytes(buf, static_cast<std::size_t>(n), datagram_);
+  }
+}
+
+#endif
+
+void LiveInput::handle_bytes(const std::uint8_t *p, std::size_t n,
+                             bool datagram) {
+  const std::int64_t recv = now_ns();
+  std::int64_t due = recv;
+
+  if (datagram) {
+    // Every datagram is self-contained: no running status across packets.
+    parser_.reset();
+    if (n >= 9 && p[0] == kStampMarker) {
+      std::uint64_t stamp = 0;
+      for (int i = 8; i >= 1; --i)
+        stamp = (stamp << 8) | p[i];
+      due = static_cast<std::int64_t>(stamp);
+      p += 9;
+      n -= 9;
+    }
+  }
+
+  midi::ChannelMsg msg;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (!parser_.feed(p[i], msg))
+      continue;
+    if (!queue_.push(LiveEvent{due, recv, msg}))
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void LiveInput::record_applied(const LiveEvent &ev, std::int64_t appliedNs) {
+  if (ev.dueNs > ev.recvNs)
+    return; // scheduled ahead on purpose: not an ASAP latency sample
+  const std::int64_t d = appliedNs > ev.recvNs ? appliedNs - ev.recvNs : 0;
+  const std::uint64_t c = count_.load(std::memory_order_relaxed);
+  if (c == 0 || d < minNs_.load(std::memory_order_relaxed))
+    minNs_.store(d, std::memory_order_relaxed);
+  if (d > maxNs_.load(std::memory_order_relaxed))
+    maxNs_.store(d, std::memory_order_relaxed);
+  sumNs_.fetch_add(static_cast<std::uint64_t>(d), std::memory_order_relaxed);
+  count_.store(c + 1, std::memory_order_relaxed);
+}
+
+LatencyStats LiveInput::latency() const {
+  LatencyStats s;
+  s.count = count_.load(std::memory_order_relaxed);
+  s.dropped = dropped_.load(std::memory_order_relaxed);
+  s.deviceMs = outputLatencyNs_.load(std::memory_order_relaxed) * 1e-6;
+  if (s.count > 0) {
+    s.minMs = minNs_.load(std::memory_order_relaxed) * 1e-6;
+    s.maxMs = maxNs_.load(std::memory_order_relaxed) * 1e-6;
+    s.avgMs = double(sumNs_.load(std::memory_order_relaxed)) / s.count * 1e-6;
+  }
+  return s;
+}
+
+} // namespace io
@@ -0,0 +1,101 @@
+// src/io/live_input.hpp
+// Live MIDI ingestion from other processes on the same host.
+//
+// Sources (the `spec` string):
+//   unix:/tmp/midi.sock   UNIX datagram socket (we bind and own the path)
+//   fifo:/tmp/midi.fifo   named pipe; created if missing, raw byte stream
+//   udp:5004              UDP datagrams on 127.0.0.1:<port>
+//
+// Wire format:
+//  - Raw MIDI bytes (running status, realtime and SysEx are handled by
+//    midi::StreamParser, the same classification the SMF walker uses).
+//  - Datagram sources may prefix a packet with 0xF5 (undefined in MIDI 1.0)
+//    followed by an 8-byte little-endian CLOCK_MONOTONIC timestamp in ns;
+//    those events are held back until that time instead of played ASAP.
+//
+// Threading:
+//  - A private reader thread parses input and pushes LiveEvents into an SPSC
+//    queue. The audio callback is the only consumer: it drains events that are
+//    due before the end of the buffer it is about to render, i.e. they are
+//    stamped to the next callback's first frame.
+//  - The consumer reports each applied event back via record_applied(), which
+//    feeds the published input-to-output latency statistics.
+//
+// Throws std::runtime_error if the source cannot be opened (or on platforms
+// without POSIX sockets).
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "common/spsc_queue.hpp"
+#include "midi/channel.hpp"
+
+namespace io {
+
+// One channel message with steady-clock timestamps (nanoseconds).
+struct LiveEvent {
+  std::int64_t dueNs = 0;  // when it should sound (== recvNs unless stamped)
+  std::int64_t recvNs = 0; // when the reader thread received it
+  midi::ChannelMsg msg;
+};
+
+// Input-to-output latency summary for events played "as soon as possible".
+struct LatencyStats {
+  std::uint64_t count = 0;   // events measured
+  double minMs = 0.0;        // receive -> callback that applied it
+  double avgMs = 0.0;
+  double maxMs = 0.0;
+  double deviceMs = 0.0;     // output buffering added after the callback
+  std::uint64_t dropped = 0; // events lost to a full queue
+};
+
+class LiveInput {
+public:
+  explicit LiveInput(const std::string &spec,
+                     std::size_t queueCapacity = 1024);
+  ~LiveInput();
+
+  LiveInput(const LiveInput &) = delete;
+  LiveInput &operator=(const LiveInput &) = delete;
+
+  // Consumer side (audio thread only).
+  SpscQueue<LiveEvent> &queue() { return queue_; }
+  void record_applied(const LiveEvent &ev, std::int64_t appliedNs);
+
+  // Set by the player once the device buffer size is known.
+  void set_output_latency_ns(std::int64_t ns) {
+    outputLatencyNs_.store(ns, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] LatencyStats latency() const;
+  [[nodiscard]] const std::string &spec() const { return spec_; }
+
+  // Same clock as the timestamps above (steady_clock == CLOCK_MONOTONIC).
+  static std::int64_t now_ns();
+
+private:
+  void open_source();
+  void reader_loop();
+  void handle_bytes(const std::uint8_t *p, std::size_t n, bool datagram);
+
+  std::string spec_;
+  std::string unlinkPath_; // socket path we created, removed on exit
+  int fd_ = -1;
+  int fifoKeepAlive_ = -1; // write end held open so the FIFO never hits EOF
+  bool datagram_ = false;
+
+  SpscQueue<LiveEvent> queue_;
+  midi::StreamParser parser_;
+  std::atomic<bool> quit_{false};
+  std::thread reader_;
+
+  // Written by the consumer only; read by anyone.
+  std::atomic<std::uint64_t> count_{0}, sumNs_{0}, dropped_{0};
+  std::atomic<std::int64_t> minNs_{0}, maxNs_{0}, outputLatencyNs_{0};
+};
+
+} // namespace io
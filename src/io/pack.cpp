@@ -0,0 +1,221 @@
+// src/io/pack.cpp
+// Pack mapping, validation and lookups; the streaming writer.
+
+#include "io/pack.hpp"
+#include "common/hash.hpp"
+#include "common/util.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::runtime_error bad_pack(const std::filesystem::path &path,
+                            const std::string &what) {
+  return std::runtime_error("Bad pack " + path.string() + ": " + what);
+}
+
+} // namespace
+
+namespace io {
+
+PackReader::PackReader(const std::filesystem::path &path) {
+#if defined(_WIN32)
+  owned_ = ::read_all(path.string());
+  base_ = owned_.data();
+  mapped_ = owned_.size();
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open pack " + path.string() + ": " +
+                             std::strerror(errno));
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || st.st_size < 0) {
+    ::close(fd);
+    throw std::runtime_error("Could not stat pack: " + path.string());
+  }
+  mapped_ = static_cast<std::size_t>(st.st_size);
+  void *p = mapped_ ? ::mmap(nullptr, mapped_, PROT_READ, MAP_PRIVATE, fd, 0)
+                    : MAP_FAILED;
+  ::close(fd); // the mapping keeps the file referenced
+  if (p == MAP_FAILED) {
+    mapped_ = 0;
+    throw bad_pack(path, "cannot map (empty file?)");
+  }
+  base_ = static_cast<const std::uint8_t *>(p);
+#endif
+
+  // Validate everything once so lookups can trust offsets.
+  // (A throwing constructor runs no destructor: unmap by hand.)
+  const auto fail = [&](const char *what) {
+    unmap();
+    return bad_pack(path, what);
+  };
+  PackHeader h{};
+  if (mapped_ < sizeof h)
+    throw fail("truncated header");
+  std::memcpy(&h, base_, sizeof h);
+  if (h.magic != kPackMagic)
+    throw fail("wrong magic or byte order");
+  if (h.version != kPackVersion)
+    throw fail("unsupported version");
+  if (h.fileSize != mapped_)
+    throw fail("size mismatch (truncated?)");
+  // Header fields are untrusted: compare in subtraction form so a huge
+  // offset or count cannot wrap past the checks.
+  const auto within = [](std::uint64_t off, std::uint64_t len,
+                         std::uint64_t limit) {
+    return off <= limit && len <= limit - off;
+  };
+  const std::uint64_t n = h.count;
+  if (h.indexOffset % alignof(PackEntry) != 0 ||
+      h.byHashOffset % alignof(std::uint32_t) != 0 ||
+      h.indexOffset < sizeof h || n > mapped_ / sizeof(PackEntry) ||
+      !within(h.indexOffset, n * sizeof(PackEntry), mapped_) ||
+      !within(h.byHashOffset, n * sizeof(std::uint32_t), mapped_) ||
+      !within(h.namesOffset, h.namesSize, mapped_))
+    throw fail("index out of range");
+  entries_ = reinterpret_cast<const PackEntry *>(base_ + h.indexOffset);
+  byHash_ = reinterpret_cast<const std::uint32_t *>(base_ + h.byHashOffset);
+  names_ = reinterpret_cast<const char *>(base_ + h.namesOffset);
+  count_ = static_cast<std::size_t>(n);
+  for (std::size_t i = 0; i < count_; ++i) {
+    const PackEntry &e = entries_[i];
+    // SMF bytes lie between the header and the index.
+    if (e.offset < sizeof h || !within(e.offset, e.length, h.indexOffset) ||
+        std::uint64_t(e.nameOffset) + e.nameLength > h.namesSize ||
+        byHash_[i] >= count_)
+      throw fail("entry out of range");
+  }
+}
+
+PackReader::~PackReader() { unmap(); }
+
+void PackReader::unmap() {
+#if !defined(_WIN32)
+  if (mapped_)
+    ::munmap(const_cast<std::uint8_t *>(base_), mapped_);
+#endif
+  mapped_ = 0;
+  base_ = nullptr;
+}
+
+const PackEntry *PackReader::find(std::string_view name) const {
+  const PackEntry *it = std::lower_bound(
+      begin(), end(), name, [this](const PackEntry &e, std::string_view k) {
+        return this->name(e) < k;
+      });
+  return it != end() && this->name(*it) == name ? it : nullptr;
+}
+
+const PackEntry *PackReader::find_hash(std::uint64_t contentHash) const {
+  const std::uint32_t *it = std::lower_bound(
+      byHash_, byHash_ + count_, contentHash,
+      [this](std::uint32_t i, std::uint64_t k) {
+        return entries_[i].contentHash < k;
+      });
+  return it != byHash_ + count_ && entries_[*it].contentHash == contentHash
+             ? entries_ + *it
+             : nullptr;
+}
+
+void PackReader::advise_sequential() const {
+#if !defined(_WIN32)
+  if (mapped_) {
+    ::madvise(const_cast<std::uint8_t *>(base_), mapped_,
+              MADV_SEQUENTIAL | MADV_WILLNEED);
+  }
+#endif
+}
+
+PackWriter::PackWriter(const std::filesystem::path &path)
+    : path_(path), out_(path, std::ios::binary | std::ios::trunc) {
+  if (!out_)
+    throw std::runtime_error("Could not create pack: " + path.string());
+  const PackHeader placeholder{};
+  out_.write(reinterpret_cast<const char *>(&placeholder), sizeof placeholder);
+}
+
+void PackWriter::add(std::string_view name, const std::uint8_t *data,
+                     std::size_t size, const PackProbe &probe) {
+  if (name.empty() || name.size() > 0xFFFF)
+    throw std::runtime_error("Pack entry name must be 1..65535 bytes");
+  if (size > 0xFFFFFFFFu)
+    throw std::runtime_error("Pack entry too large: " + std::string(name));
+  PackEntry e{};
+  e.contentHash = fnv1a(data, size);
+  e.offset = offset_;
+  e.length = static_cast<std::uint32_t>(size);
+  e.nameOffset = static_cast<std::uint32_t>(names_.size());
+  e.nameLength = static_cast<std::uint16_t>(name.size());
+  e.format = probe.format;
+  e.nTracks = probe.nTracks;
+  e.division = probe.division;
+  e.notes = probe.notes;
+  e.durationMs = probe.durationMs;
+  out_.write(reinterpret_cast<const char *>(data),
+             static_cast<std::streamsize>(size));
+  offset_ += size;
+  names_.append(name);
+  entries_.push_back(e);
+}
+
+std::size_t PackWriter::finish() {
+  const auto name_of = [this](const PackEntry &e) {
+    return std::string_view(names_).substr(e.nameOffset, e.nameLength);
+  };
+  std::sort(entries_.begin(), entries_.end(),
+            [&](const PackEntry &a, const PackEntry &b) {
+              return name_of(a) < name_of(b);
+            });
+  for (std::size_t i = 1; i < entries_.size(); ++i) {
+    if (name_of(entries_[i]) == name_of(entries_[i - 1])) {
+      throw std::runtime_error("Duplicate pack entry: " +
+                               std::string(name_of(entries_[i])));
+    }
+  }
+  std::vector<std::uint32_t> byHash(entries_.size());
+  std::iota(byHash.begin(), byHash.end(), 0u);
+  std::sort(byHash.begin(), byHash.end(),
+            [this](std::uint32_t a, std::uint32_t b) {
+              return entries_[a].contentHash < entries_[b].contentHash;
+            });
+
+  PackHeader h{};
+  h.magic = kPackMagic;
+  h.version = kPackVersion;
+  h.count = entries_.size();
+  const std::uint64_t pad = (8 - offset_ % 8) % 8; // align the index
+  const char zeros[8] = {};
+  out_.write(zeros, static_cast<std::streamsize>(pad));
+  h.indexOffset = offset_ + pad;
+  h.byHashOffset = h.indexOffset + entries_.size() * sizeof(PackEntry);
+  h.namesOffset = h.byHashOffset + byHash.size() * sizeof(std::uint32_t);
+  h.namesSize = names_.size();
+  h.fileSize = h.namesOffset + h.namesSize;
+  out_.write(reinterpret_cast<const char *>(entries_.data()),
+             static_cast<std::streamsize>(entries_.size() * sizeof(PackEntry)));
+  out_.write(
+      reinterpret_cast<const char *>(byHash.data()),
+      static_cast<std::streamsize>(byHash.size() * sizeof(std::uint32_t)));
+  out_.write(names_.data(), static_cast<std::streamsize>(names_.size()));
+  out_.seekp(0);
+  out_.write(reinterpret_cast<const char *>(&h), sizeof h);
+  out_.close();
+  if (!out_)
+    throw std::runtime_error("Could not write pack: " + path_.string());
+  return entries_.size();
+}
+
+} // namespace io
@@ -0,0 +1,138 @@
+// src/io/pack.hpp
+// Packed MIDI corpus: many SMF files in one file with a sorted index, read
+// through a single memory mapping.
+//
+//   io::PackReader pack("catalog.mpk");
+//   if (const io::PackEntry *e = pack.find("jazz/take5.mid"))
+//     song = midi::parse_smf(pack.data(*e), e->length);   // in place
+//   for (const io::PackEntry &e : pack) ...               // sequential scan
+//
+// Layout (host byte order; the magic doubles as an endianness check):
+//   PackHeader
+//   SMF bytes      one blob per entry, back to back, in the order added
+//   PackEntry[n]   sorted by name
+//   uint32[n]      entry indices sorted by content hash
+//   names          UTF-8, not terminated; entries hold offset + length
+//
+// Design notes:
+// - Opening a catalog file costs one open() and one mmap() instead of a
+//   metadata lookup and a small read per song; a scan in index order walks
+//   the blobs front to back when they were added in name order (midi_pack
+//   does), so the kernel sees one sequential read.
+// - Each entry carries probe metadata (format, tracks, division, notes,
+//   duration) computed at pack time, so listing and filtering a catalog
+//   never parses MIDI.
+// - Lookups are binary searches: by name over the index, by content hash
+//   (FNV-1a of the SMF bytes, common/hash.hpp) over the hash order.
+// - Everything is validated once on open; afterwards data() and name() are
+//   plain pointer arithmetic. Without mmap (Windows) the file is read whole.
+// - Throws std::runtime_error on I/O errors or a malformed pack.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace io {
+
+constexpr std::uint32_t kPackMagic = 0x4B41504D; // "MPAK" little-endian
+constexpr std::uint32_t kPackVersion = 1;
+
+struct PackHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t count;
+  std::uint64_t indexOffset;  // PackEntry[count]
+  std::uint64_t byHashOffset; // uint32[count]
+  std::uint64_t namesOffset;
+  std::uint64_t namesSize;
+  std::uint64_t fileSize;
+  std::uint64_t reserved;
+};
+
+// Probe metadata, filled in by whoever builds the pack.
+struct PackProbe {
+  std::uint16_t format = 0;
+  std::uint16_t nTracks = 0;
+  std::uint16_t division = 0;
+  std::uint32_t notes = 0;      // NoteOn events
+  std::uint32_t durationMs = 0; // last event, through the tempo map
+};
+
+struct PackEntry {
+  std::uint64_t contentHash;
+  std::uint64_t offset; // SMF bytes, from the start of the pack
+  std::uint32_t length;
+  std::uint32_t nameOffset; // into the name table
+  std::uint16_t nameLength;
+  std::uint16_t format;
+  std::uint16_t nTracks;
+  std::uint16_t division;
+  std::uint32_t notes;
+  std::uint32_t durationMs;
+};
+static_assert(sizeof(PackHeader) == 64, "PackHeader is an on-disk layout");
+static_assert(sizeof(PackEntry) == 40, "PackEntry is an on-disk layout");
+
+class PackReader {
+public:
+  explicit PackReader(const std::filesystem::path &path);
+  ~PackReader();
+  PackReader(const PackReader &) = delete;
+  PackReader &operator=(const PackReader &) = delete;
+
+  [[nodiscard]] std::size_t size() const { return count_; }
+  // Entries in name order.
+  [[nodiscard]] const PackEntry *begin() const { return entries_; }
+  [[nodiscard]] const PackEntry *end() const { return entries_ + count_; }
+
+  [[nodiscard]] std::string_view name(const PackEntry &e) const {
+    return {names_ + e.nameOffset, e.nameLength};
+  }
+  [[nodiscard]] const std::uint8_t *data(const PackEntry &e) const {
+    return base_ + e.offset;
+  }
+
+  // nullptr if absent.
+  [[nodiscard]] const PackEntry *find(std::string_view name) const;
+  [[nodiscard]] const PackEntry *find_hash(std::uint64_t contentHash) const;
+
+  // Hint that the whole pack is about to be read front to back.
+  void advise_sequential() const;
+
+private:
+  void unmap();
+
+  const std::uint8_t *base_ = nullptr;
+  std::size_t mapped_ = 0;
+  std::vector<std::uint8_t> owned_; // fallback without mmap
+  const PackEntry *entries_ = nullptr;
+  const std::uint32_t *byHash_ = nullptr;
+  const char *names_ = nullptr;
+  std::size_t count_ = 0;
+};
+
+// Streams blobs to disk as they are added; finish() writes the index.
+class PackWriter {
+public:
+  explicit PackWriter(const std::filesystem::path &path);
+
+  // Names must be unique (checked in finish()) and under 64 KiB.
+  void add(std::string_view name, const std::uint8_t *data, std::size_t size,
+           const PackProbe &probe);
+  // Sort and write the index and name table. Returns the entry count.
+  std::size_t finish();
+
+private:
+  std::filesystem::path path_;
+  std::ofstream out_;
+  std::uint64_t offset_ = sizeof(PackHeader);
+  std::vector<PackEntry> entries_;
+  std::string names_;
+};
+
+} // namespace io
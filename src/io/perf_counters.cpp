@@ -0,0 +1,281 @@
+// src/io/perf_counters.cpp
+// perf_event_open counter groups per thread and the per-stage totals.
+
+#include "io/perf_counters.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace io {
+
+namespace detail {
+std::atomic<bool> g_perfOn{false};
+}
+
+namespace {
+
+constexpr const char *kCounterNames[kPerfCounters] = {
+    "cycles", "instructions", "cache-misses", "branch-misses"};
+
+struct StageAcc {
+  std::atomic<std::uint64_t> calls{0}, threads{0}, units{0}, wallNs{0};
+  std::atomic<std::uint64_t> counts[kPerfCounters] = {};
+};
+StageAcc g_stages[kPerfStages];
+
+std::atomic<unsigned> g_opened{0}; // union of every thread's counter mask
+std::mutex g_statusMutex;
+std::string g_failures[kPerfCounters]; // first failure per counter
+
+void note_failure(PerfCounter c, const std::string &why) {
+  std::lock_guard<std::mutex> lock(g_statusMutex);
+  if (g_failures[c].empty())
+    g_failures[c] = why;
+}
+
+std::string describe_errno(int err) {
+  switch (err) {
+  case ENOENT:
+  case EOPNOTSUPP:
+    return "not supported here (no PMU, or a VM without one)";
+  case EACCES:
+  case EPERM:
+    return "not permitted (see /proc/sys/kernel/perf_event_paranoid)";
+  default:
+    return std::strerror(err);
+  }
+}
+
+std::uint64_t now_ns() {
+  return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count());
+}
+
+// The calling thread's counter group, opened on first use.
+class ThreadGroup {
+public:
+  ThreadGroup() { open(); }
+  ~ThreadGroup() {
+#if defined(__linux__)
+    for (int fd : fds_)
+      if (fd >= 0)
+        ::close(fd);
+#endif
+  }
+  ThreadGroup(const ThreadGroup &) = delete;
+  ThreadGroup &operator=(const ThreadGroup &) = delete;
+
+  [[nodiscard]] unsigned mask() const { return mask_; }
+  unsigned stagesSeen = 0; // bit per PerfStage
+
+  // Current counts (scaled for multiplexing); missing counters read 0.
+  void read(std::uint64_t out[kPerfCounters]) const {
+    for (std::size_t c = 0; c < kPerfCounters; ++c)
+      out[c] = 0;
+#if defined(__linux__)
+    if (leader_ < 0)
+      return;
+    // PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING
+    std::uint64_t buf[3 + kPerfCounters];
+    if (::read(leader_, buf, sizeof buf) < 0)
+      return;
+    const std::uint64_t nr = buf[0], enabled = buf[1], running = buf[2];
+    const double scale =
+        running > 0 && running < enabled ? double(enabled) / running : 1.0;
+    for (std::size_t c = 0; c < kPerfCounters; ++c) {
+      if (slot_[c] >= 0 && std::uint64_t(slot_[c]) < nr)
+        out[c] = std::uint64_t(double(buf[3 + slot_[c]]) * scale);
+    }
+#endif
+  }
+
+private:
+  void open() {
+#if defined(__linux__)
+    static constexpr std::uint64_t kConfigs[kPerfCounters] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    int members = 0;
+    for (std::size_t c = 0; c < kPerfCounters; ++c) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof attr;
+      attr.config = kConfigs[c];
+      attr.disabled = leader_ < 0 ? 1 : 0; // the group starts on enable
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+      const int fd = int(::syscall(SYS_perf_event_open, &attr, 0, -1,
+                                   leader_, PERF_FLAG_FD_CLOEXEC));
+      if (fd < 0) {
+        note_failure(PerfCounter(c), describe_errno(errno));
+        continue;
+      }
+      fds_[c] = fd;
+      if (leader_ < 0)
+        leader_ = fd;
+      slot_[c] = members++;
+      mask_ |= 1u << c;
+    }
+    if (leader_ >= 0 &&
+        ::ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) < 0) {
+      note_failure(Cycles, "enable: " + describe_errno(errno));
+      mask_ = 0;
+      leader_ = -1;
+    }
+#else
+    note_failure(Cycles, "perf_event_open is Linux-only");
+#endif
+    g_opened.fetch_or(mask_, std::memory_order_relaxed);
+  }
+
+  int fds_[kPerfCounters] = {-1, -1, -1, -1};
+  int slot_[kPerfCounters] = {-1, -1, -1, -1}; // position in a group read
+  int leader_ = -1;
+  unsigned mask_ = 0;
+};
+
+ThreadGroup &thread_group() {
+  thread_local ThreadGroup group;
+  return group;
+}
+
+double per_unit(std::uint64_t v, std::uint64_t units) {
+  return units ? double(v) / double(units) : 0.0;
+}
+
+} // namespace
+
+void perf_enable() { detail::g_perfOn.store(true); }
+
+unsigned perf_available() { return thread_group().mask(); }
+
+std::string perf_status() {
+  std::lock_guard<std::mutex> lock(g_statusMutex);
+  bool same = true;
+  for (const std::string &f : g_failures)
+    same = same && f == g_failures[0];
+  if (same)
+    return g_failures[0]; // all four for one reason, or none failed
+  std::string out;
+  for (std::size_t c = 0; c < kPerfCounters; ++c) {
+    if (g_failures[c].empty())
+      continue;
+    if (!out.empty())
+      out += "; ";
+    out += std::string(kCounterNames[c]) + ": " + g_failures[c];
+  }
+  return out;
+}
+
+PerfTotals perf_totals(PerfStage s) {
+  const StageAcc &a = g_stages[std::size_t(s)];
+  PerfTotals t;
+  t.calls = a.calls.load(std::memory_order_relaxed);
+  t.threads = a.threads.load(std::memory_order_relaxed);
+  t.units = a.units.load(std::memory_order_relaxed);
+  t.wallNs = a.wallNs.load(std::memory_order_relaxed);
+  for (std::size_t c = 0; c < kPerfCounters; ++c)
+    t.counts[c] = a.counts[c].load(std::memory_order_relaxed);
+  return t;
+}
+
+const char *perf_stage_name(PerfStage s) {
+  static constexpr const char *kNames[kPerfStages] = {
+      "parse", "tempo", "schedule", "sf2 load", "render"};
+  return kNames[std::size_t(s)];
+}
+
+const char *perf_unit_name(PerfStage s) {
+  switch (s) {
+  case PerfStage::Render:
+    return "sample";
+  case PerfStage::Sf2Load:
+    return "call";
+  default:
+    return "event";
+  }
+}
+
+void PerfScope::begin() {
+  ThreadGroup &g = thread_group();
+  const unsigned bit = 1u << unsigned(stage_);
+  if (!(g.stagesSeen & bit)) {
+    g.stagesSeen |= bit;
+    g_stages[std::size_t(stage_)].threads.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  t0_ = now_ns();
+  g.read(start_); // last, so the counters see as little of us as possible
+}
+
+void PerfScope::end() {
+  std::uint64_t stop[kPerfCounters];
+  thread_group().read(stop);
+  const std::uint64_t t1 = now_ns();
+  StageAcc &a = g_stages[std::size_t(stage_)];
+  a.calls.fetch_add(1, std::memory_order_relaxed);
+  a.units.fetch_add(stage_ == PerfStage::Sf2Load ? 1 : units_,
+                    std::memory_order_relaxed);
+  a.wallNs.fetch_add(t1 - t0_, std::memory_order_relaxed);
+  for (std::size_t c = 0; c < kPerfCounters; ++c) {
+    if (stop[c] > start_[c])
+      a.counts[c].fetch_add(stop[c] - start_[c], std::memory_order_relaxed);
+  }
+}
+
+void print_perf_report(std::ostream &os) {
+  const unsigned have = g_opened.load(std::memory_order_relaxed);
+  const auto flags = os.flags();
+  os << "Hardware counters (user space, all threads):\n";
+  if (have != (1u << kPerfCounters) - 1) {
+    const std::string why = perf_status();
+    os << "  unavailable: " << (why.empty() ? "not opened" : why) << "\n";
+    if (!have)
+      os << "  (wall time only)\n";
+  }
+  os << "  stage      calls thr   wall ms  ns/unit   Mcycles    IPC"
+        "  cache-miss  branch-miss  per\n";
+  const auto cell = [&](bool ok, double v, int w, int prec) {
+    if (ok)
+      os << std::setw(w) << std::setprecision(prec) << v;
+    else
+      os << std::setw(w) << "-";
+  };
+  for (std::size_t i = 0; i < kPerfStages; ++i) {
+    const auto s = PerfStage(i);
+    const PerfTotals t = perf_totals(s);
+    if (t.calls == 0)
+      continue;
+    const std::uint64_t *n = t.counts;
+    os << "  " << std::left << std::setw(9) << perf_stage_name(s) << std::right
+       << std::fixed << std::setw(6) << t.calls << std::setw(4) << t.threads;
+    cell(true, double(t.wallNs) / 1e6, 10, 3);
+    cell(t.units > 0, per_unit(t.wallNs, t.units), 9, 1);
+    cell(have & (1u << Cycles), double(n[Cycles]) / 1e6, 10, 2);
+    cell((have & (1u << Cycles)) && (have & (1u << Instructions)) &&
+             n[Cycles] > 0,
+         double(n[Instructions]) / double(n[Cycles] ? n[Cycles] : 1), 7, 2);
+    cell(have & (1u << CacheMisses), per_unit(n[CacheMisses], t.units), 12,
+         4);
+    cell(have & (1u << BranchMisses), per_unit(n[BranchMisses], t.units), 13,
+         4);
+    os << "  " << perf_unit_name(s) << "\n";
+  }
+  os.flags(flags);
+}
+
+} // namespace io
@@ -0,0 +1,115 @@
+// src/io/perf_counters.hpp
+// Hardware performance counters per pipeline stage (--perf): cycles,
+// instructions, cache misses and branch misses around parse, tempo map,
+// schedule, SoundFont load and every render block.
+//
+//   io::perf_enable();                       // once, before the work
+//   {
+//     io::PerfScope scope(io::PerfStage::Parse);
+//     song = midi::parse_smf(bytes);
+//     scope.set_units(song.notes.size() + song.ctrls.size());
+//   }
+//   io::print_perf_report(std::cout);        // IPC, misses per event/sample
+//
+// Design notes:
+// - Linux only, through perf_event_open(2): one counter group per thread
+//   (cycles leads, the others follow), opened the first time that thread
+//   enters a scope, user space only, so perf_event_paranoid <= 2 suffices.
+//   A scope reads the group once at each end (one read(2) each) and adds
+//   the difference to its stage's totals.
+// - Totals are relaxed atomics shared by all threads, so stages that run on
+//   several threads (render blocks on the fork-join pool) sum up; the
+//   report also counts how many threads contributed.
+// - Degrades instead of failing: when a counter cannot be opened (no PMU in
+//   a VM, paranoid setting, another OS) it is reported as unavailable and
+//   the rest still work; without any counter only wall time is kept.
+// - Disabled scopes cost one relaxed load. The first scope on a thread makes
+//   the perf_event_open calls, so the audio thread pays them once, in its
+//   first block.
+// - Counts are scaled by time enabled / time running when the kernel
+//   multiplexes the PMU.
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace io {
+
+enum class PerfStage : std::uint8_t { Parse, Tempo, Schedule, Sf2Load, Render };
+constexpr std::size_t kPerfStages = 5;
+
+enum PerfCounter : std::uint8_t {
+  Cycles,
+  Instructions,
+  CacheMisses,
+  BranchMisses
+};
+constexpr std::size_t kPerfCounters = 4;
+
+struct PerfTotals {
+  std::uint64_t calls = 0;
+  std::uint64_t threads = 0; // distinct threads that entered the stage
+  std::uint64_t units = 0;   // events or samples, see perf_unit_name()
+  std::uint64_t wallNs = 0;
+  std::uint64_t counts[kPerfCounters] = {};
+};
+
+namespace detail {
+extern std::atomic<bool> g_perfOn;
+}
+
+// Start counting in every PerfScope from now on.
+void perf_enable();
+inline bool perf_enabled() {
+  return detail::g_perfOn.load(std::memory_order_relaxed);
+}
+
+// Which counters the calling thread could open, as a bit mask over
+// PerfCounter; opens them if this thread has not yet.
+unsigned perf_available();
+// Why counters are missing (empty when all four opened).
+std::string perf_status();
+
+PerfTotals perf_totals(PerfStage s);
+const char *perf_stage_name(PerfStage s);
+const char *perf_unit_name(PerfStage s); // "event", "sample" or "call"
+
+// Counts one stage on the calling thread from construction to stop() or
+// destruction.
+class PerfScope {
+public:
+  explicit PerfScope(PerfStage s) : stage_(s), on_(perf_enabled()) {
+    if (on_)
+      begin();
+  }
+  ~PerfScope() { stop(); }
+  PerfScope(const PerfScope &) = delete;
+  PerfScope &operator=(const PerfScope &) = delete;
+
+  void set_units(std::uint64_t n) { units_ = n; }
+  // End the measurement early (the destructor then does nothing).
+  void stop() {
+    if (on_)
+      end();
+    on_ = false;
+  }
+
+private:
+  void begin();
+  void end();
+
+  PerfStage stage_;
+  bool on_;
+  std::uint64_t units_ = 0;
+  std::uint64_t t0_ = 0;
+  std::uint64_t start_[kPerfCounters] = {};
+};
+
+// Per-stage table: calls, threads, cycles, instructions, IPC, and misses
+// per unit. Stages never entered are left out.
+void print_perf_report(std::ostream &os);
+
+} // namespace io
@@ -0,0 +1,152 @@
+// src/io/readahead.cpp
+// Windowed I/O thread pool with fadvise hints.
+
+#include "io/readahead.hpp"
+#include "common/util.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace io {
+
+Readahead::Readahead(std::vector<std::filesystem::path> paths,
+                     std::size_t inFlight, int ioThreads)
+    : paths_(std::move(paths)), window_(std::max<std::size_t>(inFlight, 1)),
+      slots_(window_) {
+  for (std::size_t k = 0; k < window_; ++k)
+    slots_[k].accepts = k;
+  const int n = std::max(1, std::min(ioThreads, int(window_)));
+  for (int i = 0; i < n; ++i)
+    threads_.emplace_back([this] { io_loop(); });
+}
+
+Readahead::~Readahead() {
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    quit_ = true;
+  }
+  spaceCv_.notify_all();
+  for (auto &t : threads_)
+    t.join();
+}
+
+bool Readahead::next(ReadResult &out) {
+  std::unique_lock<std::mutex> lock(m_);
+  if (delivered_ >= paths_.size())
+    return false;
+  const std::size_t i = delivered_++;
+  Slot &slot = slots_[i % window_];
+  readyCv_.wait(lock, [&] { return slot.ready && slot.result.index == i; });
+  out = std::move(slot.result);
+  slot.ready = false;
+  slot.accepts = i + window_;
+  lock.unlock();
+  spaceCv_.notify_all();
+  return true;
+}
+
+void Readahead::io_loop() {
+  for (;;) {
+    std::size_t i = 0, hintBegin = 0, hintEnd = 0;
+    {
+      std::unique_lock<std::mutex> lock(m_);
+      // A file may be claimed once a consumer has taken the one that last
+      // used its slot.
+      spaceCv_.wait(lock, [&] {
+        return quit_ || claimed_ >= paths_.size() ||
+               slots_[claimed_ % window_].accepts == claimed_;
+      });
+      if (quit_ || claimed_ >= paths_.size())
+        return;
+      i = claimed_++;
+      hintBegin = std::max(hinted_, i + 1);
+      hintEnd = std::min(paths_.size(), delivered_ + window_);
+      hinted_ = std::max(hinted_, hintEnd);
+    }
+    if (hintBegin < hintEnd)
+      hint(hintBegin, hintEnd);
+
+    ReadResult r;
+    r.index = i;
+    r.path = paths_[i];
+    read_one(i, r);
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      Slot &slot = slots_[i % window_];
+      slot.result = std::move(r);
+      slot.ready = true;
+    }
+    readyCv_.notify_all();
+  }
+}
+
+#if defined(_WIN32)
+
+void Readahead::hint(std::size_t, std::size_t) const {}
+
+void Readahead::read_one(std::size_t i, ReadResult &r) const {
+  try {
+    r.bytes = ::read_all(paths_[i].string());
+  } catch (const std::exception &ex) {
+    r.error = ex.what();
+  }
+}
+
+#else
+
+void Readahead::hint(std::size_t begin, std::size_t end) const {
+  // The page cache keeps reading after close(); the fd is only the handle
+  // for the hint.
+  for (std::size_t i = begin; i < end; ++i) {
+    const int fd = ::open(paths_[i].c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      continue; // read_one() reports the error
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close(fd);
+  }
+}
+
+void Readahead::read_one(std::size_t i, ReadResult &r) const {
+  const int fd = ::open(paths_[i].c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    r.error = std::string("Could not open file: ") + std::strerror(errno);
+    return;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || st.st_size < 0) {
+    r.error = "Could not get size of file";
+    ::close(fd);
+    return;
+  }
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  r.bytes.resize(static_cast<std::size_t>(st.st_size));
+  std::size_t got = 0;
+  while (got < r.bytes.size()) {
+    const ssize_t n = ::read(fd, r.bytes.data() + got, r.bytes.size() - got);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      r.error = n < 0 ? std::string("Could not read file: ") +
+                            std::strerror(errno)
+                      : "File shrank while reading";
+      break;
+    }
+    got += std::size_t(n);
+  }
+  ::close(fd);
+  if (!r.error.empty())
+    r.bytes.clear();
+}
+
+#endif
+
+} // namespace io
@@ -0,0 +1,89 @@
+// src/io/readahead.hpp
+// Overlap file I/O with parsing in batch modes: a small I/O thread pool reads
+// upcoming files while the caller works on the current one.
+//
+//   io::Readahead ra(paths, /*inFlight=*/32);
+//   io::ReadResult r;
+//   while (ra.next(r)) {            // input order; blocks only on a miss
+//     if (!r.error.empty()) ...     // per-file errors do not stop the batch
+//     parse(r.bytes);
+//   }
+//
+// Design notes:
+// - Files are delivered in input order, so consumers that write in order
+//   (midi_pack) stay deterministic. next() is thread-safe: several parser
+//   workers may pull from one Readahead.
+// - At most `inFlight` files are read or buffered ahead of the consumer:
+//   memory is bounded by the window, not by the batch.
+// - The window is wider than the thread pool. Files entering the window are
+//   opened and hinted with posix_fadvise(WILLNEED), so the kernel fetches
+//   them (including over NFS) while the I/O threads block on earlier reads.
+// - io_uring would avoid the threads, but needs liburing or a hand-rolled
+//   ring; blocking reads on a few threads already hide the latency that
+//   matters here (cold caches, network filesystems).
+// - Without POSIX (Windows) the threads fall back to ::read_all and skip the
+//   hints.
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace io {
+
+struct ReadResult {
+  std::size_t index = 0; // position in the input list
+  std::filesystem::path path;
+  std::vector<std::uint8_t> bytes;
+  std::string error; // empty on success
+};
+
+class Readahead {
+public:
+  static constexpr std::size_t kDefaultInFlight = 32;
+  static constexpr int kDefaultThreads = 4;
+
+  explicit Readahead(std::vector<std::filesystem::path> paths,
+                     std::size_t inFlight = kDefaultInFlight,
+                     int ioThreads = kDefaultThreads);
+  ~Readahead();
+  Readahead(const Readahead &) = delete;
+  Readahead &operator=(const Readahead &) = delete;
+
+  // Move the next file (in input order) into `out`; false once all files
+  // have been handed out.
+  bool next(ReadResult &out);
+
+  [[nodiscard]] std::size_t size() const { return paths_.size(); }
+
+private:
+  struct Slot {
+    ReadResult result;
+    bool ready = false;
+    std::size_t accepts = 0; // the file this slot holds next
+  };
+
+  void io_loop();
+  void hint(std::size_t begin, std::size_t end) const;
+  void read_one(std::size_t i, ReadResult &r) const;
+
+  std::vector<std::filesystem::path> paths_;
+  std::size_t window_;
+  std::vector<Slot> slots_; // ring: file i lives in slots_[i % window_]
+
+  std::mutex m_;
+  std::condition_variable readyCv_; // a slot became ready
+  std::condition_variable spaceCv_; // the window moved (or quit)
+  std::size_t claimed_ = 0;   // next file for an I/O thread
+  std::size_t hinted_ = 0;    // files [0, hinted_) have been hinted
+  std::size_t delivered_ = 0; // next file handed out by next()
+  bool quit_ = false;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace io
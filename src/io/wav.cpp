@@ -0,0 +1,146 @@
+// src/io/wav.cpp
+// RIFF chunk walk + sample conversion. WAV is little-endian throughout, so
+// this does not use the big-endian Bytes cursor from common/reader.hpp.
+
+#include "io/wav.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr std::uint16_t kFormatPcm = 1;
+constexpr std::uint16_t kFormatFloat = 3;
+constexpr std::uint16_t kFormatExtensible = 0xFFFE;
+
+std::uint32_t le32(const std::uint8_t *p) {
+  return std::uint32_t(p[0]) | (std::uint32_t(p[1]) << 8) |
+         (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+}
+
+std::uint16_t le16(const std::uint8_t *p) {
+  return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+float decode(const std::uint8_t *p, std::uint16_t format, int bits) {
+  if (format == kFormatFloat) {
+    float f;
+    const std::uint32_t u = le32(p);
+    std::memcpy(&f, &u, sizeof f);
+    return f;
+  }
+  switch (bits) {
+  case 16:
+    return static_cast<std::int16_t>(le16(p)) / 32768.0f;
+  case 24: {
+    const std::int32_t v =
+        static_cast<std::int32_t>((std::uint32_t(p[0]) << 8) |
+                                  (std::uint32_t(p[1]) << 16) |
+                                  (std::uint32_t(p[2]) << 24)) >>
+        8;
+    return v / 8388608.0f;
+  }
+  default: // 32
+    return static_cast<std::int32_t>(le32(p)) / 2147483648.0f;
+  }
+}
+
+} // namespace
+
+namespace io {
+
+std::vector<float> WavData::channel(int c) const {
+  std::vector<float> out(frames());
+  for (std::size_t i = 0; i < out.size(); ++i)
+    out[i] = samples[i * std::size_t(channels) + std::size_t(c)];
+  return out;
+}
+
+WavData read_wav(const std::vector<std::uint8_t> &bytes) {
+  const std::size_t size = bytes.size();
+  const std::uint8_t *b = bytes.data();
+  if (size < 12 || std::memcmp(b, "RIFF", 4) != 0 ||
+      std::memcmp(b + 8, "WAVE", 4) != 0)
+    throw std::runtime_error("Not a RIFF/WAVE file");
+
+  WavData wav;
+  std::uint16_t format = 0;
+  int bits = 0;
+  const std::uint8_t *data = nullptr;
+  std::size_t dataLen = 0;
+
+  std::size_t off = 12;
+  while (off + 8 <= size) {
+    const std::uint8_t *id = b + off;
+    const std::size_t len = le32(b + off + 4);
+    const std::size_t body = off + 8;
+    const std::size_t avail = std::min(len, size - body); // tolerate truncation
+    if (std::memcmp(id, "fmt ", 4) == 0) {
+      if (avail < 16)
+        throw std::runtime_error("WAV fmt chunk too short");
+      format = le16(b + body);
+      wav.channels = le16(b + body + 2);
+      wav.sampleRate = static_cast<int>(le32(b + body + 4));
+      bits = le16(b + body + 14);
+      if (format == kFormatExtensible && avail >= 26)
+        format = le16(b + body + 24); // first two bytes of the sub-format GUID
+    } else if (std::memcmp(id, "data", 4) == 0) {
+      data = b + body;
+      dataLen = avail;
+    }
+    off = body + len + (len & 1); // chunks are word-aligned
+  }
+
+  if (wav.channels <= 0 || wav.sampleRate <= 0 || !data)
+    throw std::runtime_error("WAV file is missing its fmt or data chunk");
+  const bool ok = (format == kFormatPcm &&
+                   (bits == 16 || bits == 24 || bits == 32)) ||
+                  (format == kFormatFloat && bits == 32);
+  if (!ok)
+    throw std::runtime_error("Unsupported WAV encoding (format " +
+                             std::to_string(format) + ", " +
+                             std::to_string(bits) + " bit)");
+
+  const std::size_t stride = std::size_t(bits / 8);
+  const std::size_t count = dataLen / stride;
+  wav.samples.resize(count - count % std::size_t(wav.channels));
+  for (std::size_t i = 0; i < wav.samples.size(); ++i)
+    wav.samples[i] = decode(data + i * stride, format, bits);
+  return wav;
+}
+
+std::vector<std::uint8_t> wav_float_header(int sampleRate, int channels,
+                                           std::size_t frames) {
+  const std::uint32_t block = std::uint32_t(channels) * 4;
+  // RIFF sizes are 32-bit: the data plus the 36 header bytes after the
+  // RIFF size field must fit (about 6.7 hours of 44.1 kHz float stereo).
+  if (frames > (0xFFFFFFFFu - 36) / block)
+    throw std::runtime_error("Too long for a WAV file: " +
+                             std::to_string(frames) + " frames");
+  const std::uint32_t data = std::uint32_t(frames) * block;
+  std::vector<std::uint8_t> h;
+  h.reserve(44);
+  const auto tag = [&](const char *id) { h.insert(h.end(), id, id + 4); };
+  const auto put = [&](std::uint32_t v, int n) {
+    for (int i = 0; i < n; ++i)
+      h.push_back(std::uint8_t(v >> (8 * i)));
+  };
+  tag("RIFF");
+  put(36 + data, 4);
+  tag("WAVE");
+  tag("fmt ");
+  put(16, 4);
+  put(kFormatFloat, 2);
+  put(std::uint32_t(channels), 2);
+  put(std::uint32_t(sampleRate), 4);
+  put(std::uint32_t(sampleRate) * block, 4);
+  put(block, 2);
+  put(32, 2);
+  tag("data");
+  put(data, 4);
+  return h;
+}
+
+} // namespace io
@@ -0,0 +1,41 @@
+// src/io/wav.hpp
+// Minimal RIFF/WAVE reader for impulse responses, and the header for float
+// output files.
+//
+//   io::WavData ir = io::read_wav(io::read_all(path));
+//   ir.channel(0)  --> std::vector<float> of the first channel
+//
+//   out.write(io::wav_float_header(44100, 2, frames))  --> then the samples
+//
+// Supported: PCM 16/24/32-bit integer and IEEE float 32-bit, any channel
+// count (WAVE_FORMAT_EXTENSIBLE is accepted when its sub-format is one of
+// those). Everything else throws std::runtime_error.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace io {
+
+struct WavData {
+  int sampleRate = 0;
+  int channels = 0;
+  std::vector<float> samples; // interleaved, [-1, 1]
+
+  [[nodiscard]] std::size_t frames() const {
+    return channels ? samples.size() / std::size_t(channels) : 0;
+  }
+  // De-interleaved copy of one channel.
+  [[nodiscard]] std::vector<float> channel(int c) const;
+};
+
+WavData read_wav(const std::vector<std::uint8_t> &bytes);
+
+// 44-byte header of an IEEE float 32-bit file holding `frames` frames; the
+// interleaved samples follow it directly. Throws std::runtime_error when the
+// data would pass the 4 GiB RIFF limit (no RF64).
+std::vector<std::uint8_t> wav_float_header(int sampleRate, int channels,
+                                           std::size_t frames);
+
+} // namespace io
@@ -2,28 +2,234 @@
 // Tiny orchestration: CLI → load bytes → parse → tempo map → choose SF2 →
 // preview → play.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
 #include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
 
+#include "app/alloc_bench.hpp"
 #include "app/cli.hpp"
+#include "app/golden.hpp"
+#include "app/hot_reload.hpp"
+#include "app/job_bench.hpp"
 #include "app/preview.hpp"
+#include "app/render_farm.hpp"
+#include "app/stats.hpp"
+#include "app/stream_input.hpp"
 #include "assets/sf_resolver.hpp"
+#include "audio/driver.hpp"
+#include "audio/mixer.hpp"
+#include "audio/render_cost.hpp"
 #include "audio/player.hpp"
+#include "audio/synth.hpp"
+#include "common/mem_account.hpp"
 #include "io/io.hpp"
+#include "io/live_input.hpp"
+#include "io/pack.hpp"
+#include "io/perf_counters.hpp"
+#include "io/readahead.hpp"
+#include "midi/meter.hpp"
 #include "midi/smf.hpp"
 #include "midi/tempo.hpp"
 
+namespace {
+
+// Raised by Ctrl-C / SIGTERM; live, --watch and streamed playback stop then.
+std::atomic<bool> g_stop{false};
+void on_signal(int) { g_stop.store(true); }
+
+void print_latency(const io::LatencyStats &s) {
+  std::cout << std::fixed << std::setprecision(2)
+            << "\nLive input latency (" << s.count << " events";
+  if (s.dropped)
+    std::cout << ", " << s.dropped << " dropped";
+  std::cout << "):\n";
+  if (s.count == 0)
+    return;
+  std::cout << "  input -> callback  min " << s.minMs << " ms, avg " << s.avgMs
+            << " ms, max " << s.maxMs << " ms\n"
+            << "  + device buffer   " << s.deviceMs << " ms\n"
+            << "  input -> output   avg " << s.avgMs + s.deviceMs << " ms\n";
+}
+
+void print_interp_costs(const std::vector<audio::InterpCost> &costs) {
+  std::cout << "Interpolation cost (this machine, 44.1 kHz):\n"
+            << "  mode     ns/voice-sample  voices/core  vs linear\n";
+  const double base = costs.empty() ? 0.0 : costs.front().nsPerVoiceSample;
+  for (const auto &c : costs) {
+    std::cout << "  " << std::left << std::setw(8)
+              << audio::interp_name(c.mode) << std::right << std::fixed
+              << std::setprecision(2) << std::setw(16) << c.nsPerVoiceSample
+              << std::setprecision(0) << std::setw(13) << c.voicesPerCore
+              << std::setprecision(2) << std::setw(10)
+              << (base > 0.0 ? c.nsPerVoiceSample / base : 0.0) << "x\n";
+  }
+}
+
+// --admit: one line per song offered to the mixer.
+void print_admission(const std::string &name, const audio::AdmitResult &r) {
+  static constexpr const char *kVerdicts[] = {"admitted", "downgraded",
+                                              "queued", "rejected"};
+  std::cout << std::fixed << std::setprecision(3) << "Admission: " << name
+            << ": " << kVerdicts[int(r.verdict)] << " ("
+            << audio::interp_name(r.tier) << ", peak "
+            << std::setprecision(1) << r.demand.peakVoices << " voices, "
+            << std::setprecision(3) << r.demandCores << " cores)\n";
+}
+
+void print_headroom(const audio::Headroom &h) {
+  std::cout << std::fixed << std::setprecision(3) << "Headroom: "
+            << h.available << " of " << h.capacity << " cores free ("
+            << h.cores << " render core" << (h.cores == 1 ? "" : "s") << ", "
+            << h.queued << " queued)\n";
+}
+
+// After a run on the simulated driver: how much audio time it rendered, and
+// how long that took.
+void print_simulated(const audio::Driver *driver,
+                     std::chrono::steady_clock::time_point t0) {
+  const auto *sim = dynamic_cast<const audio::SimulatedDriver *>(driver);
+  if (!sim)
+    return;
+  const double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - t0)
+                        .count();
+  std::cout << "Simulated " << sim->now_sec() << " s of audio in "
+            << sim->periods() << " periods, " << ms << " ms\n";
+}
+
+// Parse and tempo map on the accounted heaps (--mem-report), counted as
+// their stages for --perf.
+midi::Song parse_song(const std::uint8_t *data, std::size_t size) {
+  io::PerfScope perf(io::PerfStage::Parse);
+  midi::Song song =
+      midi::parse_smf(data, size, mem_resource(MemSubsystem::Song));
+  perf.set_units(song.notes.size() + song.ctrls.size());
+  return song;
+}
+
+midi::TempoMap tempo_map(const midi::Song &song) {
+  io::PerfScope perf(io::PerfStage::Tempo);
+  midi::TempoMap tempo =
+      midi::build_tempo_map(song, mem_resource(MemSubsystem::TempoMap));
+  perf.set_units(song.tempi.size());
+  return tempo;
+}
+
+// --pack without an entry name: list the catalog from its index alone.
+void print_pack(const io::PackReader &pack) {
+  std::cout << "Pack: " << pack.size() << " entries\n"
+            << "  fmt  trk    notes   length  name\n";
+  for (const io::PackEntry &e : pack) {
+    const unsigned sec = e.durationMs / 1000;
+    std::cout << std::right << std::setw(5) << e.format << std::setw(5)
+              << e.nTracks << std::setw(9) << e.notes << std::setw(6)
+              << sec / 60 << ":" << std::setfill('0') << std::setw(2)
+              << sec % 60 << std::setfill(' ') << "  " << pack.name(e)
+              << "\n";
+  }
+}
+
+} // namespace
+
 int main(int argc, char **argv) {
   try {
     // 1) Parse CLI (MIDI path + optional --sf <name>)
     app::Cli cli = app::parse_cli(argc, argv);
+    if (cli.perf)
+      io::perf_enable();
+    if (cli.costReport)
+      audio::cost_enable();
+    if (!cli.statsPath.empty()) {
+      app::run_stats(cli.statsPath, std::cout); // bad files are reported
+      if (cli.perf)
+        io::print_perf_report(std::cerr); // stdout stays JSON
+      return 0;
+    }
+    if (!cli.farmWorker.empty()) {
+      const std::size_t n = app::run_farm_worker(cli.farmWorker);
+      std::cerr << "worker " << app::detail::farm_worker_id() << ": " << n
+                << " jobs\n";
+      return 0;
+    }
+    if (!cli.farmSpool.empty()) {
+      app::FarmOptions farm;
+      farm.spool = cli.farmSpool;
+      farm.submit = cli.farmSubmit;
+      farm.checkpointSec = cli.farmCheckpoint;
+      farm.impulseResponse = cli.irPath;
+      farm.irOnMaster = cli.irMaster;
+      if (!farm.submit.empty())
+        farm.soundFont = assets::select_soundfont(cli.sfOverride, argv[0]);
+      farm.workers =
+          cli.farmWorkers >= 0
+              ? cli.farmWorkers
+              : std::max(1, int(std::thread::hardware_concurrency()));
+      farm.self = argv[0];
+      const app::FarmSummary sum = app::run_farm(farm, std::cout);
+      app::print_farm_summary(sum, std::cout);
+      return sum.failed == 0 ? 0 : 1;
+    }
+    if (!cli.goldenDir.empty()) {
+      const int failed = app::run_golden(
+          {cli.goldenDir, cli.goldenUpdate, cli.goldenSnr, cli.goldenTiming});
+      if (cli.perf)
+        io::print_perf_report(std::cout);
+      return failed == 0 ? 0 : 1;
+    }
+
+    // 2) Load file (live-only runs start from an empty song). Pack entries
+    //    are parsed in place from the mapping. Song, tempo map and file
+    //    bytes are charged to their subsystems for --mem-report.
+    midi::Song song(mem_resource(MemSubsystem::Song));
+    std::unique_ptr<io::PackReader> pack;
+    MemCharge packMem(MemSubsystem::FileBytes);
+    if (!cli.packPath.empty()) {
+      pack = std::make_unique<io::PackReader>(cli.packPath);
+      packMem.set(std::filesystem::file_size(cli.packPath)); // mapped
+      if (cli.packEntry.empty()) {
+        print_pack(*pack);
+        return 0;
+      }
+      const io::PackEntry *e = pack->find(cli.packEntry);
+      if (!e) {
+        throw std::runtime_error("No entry '" + cli.packEntry + "' in " +
+                                 cli.packPath.string());
+      }
+      song = parse_song(pack->data(*e), e->length);
+      if (cli.benchAlloc) {
+        app::print_alloc_bench(app::run_alloc_bench(std::vector<std::uint8_t>(
+            pack->data(*e), pack->data(*e) + e->length)));
+        return 0;
+      }
+    } else if (!cli.midiPath.empty()) {
+      const auto bytes = io::read_all(cli.midiPath.string());
+      const MemCharge fileMem(MemSubsystem::FileBytes, bytes.capacity());
 
-    // 2) Load file
-    const auto bytes = io::read_all(cli.midiPath.string());
+      // 3) Parse MIDI and build tempo map
+      song = parse_song(bytes.data(), bytes.size());
+      if (cli.benchAlloc) {
+        app::print_alloc_bench(app::run_alloc_bench(bytes));
+        return 0;
+      }
+    }
+    midi::TempoMap tempo = tempo_map(song);
 
-    // 3) Parse MIDI and build tempo map
-    midi::Song song = midi::parse_smf(bytes);
-    midi::TempoMap tempo = midi::build_tempo_map(song);
+    // Streamed input ("-" or a pipe): wait for the first playable part; the
+    // rest is spliced in while playing.
+    std::unique_ptr<app::StreamInput> stream;
+    if (!cli.streamPath.empty()) {
+      std::signal(SIGINT, on_signal);
+      std::signal(SIGTERM, on_signal);
+      stream = std::make_unique<app::StreamInput>(cli.streamPath);
+      stream->wait_initial(g_stop, song, tempo);
+    }
 
     // 4) Resolve SoundFont from ./soundfonts/ (default =
     // Sonatina_Symphonic_Orchestra.sf2) NOTE: Pass argv[0] so the resolver can
@@ -32,11 +238,163 @@ int main(int argc, char **argv) {
         assets::select_soundfont(cli.sfOverride, argv[0]);
     std::cout << "SoundFont: " << sf.string() << "\n\n";
 
+    audio::PlayOptions opts;
+    if (!cli.interp.empty()) {
+      const auto mode = audio::parse_interp(cli.interp);
+      if (!mode)
+        throw std::runtime_error("Unknown interpolation mode: " + cli.interp);
+      opts.interp = *mode;
+    }
+    opts.mipmaps = cli.mipmaps;
+    opts.compactEvents = cli.compactEvents;
+    opts.memReport = cli.memReport;
+    std::unique_ptr<audio::Driver> driver;
+    if (!cli.driver.empty()) {
+      driver = audio::make_driver(cli.driver);
+      // Simulated time runs ahead of the wall clock live input, file saves
+      // and streamed input arrive by.
+      if ((cli.liveSpec || cli.watch || !cli.streamPath.empty()) &&
+          dynamic_cast<audio::SimulatedDriver *>(driver.get()))
+        throw std::runtime_error(
+            "--live, --watch and streamed input need a real-time driver");
+      opts.driver = driver.get();
+    }
+    if (cli.benchInterp) {
+      print_interp_costs(audio::measure_interp_cost(audio::Synth(sf, 44100)));
+      return 0;
+    }
+    if (cli.benchJobs) {
+      const int workers =
+          std::max(1, int(std::thread::hardware_concurrency()));
+      const audio::Synth font(sf, app::kJobBenchSampleRate);
+      app::print_job_bench(
+          app::run_job_bench(font, audio::build_schedule(song, tempo),
+                             workers),
+          workers);
+      return 0;
+    }
+
     // 5) Quick text preview (header + first 10 note events)
-    app::print_preview(song, tempo);
+    if (!cli.midiPath.empty() || !cli.packEntry.empty())
+      app::print_preview(song, tempo, midi::build_meter_map(song));
+    if (stream) {
+      std::cout << "Streaming from "
+                << (cli.streamPath == "-" ? "stdin" : cli.streamPath)
+                << " (format " << song.header.format << ", "
+                << song.header.nTracks << " tracks)\n";
+      opts.reload = stream.get();
+      opts.stop = &g_stop;
+    }
+
+    // --watch: keep playing and splice in every saved version of the file.
+    std::unique_ptr<app::HotReload> reload;
+    if (cli.watch) {
+      if (!cli.mixPaths.empty())
+        throw std::runtime_error("--watch cannot be combined with --mix");
+      reload = std::make_unique<app::HotReload>(cli.midiPath);
+      std::signal(SIGINT, on_signal);
+      std::signal(SIGTERM, on_signal);
+      std::cout << "Watching " << cli.midiPath.string()
+                << " for changes (Ctrl-C to stop)\n";
+      opts.reload = reload.get();
+      opts.stop = &g_stop;
+    }
 
     // 6) Make it sing (blocking until the song finishes)
-    audio::play(song, tempo, sf);
+    if (cli.liveSpec) {
+      if (!cli.mixPaths.empty())
+        throw std::runtime_error("--live cannot be combined with --mix");
+      io::LiveInput live(*cli.liveSpec);
+      std::signal(SIGINT, on_signal);
+      std::signal(SIGTERM, on_signal);
+      std::cout << "Listening for live MIDI on " << live.spec()
+                << " (Ctrl-C to stop)\n";
+
+      opts.live = &live;
+      opts.stop = &g_stop;
+      opts.sendEffects = !cli.dry;
+      opts.impulseResponse = cli.irPath;
+      opts.irOnMaster = cli.irMaster;
+      audio::play(song, tempo, sf, opts);
+      print_latency(live.latency());
+    } else if (cli.mixPaths.empty()) {
+      opts.sendEffects = !cli.dry;
+      opts.impulseResponse = cli.irPath;
+      opts.irOnMaster = cli.irMaster;
+      const auto t0 = std::chrono::steady_clock::now();
+      audio::play(song, tempo, sf, opts);
+      print_simulated(driver.get(), t0);
+    } else {
+      if (!cli.irPath.empty())
+        throw std::runtime_error("--ir cannot be combined with --mix");
+      // Several songs at once: one mixer session per file, one device. With
+      // fewer --mix-slots, a song waits until a finished one is removed.
+      audio::MixerOptions mixOpts;
+      mixOpts.maxSessions = cli.mixSlots > 0
+                                ? cli.mixSlots
+                                : static_cast<int>(cli.mixPaths.size()) + 1;
+      mixOpts.interp = opts.interp;
+      mixOpts.mipmaps = opts.mipmaps;
+      mixOpts.sendEffects = !cli.dry;
+      mixOpts.driver = driver.get();
+      const auto t0 = std::chrono::steady_clock::now();
+      audio::Mixer mixer(sf, mixOpts);
+      if (cli.admit)
+        mixer.calibrate_cost_model();
+      const auto add = [&](const std::string &name, const midi::Song &s,
+                           const midi::TempoMap &t) {
+        if (!cli.admit)
+          return mixer.add(s, t);
+        mixer.calibrate_channels(s, t);
+        const audio::AdmitResult r = mixer.try_add(s, t);
+        print_admission(name, r);
+        return r.id; // -1: rejected
+      };
+      std::vector<audio::SessionId> pending; // added, not started yet
+      int held = 0;                          // slots in use
+      const auto start_pending = [&] {
+        for (auto id : pending)
+          mixer.start(id);
+        pending.clear();
+      };
+      const auto place = [&](const std::string &name, const midi::Song &s,
+                             const midi::TempoMap &t) {
+        if (held == mixOpts.maxSessions) {
+          start_pending();
+          const audio::SessionId done = mixer.wait_finished();
+          if (done >= 0) {
+            mixer.remove(done);
+            --held;
+          }
+        }
+        const audio::SessionId id = add(name, s, t);
+        if (id >= 0) {
+          pending.push_back(id);
+          ++held;
+        }
+      };
+      place(cli.midiPath.filename().string(), song, tempo);
+      // Layers are read ahead while earlier ones parse and calibrate.
+      io::Readahead layers(cli.mixPaths);
+      for (io::ReadResult r; layers.next(r);) {
+        if (!r.error.empty())
+          throw std::runtime_error(r.path.string() + ": " + r.error);
+        const MemCharge fileMem(MemSubsystem::FileBytes, r.bytes.capacity());
+        const midi::Song layer = parse_song(r.bytes.data(), r.bytes.size());
+        place(r.path.filename().string(), layer, tempo_map(layer));
+      }
+      start_pending();
+      if (cli.admit)
+        print_headroom(mixer.headroom());
+      mixer.wait_all();
+      print_simulated(driver.get(), t0);
+      if (cli.memReport)
+        print_mem_report(std::cout);
+    }
+    if (cli.perf)
+      io::print_perf_report(std::cout);
+    if (cli.costReport)
+      audio::print_cost_report(std::cout);
 
     return 0;
   } catch (const std::exception &ex) {
@@ -0,0 +1,116 @@
+// src/midi/channel.hpp
+// Channel-voice message helpers shared by the SMF track walker and the live
+// input stage, so both sources classify bytes the same way.
+//
+// - channel_data_bytes(status): how many data bytes follow a status byte.
+// - to_note_event(...): NoteOn/NoteOff extraction (NoteOn vel 0 == NoteOff).
+// - StreamParser: byte-at-a-time parser for wire MIDI (running status,
+//   interleaved realtime bytes, SysEx and system-common payloads skipped).
+
+#pragma once
+#include <cstdint>
+
+#include "midi/events.hpp"
+
+namespace midi {
+
+// A complete channel message as it appeared on the wire.
+struct ChannelMsg {
+  std::uint8_t status = 0; // 0x80..0xEF
+  std::uint8_t d1 = 0;
+  std::uint8_t d2 = 0; // 0 for one-data-byte messages
+};
+
+// Data bytes following a channel status (0 for anything that is not one).
+inline int channel_data_bytes(std::uint8_t status) {
+  switch (status & 0xF0) {
+  case 0x80: // Note Off
+  case 0x90: // Note On
+  case 0xA0: // Poly Aftertouch
+  case 0xB0: // Control Change
+  case 0xE0: // Pitch Bend
+    return 2;
+  case 0xC0: // Program Change
+  case 0xD0: // Channel Pressure
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+// If the message is a note event, fill `out` and return true.
+inline bool to_note_event(std::uint8_t status, std::uint8_t d1,
+                          std::uint8_t d2, std::uint32_t tick, NoteEv &out) {
+  const std::uint8_t type = status & 0xF0;
+  const std::uint8_t ch = status & 0x0F;
+  if (type == 0x90 && d2 != 0) {
+    out = NoteEv{tick, ch, d1, d2, EvType::NoteOn};
+    return true;
+  }
+  if (type == 0x80 || (type == 0x90 && d2 == 0)) {
+    // Either true 0x80 or "Note On with velocity 0"
+    out = NoteEv{tick, ch, d1, d2, EvType::NoteOff};
+    return true;
+  }
+  return false;
+}
+
+// Incremental parser for a raw MIDI byte stream (no delta times).
+// feed() returns true whenever a complete channel message is available.
+class StreamParser {
+public:
+  bool feed(std::uint8_t b, ChannelMsg &out) {
+    if (b >= 0xF8)
+      return false; // realtime: may appear anywhere, never affects state
+
+    if (b & 0x80) {
+      if (b >= 0xF0) {
+        // System common / SysEx: cancels running status; skip its payload.
+        running_ = 0;
+        inSysEx_ = (b == 0xF0);
+        skip_ = (b == 0xF1 || b == 0xF3) ? 1 : (b == 0xF2 ? 2 : 0);
+        return false;
+      }
+      inSysEx_ = false;
+      skip_ = 0;
+      running_ = b;
+      have_ = 0;
+      return false;
+    }
+
+    // Data byte.
+    if (inSysEx_)
+      return false;
+    if (skip_ > 0) {
+      --skip_;
+      return false;
+    }
+    if (running_ == 0)
+      return false; // stray data before any status
+
+    data_[have_++] = b;
+    if (have_ < channel_data_bytes(running_))
+      return false;
+
+    out = ChannelMsg{running_, data_[0],
+                     have_ == 2 ? data_[1] : std::uint8_t(0)};
+    have_ = 0; // running status: next data byte starts a new message
+    return true;
+  }
+
+  void reset() {
+    running_ = 0;
+    have_ = 0;
+    skip_ = 0;
+    inSysEx_ = false;
+  }
+
+private:
+  std::uint8_t running_ = 0;
+  std::uint8_t data_[2] = {0, 0};
+  int have_ = 0;
+  int skip_ = 0;
+  bool inSysEx_ = false;
+};
+
+} // namespace midi
@@ -1,16 +1,19 @@
 // src/midi/events.hpp
 // Core MIDI domain types shared across the app.
 // Keep this header light: plain structs, no implementation details.
+// Containers are std::pmr so batch tools can place a whole song in a per-file
+// arena (common/arena.hpp); default-constructed ones use the global heap.
 
 #pragma once
 #include <cstdint>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
 namespace midi {
 
 // --- Basic event kinds we care about for now ---
-enum class EvType { NoteOn, NoteOff };
+enum class EvType : std::uint8_t { NoteOn, NoteOff };
 
 // A channel note event (Note On/Off)
 struct NoteEv {
@@ -19,6 +22,16 @@ struct NoteEv {
   std::uint8_t note;  // MIDI note number 0..127
   std::uint8_t vel;   // velocity 0..127 (0 + NoteOn == NoteOff)
   EvType type;
+  std::uint8_t port = 0; // MIDI port of the track (meta 0x21), 16 ch each
+};
+
+// A Control Change (CC) message, e.g. volume, pan, sustain, effect sends
+struct CtrlEv {
+  std::uint32_t tick; // absolute tick in its track timeline
+  std::uint8_t ch;    // MIDI channel 0..15
+  std::uint8_t cc;    // controller number 0..127
+  std::uint8_t value; // controller value 0..127
+  std::uint8_t port = 0; // MIDI port, as in NoteEv
 };
 
 // A tempo meta event: microseconds per quarter note at a given tick
@@ -27,6 +40,22 @@ struct TempoEv {
   std::uint32_t usPerQN; // microseconds per quarter note
 };
 
+// A time signature meta event (FF 58): num/den with den = 2^denPow2
+struct TimeSigEv {
+  std::uint32_t tick;               // absolute tick where it takes effect
+  std::uint8_t num = 4;             // beats per bar
+  std::uint8_t denPow2 = 2;         // beat unit as 2^denPow2 (2 = quarter)
+  std::uint8_t clocksPerClick = 24; // MIDI clocks per metronome click
+  std::uint8_t n32PerQN = 8;        // notated 32nd notes per quarter note
+};
+
+// A key signature meta event (FF 59)
+struct KeySigEv {
+  std::uint32_t tick; // absolute tick where it takes effect
+  std::int8_t sf;     // -7..7: number of flats (<0) or sharps (>0)
+  bool minor;         // false = major, true = minor
+};
+
 // Parsed SMF header (subset we need)
 struct SMFHeader {
   std::uint16_t format = 0;   // 0, 1, or 2
@@ -41,9 +70,16 @@ struct SMFHeader {
 
 // A lightweight container for the parsed song: header + extracted events.
 struct Song {
+  Song() = default;
+  explicit Song(std::pmr::memory_resource *mr)
+      : notes(mr), ctrls(mr), tempi(mr), timeSigs(mr), keySigs(mr) {}
+
   SMFHeader header;
-  std::vector<NoteEv> notes;  // flattened across tracks (absolute ticks)
-  std::vector<TempoEv> tempi; // collected from all tracks (sorted later)
+  std::pmr::vector<NoteEv> notes;  // flattened across tracks (absolute ticks)
+  std::pmr::vector<CtrlEv> ctrls;  // control changes, flattened like notes
+  std::pmr::vector<TempoEv> tempi; // collected from all tracks (sorted later)
+  std::pmr::vector<TimeSigEv> timeSigs; // like tempi: unsorted, all tracks
+  std::pmr::vector<KeySigEv> keySigs;   // like tempi: unsorted, all tracks
   // (If you later want per-track separation, we can add tracks[] of events.)
 };
 
@@ -56,8 +92,11 @@ struct TempoSeg {
 
 // A thin wrapper for tempo info; keeps room for future metadata.
 struct TempoMap {
-  unsigned ppqn = 480;            // ticks per quarter note
-  std::vector<TempoSeg> segments; // ascending by startTick
+  TempoMap() = default;
+  explicit TempoMap(std::pmr::memory_resource *mr) : segments(mr) {}
+
+  unsigned ppqn = 480;                 // ticks per quarter note
+  std::pmr::vector<TempoSeg> segments; // ascending by startTick
 };
 
 } // namespace midi
@@ -0,0 +1,92 @@
+// src/midi/incremental.cpp
+// Per-track reuse by chunk hash, merge in file order, conductor check.
+
+#include "midi/incremental.hpp"
+#include "midi/smf.hpp"
+#include "midi/tempo.hpp"
+
+#include <unordered_map>
+#include <utility>
+
+namespace midi {
+
+IncrementalSmf::IncrementalSmf(const std::vector<std::uint8_t> &bytes) {
+  update(bytes);
+}
+
+ReloadStats IncrementalSmf::update(const std::vector<std::uint8_t> &bytes) {
+  std::vector<TrackChunk> chunks;
+  const SMFHeader header = scan_smf(bytes, chunks);
+
+  // Old tracks by content; each can be reused once.
+  std::unordered_multimap<std::uint64_t, std::size_t> byHash;
+  for (std::size_t i = 0; i < tracks_.size(); ++i)
+    byHash.emplace(tracks_[i].hash, i);
+  std::vector<bool> reused(tracks_.size(), false);
+
+  ReloadStats stats;
+  stats.tracks = chunks.size();
+  std::vector<Track> next(chunks.size());
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    const TrackChunk &c = chunks[i];
+    next[i].hash = c.hash;
+    next[i].length = c.length;
+    auto [lo, hi] = byHash.equal_range(c.hash);
+    for (; lo != hi; ++lo) {
+      const std::size_t old = lo->second;
+      if (!reused[old] && tracks_[old].length == c.length) {
+        reused[old] = true;
+        next[i].events = tracks_[old].events;
+        break;
+      }
+    }
+    if (lo == hi) {
+      parse_track(bytes, c, next[i].events); // may throw: nothing changed yet
+      ++stats.reparsed;
+      stats.tempoChanged |= !next[i].events.tempi.empty();
+    }
+  }
+  for (std::size_t i = 0; i < tracks_.size(); ++i)
+    stats.tempoChanged |= !reused[i] && !tracks_[i].events.tempi.empty();
+  stats.tempoChanged |= song_.header.division != header.division;
+
+  tracks_ = std::move(next);
+  song_.header = header;
+  merge();
+  if (stats.tempoChanged || tempo_.segments.empty())
+    tempo_ = build_tempo_map(song_);
+  return stats;
+}
+
+void IncrementalSmf::merge() {
+  std::size_t notes = 0, ctrls = 0, tempi = 0, timeSigs = 0, keySigs = 0;
+  for (const Track &t : tracks_) {
+    notes += t.events.notes.size();
+    ctrls += t.events.ctrls.size();
+    tempi += t.events.tempi.size();
+    timeSigs += t.events.timeSigs.size();
+    keySigs += t.events.keySigs.size();
+  }
+  song_.notes.clear();
+  song_.ctrls.clear();
+  song_.tempi.clear();
+  song_.timeSigs.clear();
+  song_.keySigs.clear();
+  song_.notes.reserve(notes);
+  song_.ctrls.reserve(ctrls);
+  song_.tempi.reserve(tempi);
+  song_.timeSigs.reserve(timeSigs);
+  song_.keySigs.reserve(keySigs);
+  for (const Track &t : tracks_) {
+    const Song &e = t.events;
+    song_.notes.insert(song_.notes.end(), e.notes.begin(), e.notes.end());
+    song_.ctrls.insert(song_.ctrls.end(), e.ctrls.begin(), e.ctrls.end());
+    song_.tempi.insert(song_.tempi.end(), e.tempi.begin(), e.tempi.end());
+    song_.timeSigs.insert(song_.timeSigs.end(), e.timeSigs.begin(),
+                          e.timeSigs.end());
+    song_.keySigs.insert(song_.keySigs.end(), e.keySigs.begin(),
+                         e.keySigs.end());
+  }
+}
+
+} // namespace midi
@@ -0,0 +1,62 @@
+// src/midi/incremental.hpp
+// Re-parse a Standard MIDI File that changed on disk, decoding only the
+// MTrk chunks whose bytes changed.
+//
+//   midi::IncrementalSmf smf(io::read_all(path));
+//   ...file saved again...
+//   const midi::ReloadStats st = smf.update(io::read_all(path));
+//   play(smf.song(), smf.tempo());   // tempo rebuilt only if st.tempoChanged
+//
+// Design notes:
+// - Each track's events are kept in their own Song, keyed by the FNV-1a hash
+//   of the chunk bytes (midi::scan_smf). An unchanged chunk is reused even
+//   if tracks were inserted or reordered around it.
+// - The merged song concatenates tracks in file order, exactly like
+//   parse_smf(), so schedules built from it are identical to a full parse.
+// - The tempo map is rebuilt only when the conductor changed: a re-parsed or
+//   dropped track carries tempo events, or the header's division changed.
+//   Editing notes in a format-1 file never touches the tempo map.
+// - update() is all-or-nothing: on a parse error (e.g. a half-written file)
+//   it throws and the previous song stays current.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "midi/events.hpp"
+
+namespace midi {
+
+struct ReloadStats {
+  std::size_t tracks = 0;   // MTrk chunks in the new file
+  std::size_t reparsed = 0; // chunks decoded again (the rest were reused)
+  bool tempoChanged = false;
+};
+
+class IncrementalSmf {
+public:
+  explicit IncrementalSmf(const std::vector<std::uint8_t> &bytes);
+
+  // Load a new version of the file. Throws std::runtime_error on malformed
+  // input, leaving song() and tempo() unchanged.
+  ReloadStats update(const std::vector<std::uint8_t> &bytes);
+
+  [[nodiscard]] const Song &song() const { return song_; }
+  [[nodiscard]] const TempoMap &tempo() const { return tempo_; }
+
+private:
+  struct Track {
+    std::uint64_t hash = 0;
+    std::size_t length = 0;
+    Song events; // this track only; header unused
+  };
+
+  void merge();
+
+  std::vector<Track> tracks_;
+  Song song_;
+  TempoMap tempo_;
+};
+
+} // namespace midi
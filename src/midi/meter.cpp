@@ -0,0 +1,200 @@
+// src/midi/meter.cpp
+// Meter map construction and tick <-> seconds <-> bar:beat conversions.
+
+#include "midi/meter.hpp"
+#include "midi/tempo.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace midi {
+
+namespace {
+
+MeterSeg make_segment(std::uint32_t tick, std::uint32_t bar, unsigned ppqn,
+                      unsigned num, unsigned denPow2) {
+  MeterSeg s;
+  s.startTick = tick;
+  s.startBar = bar;
+  s.num = static_cast<std::uint8_t>(std::max(1u, num));
+  s.den = static_cast<std::uint8_t>(1u << std::min(denPow2, 7u));
+  // Very short beat units at low ppqn would round to zero ticks.
+  s.ticksPerBeat = std::max(1u, ppqn * 4u / s.den);
+  s.ticksPerBar = s.ticksPerBeat * s.num;
+  return s;
+}
+
+BarBeat position_in(const MeterSeg &s, std::uint32_t tick) {
+  const std::uint32_t d = tick - s.startTick;
+  const std::uint32_t inBar = d % s.ticksPerBar;
+  return BarBeat{s.startBar + d / s.ticksPerBar + 1, inBar / s.ticksPerBeat + 1,
+                 inBar % s.ticksPerBeat};
+}
+
+std::uint32_t tick_in(const MeterSeg &s, const BarBeat &pos) {
+  const std::uint32_t bar = pos.bar > s.startBar ? pos.bar - 1 - s.startBar : 0;
+  const std::uint32_t beat = pos.beat > 0 ? pos.beat - 1 : 0;
+  return s.startTick + bar * s.ticksPerBar + beat * s.ticksPerBeat + pos.tick;
+}
+
+double seconds_in(const TempoSeg &seg, std::uint32_t tick, unsigned ppqn) {
+  return seg.startSec + (tick - seg.startTick) / static_cast<double>(ppqn) *
+                            (seg.usPerQN * 1e-6);
+}
+
+double ticks_in(const TempoSeg &seg, double sec, unsigned ppqn) {
+  if (seg.usPerQN <= 0.0)
+    return seg.startTick;
+  return seg.startTick + (sec - seg.startSec) / (seg.usPerQN * 1e-6) * ppqn;
+}
+
+// Segment containing 0-based bar `bar` (segment bars ascend with ticks).
+std::size_t segment_at_bar(std::uint32_t bar, const MeterMap &meter) {
+  const auto it = std::upper_bound(
+      meter.segments.begin() + 1, meter.segments.end(), bar,
+      [](std::uint32_t b, const MeterSeg &s) { return b < s.startBar; });
+  return static_cast<std::size_t>(it - meter.segments.begin()) - 1;
+}
+
+} // namespace
+
+MeterMap build_meter_map(const Song &song) {
+  MeterMap map;
+  map.ppqn = song.header.isPPQN && song.header.ppqn > 0 ? song.header.ppqn
+                                                        : 480;
+
+  std::vector<TimeSigEv> sigs(song.timeSigs.begin(), song.timeSigs.end());
+  std::stable_sort(
+      sigs.begin(), sigs.end(),
+      [](const TimeSigEv &a, const TimeSigEv &b) { return a.tick < b.tick; });
+
+  map.segments.push_back(make_segment(0, 0, map.ppqn, 4, 2));
+  for (const TimeSigEv &t : sigs) {
+    MeterSeg &cur = map.segments.back();
+    if (t.tick == cur.startTick) {
+      // Same tick (e.g. a 4/4 default followed by the real one): replace.
+      cur = make_segment(cur.startTick, cur.startBar, map.ppqn, t.num,
+                         t.denPow2);
+      continue;
+    }
+    // A change mid-bar starts a new bar; the partial bar still counts.
+    const std::uint32_t d = t.tick - cur.startTick;
+    const std::uint32_t bars = (d + cur.ticksPerBar - 1) / cur.ticksPerBar;
+    map.segments.push_back(
+        make_segment(t.tick, cur.startBar + bars, map.ppqn, t.num, t.denPow2));
+  }
+
+  map.keys.assign(song.keySigs.begin(), song.keySigs.end());
+  std::stable_sort(
+      map.keys.begin(), map.keys.end(),
+      [](const KeySigEv &a, const KeySigEv &b) { return a.tick < b.tick; });
+  return map;
+}
+
+std::size_t meter_segment_at_tick(std::uint32_t tick, const MeterMap &meter) {
+  const auto it = std::upper_bound(
+      meter.segments.begin() + 1, meter.segments.end(), tick,
+      [](std::uint32_t t, const MeterSeg &s) { return t < s.startTick; });
+  return static_cast<std::size_t>(it - meter.segments.begin()) - 1;
+}
+
+BarBeat ticks_to_bbt(std::uint32_t tick, const MeterMap &meter) {
+  return position_in(meter.segments[meter_segment_at_tick(tick, meter)], tick);
+}
+
+std::uint32_t bbt_to_ticks(const BarBeat &pos, const MeterMap &meter) {
+  const std::uint32_t bar = pos.bar > 0 ? pos.bar - 1 : 0;
+  return tick_in(meter.segments[segment_at_bar(bar, meter)], pos);
+}
+
+BarBeat seconds_to_bbt(double sec, const TempoMap &tempo,
+                       const MeterMap &meter) {
+  return ticks_to_bbt(static_cast<std::uint32_t>(seconds_to_ticks(sec, tempo)),
+                      meter);
+}
+
+double bbt_to_seconds(const BarBeat &pos, const TempoMap &tempo,
+                      const MeterMap &meter) {
+  return ticks_to_seconds(bbt_to_ticks(pos, meter), tempo);
+}
+
+KeySigEv key_at(std::uint32_t tick, const MeterMap &meter) {
+  const auto it = std::upper_bound(
+      meter.keys.begin(), meter.keys.end(), tick,
+      [](std::uint32_t t, const KeySigEv &k) { return t < k.tick; });
+  return it == meter.keys.begin() ? KeySigEv{0, 0, false} : *(it - 1);
+}
+
+std::string key_name(const KeySigEv &key) {
+  // Circle of fifths from 7 flats to 7 sharps.
+  static const char *const major[15] = {"Cb", "Gb", "Db", "Ab", "Eb",
+                                        "Bb", "F",  "C",  "G",  "D",
+                                        "A",  "E",  "B",  "F#", "C#"};
+  static const char *const minor[15] = {"Ab", "Eb", "Bb", "F",  "C",
+                                        "G",  "D",  "A",  "E",  "B",
+                                        "F#", "C#", "G#", "D#", "A#"};
+  const int i = std::clamp(int(key.sf), -7, 7) + 7;
+  return std::string(key.minor ? minor[i] : major[i]) +
+         (key.minor ? " minor" : " major");
+}
+
+std::string format_bbt(const BarBeat &pos) {
+  char buf[40];
+  std::snprintf(buf, sizeof buf, "%u:%u:%03u", pos.bar, pos.beat, pos.tick);
+  return buf;
+}
+
+// --- MusicalCursor ---------------------------------------------------------
+
+const TempoSeg &MusicalCursor::tempo_seg_for_tick(std::uint32_t tick) {
+  const auto &segs = tempo_->segments;
+  if (tick < segs[tempoSeg_].startTick)
+    tempoSeg_ = tempo_segment_at_tick(tick, *tempo_);
+  while (tempoSeg_ + 1 < segs.size() && segs[tempoSeg_ + 1].startTick <= tick)
+    ++tempoSeg_;
+  return segs[tempoSeg_];
+}
+
+const TempoSeg &MusicalCursor::tempo_seg_for_seconds(double sec) {
+  const auto &segs = tempo_->segments;
+  if (sec < segs[tempoSeg_].startSec)
+    tempoSeg_ = tempo_segment_at_seconds(sec, *tempo_);
+  while (tempoSeg_ + 1 < segs.size() && segs[tempoSeg_ + 1].startSec <= sec)
+    ++tempoSeg_;
+  return segs[tempoSeg_];
+}
+
+const MeterSeg &MusicalCursor::meter_seg_for_tick(std::uint32_t tick) {
+  const auto &segs = meter_->segments;
+  if (tick < segs[meterSeg_].startTick)
+    meterSeg_ = meter_segment_at_tick(tick, *meter_);
+  while (meterSeg_ + 1 < segs.size() && segs[meterSeg_ + 1].startTick <= tick)
+    ++meterSeg_;
+  return segs[meterSeg_];
+}
+
+double MusicalCursor::seconds(std::uint32_t tick) {
+  return seconds_in(tempo_seg_for_tick(tick), tick, tempo_->ppqn);
+}
+
+double MusicalCursor::ticks(double sec) {
+  if (sec <= 0.0)
+    return 0.0;
+  return ticks_in(tempo_seg_for_seconds(sec), sec, tempo_->ppqn);
+}
+
+BarBeat MusicalCursor::bbt(std::uint32_t tick) {
+  return position_in(meter_seg_for_tick(tick), tick);
+}
+
+std::uint32_t MusicalCursor::tick_of(const BarBeat &pos) {
+  const auto &segs = meter_->segments;
+  const std::uint32_t bar = pos.bar > 0 ? pos.bar - 1 : 0;
+  if (bar < segs[meterSeg_].startBar)
+    meterSeg_ = segment_at_bar(bar, *meter_);
+  while (meterSeg_ + 1 < segs.size() && segs[meterSeg_ + 1].startBar <= bar)
+    ++meterSeg_;
+  return tick_in(segs[meterSeg_], pos);
+}
+
+} // namespace midi
@@ -0,0 +1,98 @@
+// src/midi/meter.hpp
+// Musical time: bars and beats from time signatures, next to the TempoMap.
+//
+// Contract:
+//  - build_meter_map(const Song&): consumes Song.header + Song.timeSigs +
+//    Song.keySigs (unsorted, as parsed).
+//  - ticks_to_bbt / bbt_to_ticks: tick <-> bar:beat:tick, O(log n) in the
+//    number of time signature changes.
+//  - seconds_to_bbt / bbt_to_seconds: the same via the TempoMap.
+//  - MusicalCursor: the same conversions for mostly-forward sweeps, O(1)
+//    amortized (it only steps to neighbouring segments).
+//
+// Notes:
+//  - Bars and beats are 1-based, the tick within a beat is 0-based, like a
+//    sequencer's position display ("12:3:120").
+//  - A beat is the time signature's denominator note (an eighth in 6/8).
+//  - Without a time signature at tick 0 the song starts in 4/4. A change in
+//    the middle of a bar starts a new bar there (the partial bar counts).
+//  - SMPTE-timed files use the same 480 ppqn fallback as build_tempo_map.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "midi/events.hpp"
+
+namespace midi {
+
+// A musical position: bar and beat from 1, tick within the beat from 0.
+struct BarBeat {
+  std::uint32_t bar = 1;
+  std::uint32_t beat = 1;
+  std::uint32_t tick = 0;
+};
+
+// A stretch of the song under one time signature.
+struct MeterSeg {
+  std::uint32_t startTick = 0;  // absolute tick where the segment begins
+  std::uint32_t startBar = 0;   // 0-based bar number at startTick
+  std::uint8_t num = 4;         // beats per bar
+  std::uint8_t den = 4;         // beat unit (4 = quarter note)
+  std::uint32_t ticksPerBeat = 480;
+  std::uint32_t ticksPerBar = 1920;
+};
+
+// Time and key signatures, ascending by tick.
+struct MeterMap {
+  unsigned ppqn = 480;
+  std::vector<MeterSeg> segments; // never empty once built
+  std::vector<KeySigEv> keys;     // sorted; may be empty
+};
+
+MeterMap build_meter_map(const Song &song);
+
+BarBeat ticks_to_bbt(std::uint32_t tick, const MeterMap &meter);
+std::uint32_t bbt_to_ticks(const BarBeat &pos, const MeterMap &meter);
+BarBeat seconds_to_bbt(double sec, const TempoMap &tempo,
+                       const MeterMap &meter);
+double bbt_to_seconds(const BarBeat &pos, const TempoMap &tempo,
+                      const MeterMap &meter);
+
+// Index of the segment containing `tick` (O(log n)).
+std::size_t meter_segment_at_tick(std::uint32_t tick, const MeterMap &meter);
+
+// Key signature in effect at `tick` (C major when the song has none).
+KeySigEv key_at(std::uint32_t tick, const MeterMap &meter);
+// "Eb major", "F# minor", ...
+std::string key_name(const KeySigEv &key);
+// "12:3:120" (beat tick zero-padded to three digits)
+std::string format_bbt(const BarBeat &pos);
+
+// Sequential converter holding its place in both maps. Moving backwards
+// falls back to a binary search, so any order is correct; forward sweeps
+// (event lists, render blocks) are O(1) amortized per call.
+class MusicalCursor {
+public:
+  MusicalCursor(const TempoMap &tempo, const MeterMap &meter)
+      : tempo_(&tempo), meter_(&meter) {}
+
+  double seconds(std::uint32_t tick);
+  double ticks(double sec);
+  BarBeat bbt(std::uint32_t tick);
+  std::uint32_t tick_of(const BarBeat &pos);
+
+private:
+  const TempoSeg &tempo_seg_for_tick(std::uint32_t tick);
+  const TempoSeg &tempo_seg_for_seconds(double sec);
+  const MeterSeg &meter_seg_for_tick(std::uint32_t tick);
+
+  const TempoMap *tempo_;
+  const MeterMap *meter_;
+  std::size_t tempoSeg_ = 0;
+  std::size_t meterSeg_ = 0;
+};
+
+} // namespace midi
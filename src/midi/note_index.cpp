@@ -0,0 +1,126 @@
+// src/midi/note_index.cpp
+// Note pairing and the per-channel centered interval trees.
+
+#include "midi/note_index.hpp"
+
+#include <algorithm>
+
+namespace midi {
+
+NoteIndex::NoteIndex(const Song &song) {
+  // Sort a copy by (tick, offs first); Song::notes is concatenated per track.
+  std::vector<NoteEv> evs(song.notes.begin(), song.notes.end());
+  std::stable_sort(evs.begin(), evs.end(),
+                   [](const NoteEv &a, const NoteEv &b) {
+                     if (a.tick != b.tick)
+                       return a.tick < b.tick;
+                     return a.type == EvType::NoteOff &&
+                            b.type == EvType::NoteOn;
+                   });
+
+  // Pair FIFO per (port, channel, key): the oldest open note is switched off
+  // first.
+  std::size_t ports = 1;
+  for (const NoteEv &e : evs)
+    ports = std::max(ports, std::size_t(e.port) + 1);
+  std::vector<std::vector<std::uint32_t>> open(ports * 16 * 128);
+  std::vector<std::uint32_t> head(open.size(), 0); // first still-open entry
+  std::uint32_t last = 0;
+  for (const NoteEv &e : evs) {
+    last = std::max(last, e.tick);
+    const std::size_t k =
+        (std::size_t(e.port) * 16 + (e.ch & 0x0F)) * 128 + (e.note & 0x7F);
+    if (e.type == EvType::NoteOn) {
+      open[k].push_back(std::uint32_t(notes_.size()));
+      notes_.push_back(Note{e.tick, e.tick, std::uint8_t(e.ch & 0x0F),
+                            std::uint8_t(e.note & 0x7F), e.vel, e.port});
+    } else if (head[k] < open[k].size()) {
+      notes_[open[k][head[k]++]].end = e.tick;
+    }
+  }
+  for (std::size_t k = 0; k < open.size(); ++k) {
+    for (std::size_t j = head[k]; j < open[k].size(); ++j)
+      notes_[open[k][j]].end = last;
+  }
+
+  // Group by channel, start order within a channel (already start-sorted).
+  std::stable_sort(notes_.begin(), notes_.end(),
+                   [](const Note &a, const Note &b) { return a.ch < b.ch; });
+
+  byStart_.resize(notes_.size());
+  byEnd_.resize(notes_.size());
+  std::vector<std::uint32_t> ids;
+  std::uint32_t i = 0;
+  for (int c = 0; c < 16; ++c) {
+    Channel &ch = channels_[std::size_t(c)];
+    ch.first = i;
+    ids.clear();
+    for (; i < notes_.size() && notes_[i].ch == c; ++i) {
+      if (notes_[i].end > notes_[i].start) // zero-length: range scans only
+        ids.push_back(i);
+    }
+    ch.count = i - ch.first;
+    ch.root = build(ids);
+  }
+}
+
+// `ids` is sorted by start. The center is the median start, so the notes that
+// end at or before it (left) and those starting after it (right) each hold at
+// most half of the input: depth is O(log n).
+std::int32_t NoteIndex::build(std::vector<std::uint32_t> &ids) {
+  if (ids.empty())
+    return -1;
+  const std::uint32_t center = notes_[ids[ids.size() / 2]].start;
+
+  std::vector<std::uint32_t> left, right;
+  const auto first = static_cast<std::uint32_t>(
+      nodes_.empty() ? 0 : nodes_.back().first + nodes_.back().count);
+  std::uint32_t count = 0;
+  for (std::uint32_t id : ids) {
+    const Note &n = notes_[id];
+    if (n.end <= center)
+      left.push_back(id);
+    else if (n.start > center)
+      right.push_back(id);
+    else
+      byStart_[first + count++] = id;
+  }
+  ids.clear();
+  ids.shrink_to_fit();
+
+  std::copy(byStart_.begin() + first, byStart_.begin() + first + count,
+            byEnd_.begin() + first);
+  std::stable_sort(byEnd_.begin() + first, byEnd_.begin() + first + count,
+                   [&](std::uint32_t a, std::uint32_t b) {
+                     return notes_[a].end > notes_[b].end;
+                   });
+
+  const auto self = static_cast<std::int32_t>(nodes_.size());
+  nodes_.push_back(Node{center, first, count});
+  const std::int32_t l = build(left);
+  const std::int32_t r = build(right);
+  nodes_[std::size_t(self)].left = l;
+  nodes_[std::size_t(self)].right = r;
+  return self;
+}
+
+std::vector<Note> NoteIndex::active_at(std::uint32_t tick,
+                                       ChannelMask mask) const {
+  std::vector<Note> out;
+  for_each_active(tick, [&](const Note &n) { out.push_back(n); }, mask);
+  return out;
+}
+
+std::vector<Note> NoteIndex::in_range(std::uint32_t a, std::uint32_t b,
+                                      ChannelMask mask) const {
+  std::vector<Note> out;
+  for_each_in(a, b, [&](const Note &n) { out.push_back(n); }, mask);
+  return out;
+}
+
+std::size_t NoteIndex::memory_bytes() const {
+  return notes_.capacity() * sizeof(Note) + nodes_.capacity() * sizeof(Node) +
+         (byStart_.capacity() + byEnd_.capacity()) * sizeof(std::uint32_t);
+}
+
+} // namespace midi
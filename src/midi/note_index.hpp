@@ -0,0 +1,155 @@
+// src/midi/note_index.hpp
+// Immutable interval index over paired notes: "what is sounding at tick t"
+// and "what sounds during [a, b)" without scanning Song::notes.
+//
+//   const midi::NoteIndex idx(song);
+//   for (const auto &n : idx.active_at(tick)) ...          // stabbing query
+//   idx.for_each_in(a, b, [&](const midi::Note &n) {...}, // range query
+//                   midi::channel_bit(9));                 // drums only
+//
+// Design notes:
+// - NoteOn/NoteOff are paired per (port, channel, key) first-in-first-out,
+//   after sorting by tick with offs before ons at equal ticks (the same order
+//   the scheduler plays them in). Notes never switched off end at the song's
+//   last tick.
+// - Intervals are half-open [start, end). Zero-length notes never contain a
+//   tick, but range queries report them if their start lies in the range.
+// - One centered interval tree per channel, flattened into arrays: each node
+//   keeps the notes that contain its center, sorted by start and by end, so
+//   a stabbing query walks one root-to-leaf path and stops scanning a node's
+//   list at the first miss: O(log n + k) per channel.
+// - A range query is a stabbing query at `a` plus the notes starting inside
+//   (a, b), found by binary search in the per-channel start order.
+// - Build is O(n log n); memory is ~12 bytes per note plus three indices.
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "midi/events.hpp"
+
+namespace midi {
+
+// One sounding note in ticks: [start, end).
+struct Note {
+  std::uint32_t start;
+  std::uint32_t end;
+  std::uint8_t ch;
+  std::uint8_t key;
+  std::uint8_t vel;
+  std::uint8_t port; // channel masks select by channel across all ports
+};
+
+using ChannelMask = std::uint16_t;
+constexpr ChannelMask kAllChannels = 0xFFFF;
+constexpr ChannelMask channel_bit(int ch) { return ChannelMask(1u << ch); }
+
+class NoteIndex {
+public:
+  NoteIndex() = default;
+  explicit NoteIndex(const Song &song);
+
+  // Notes with start <= tick < end, in channel order.
+  [[nodiscard]] std::vector<Note> active_at(std::uint32_t tick,
+                                            ChannelMask mask = kAllChannels)
+      const;
+  // Notes overlapping [a, b), plus zero-length notes starting in it.
+  [[nodiscard]] std::vector<Note> in_range(std::uint32_t a, std::uint32_t b,
+                                           ChannelMask mask = kAllChannels)
+      const;
+
+  template <class F>
+  void for_each_active(std::uint32_t tick, F &&f,
+                       ChannelMask mask = kAllChannels) const;
+  template <class F>
+  void for_each_in(std::uint32_t a, std::uint32_t b, F &&f,
+                   ChannelMask mask = kAllChannels) const;
+
+  // All notes, grouped by channel and sorted by start within each channel.
+  [[nodiscard]] const std::vector<Note> &notes() const { return notes_; }
+  [[nodiscard]] std::size_t size() const { return notes_.size(); }
+  [[nodiscard]] std::size_t memory_bytes() const;
+
+private:
+  struct Node {
+    std::uint32_t center;
+    std::uint32_t first, count; // slice of byStart_ / byEnd_
+    std::int32_t left = -1, right = -1;
+  };
+  struct Channel {
+    std::uint32_t first = 0, count = 0; // slice of notes_
+    std::int32_t root = -1;
+  };
+
+  std::int32_t build(std::vector<std::uint32_t> &ids);
+
+  std::vector<Note> notes_;
+  std::vector<Node> nodes_;
+  std::vector<std::uint32_t> byStart_; // note ids per node, start ascending
+  std::vector<std::uint32_t> byEnd_;   // same ids, end descending
+  std::array<Channel, 16> channels_{};
+};
+
+template <class F>
+void NoteIndex::for_each_active(std::uint32_t tick, F &&f,
+                                ChannelMask mask) const {
+  for (int c = 0; c < 16; ++c) {
+    if (!(mask & channel_bit(c)))
+      continue;
+    std::int32_t n = channels_[std::size_t(c)].root;
+    while (n >= 0) {
+      const Node &node = nodes_[std::size_t(n)];
+      if (tick < node.center) {
+        // Every note here ends after center > tick: only the start matters.
+        for (std::uint32_t i = 0; i < node.count; ++i) {
+          const Note &note = notes_[byStart_[node.first + i]];
+          if (note.start > tick)
+            break;
+          f(note);
+        }
+        n = node.left;
+      } else {
+        // Every note here starts at or before center <= tick.
+        for (std::uint32_t i = 0; i < node.count; ++i) {
+          const Note &note = notes_[byEnd_[node.first + i]];
+          if (note.end <= tick)
+            break;
+          f(note);
+        }
+        n = node.right;
+      }
+    }
+  }
+}
+
+template <class F>
+void NoteIndex::for_each_in(std::uint32_t a, std::uint32_t b, F &&f,
+                            ChannelMask mask) const {
+  if (b <= a)
+    return;
+  for (int c = 0; c < 16; ++c) {
+    if (!(mask & channel_bit(c)))
+      continue;
+    for_each_active(a, f, channel_bit(c));
+    const Channel &ch = channels_[std::size_t(c)];
+    const Note *begin = notes_.data() + ch.first;
+    const Note *end = begin + ch.count;
+    // First note starting at or after a; notes starting at a that contain a
+    // were already reported by the stabbing query.
+    std::size_t lo = 0, hi = ch.count;
+    while (lo < hi) {
+      const std::size_t mid = (lo + hi) / 2;
+      if (begin[mid].start < a)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    for (const Note *p = begin + lo; p != end && p->start < b; ++p) {
+      if (p->start > a || p->end == p->start)
+        f(*p);
+    }
+  }
+}
+
+} // namespace midi
@@ -3,12 +3,17 @@
 // Pure parsing: no printing, no I/O.
 
 #include "midi/smf.hpp"
+#include "common/hash.hpp"
 #include "common/reader.hpp" // Bytes cursor + read_vlq()
+#include "midi/channel.hpp"
 #include "midi/events.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace {
@@ -44,157 +49,281 @@ midi::SMFHeader parse_header(Bytes &r) {
   return h; // r.off now points to first track chunk (MTrk)
 }
 
-// Copy a slice of the file into a new Bytes cursor for a track.
-Bytes make_slice(const std::vector<std::uint8_t> &file, std::size_t start,
-                 std::size_t len) {
-  if (start + len > file.size()) {
+// A Bytes cursor over one track's slice of the file (no copy).
+Bytes make_slice(const Bytes &file, std::size_t start, std::size_t len) {
+  if (start + len > file.size) {
     throw std::runtime_error("Track slice out of range");
   }
-  std::vector<std::uint8_t> tmp(file.begin() + start,
-                                file.begin() + start + len);
-  return Bytes(tmp);
+  return Bytes(file.data + start, len);
 }
 
-// Walk a single MTrk chunk and append events to out vectors.
+// Decode one event at tr.off and append it to the song's vectors; false at
+// End of Track. The song is only touched once the whole event has been read,
+// so after a BytesEof the streaming parser only has to restore `st`.
 // - Produces absolute tick times (track-local absolute; OK for format 1).
-void walk_one_track(const std::vector<std::uint8_t> &file, Bytes &r,
-                    int /*trackIndex*/, std::vector<midi::NoteEv> &outNotes,
-                    std::vector<midi::TempoEv> &outTempi) {
-  const std::uint32_t id = r.be32();
-  if (id != 0x4D54726B) { // "MTrk"
-    throw std::runtime_error("Missing 'MTrk' chunk");
-  }
-  const std::uint32_t len = r.be32();
+bool walk_event(Bytes &tr, midi::TrackState &st, midi::Song &out) {
+  std::uint32_t &tick = st.tick;
+  std::uint8_t &running = st.running;
+  std::uint8_t &port = st.port;
+  // 1) Delta-time (Variable-Length Quantity)
+  std::uint32_t delta = read_vlq(tr);
+  tick += delta;
 
-  // Make a sub-cursor for just this track's bytes, then skip over them in the
-  // main reader.
-  const std::size_t trackStart = r.off;
-  Bytes tr = make_slice(file, trackStart, len);
-  r.skip(len);
+  // 2) Status or running status?
+  std::uint8_t first = tr.u8();
+  std::uint8_t status = 0;
+  bool haveData1 = false;
+  std::uint8_t data1 = 0;
 
-  std::uint32_t tick = 0;
-  std::uint8_t running = 0; // last seen channel status for running status
-
-  while (tr.off < tr.data.size()) {
-    // 1) Delta-time (Variable-Length Quantity)
-    std::uint32_t delta = read_vlq(tr);
-    tick += delta;
-
-    // 2) Status or running status?
-    std::uint8_t first = tr.u8();
-    std::uint8_t status = 0;
-    bool haveData1 = false;
-    std::uint8_t data1 = 0;
-
-    if (first & 0x80) {
-      // New status byte
-      status = first;
-      if ((status & 0xF0) < 0xF0) {
-        running = status; // only channel messages set running status
-      }
-    } else {
-      // Running status: 'first' is actually data1 for the previous channel
-      // status
-      if (running == 0) {
-        throw std::runtime_error("Running status used before any status");
-      }
-      status = running;
-      haveData1 = true;
-      data1 = first;
+  if (first & 0x80) {
+    // New status byte
+    status = first;
+    if ((status & 0xF0) < 0xF0) {
+      running = status; // only channel messages set running status
     }
-
-    const std::uint8_t type = status & 0xF0;
-    const std::uint8_t ch = status & 0x0F;
-
-    // Channel messages with two data bytes
-    if (type == 0x80 || type == 0x90 || type == 0xA0 || type == 0xB0 ||
-        type == 0xE0) {
-      std::uint8_t d1 = haveData1 ? data1 : tr.u8();
-      std::uint8_t d2 = tr.u8();
-
-      if (type == 0x90 && d2 != 0) {
-        // Note On
-        outNotes.push_back(
-            midi::NoteEv{tick, ch, d1, d2, midi::EvType::NoteOn});
-      } else if (type == 0x80 || (type == 0x90 && d2 == 0)) {
-        // Note Off (either true 0x80 or "Note On with velocity 0")
-        outNotes.push_back(
-            midi::NoteEv{tick, ch, d1, d2, midi::EvType::NoteOff});
-      } else {
-        // Other two-byte channel messages (Poly AT, CC, Pitch Bend) – ignore
-        // for now
-      }
-      continue;
+  } else {
+    // Running status: 'first' is actually data1 for the previous channel
+    // status
+    if (running == 0) {
+      throw std::runtime_error("Running status used before any status");
     }
+    status = running;
+    haveData1 = true;
+    data1 = first;
+  }
 
-    // Channel messages with one data byte
-    if (type == 0xC0 || type == 0xD0) {
-      std::uint8_t d1 = haveData1 ? data1 : tr.u8();
-      (void)d1; // Program Change / Channel Pressure – ignore for now
-      continue;
+  // Channel messages (shared classification with the live input stage)
+  if (const int nData = midi::channel_data_bytes(status); nData > 0) {
+    std::uint8_t d1 = haveData1 ? data1 : tr.u8();
+    std::uint8_t d2 = (nData == 2) ? tr.u8() : 0;
+
+    midi::NoteEv ev{};
+    if (midi::to_note_event(status, d1, d2, tick, ev)) {
+      ev.port = port;
+      out.notes.push_back(ev);
+    } else if ((status & 0xF0) == 0xB0) {
+      // Control Change (volume, pan, sustain, reverb/chorus sends, ...)
+      out.ctrls.push_back(
+          midi::CtrlEv{tick, std::uint8_t(status & 0x0F), d1, d2, port});
     }
+    // Other channel messages (Poly AT, Pitch Bend, Program Change,
+    // Channel Pressure) – ignore for now
+    return true;
+  }
 
-    // Meta events
-    if (status == 0xFF) {
-      std::uint8_t metaType = tr.u8();
-      std::uint32_t mlen = read_vlq(tr);
+  // Meta events
+  if (status == 0xFF) {
+    std::uint8_t metaType = tr.u8();
+    std::uint32_t mlen = read_vlq(tr);
 
-      if (metaType == 0x2F) { // End of Track
-        if (mlen != 0)
-          tr.skip(mlen);
-        break;
-      } else if (metaType == 0x51 && mlen == 3) {
-        // Tempo: 3 bytes big-endian microseconds per quarter note
-        std::uint32_t t0 = tr.u8(), t1 = tr.u8(), t2 = tr.u8();
-        std::uint32_t usPerQN = (t0 << 16) | (t1 << 8) | t2;
-        outTempi.push_back(midi::TempoEv{tick, usPerQN});
-      } else {
-        // Skip other meta payloads we don't consume yet
+    if (metaType == 0x2F) { // End of Track
+      if (mlen != 0)
         tr.skip(mlen);
-      }
-      continue;
+      return false;
+    } else if (metaType == 0x51 && mlen == 3) {
+      // Tempo: 3 bytes big-endian microseconds per quarter note
+      std::uint32_t t0 = tr.u8(), t1 = tr.u8(), t2 = tr.u8();
+      std::uint32_t usPerQN = (t0 << 16) | (t1 << 8) | t2;
+      out.tempi.push_back(midi::TempoEv{tick, usPerQN});
+    } else if (metaType == 0x21 && mlen == 1) {
+      // MIDI port: this track's later events address port * 16 + ch
+      port = tr.u8();
+    } else if (metaType == 0x58 && mlen == 4) {
+      // Time signature: nn dd cc bb (dd is a power of two)
+      midi::TimeSigEv ts{tick};
+      ts.num = tr.u8();
+      ts.denPow2 = tr.u8();
+      ts.clocksPerClick = tr.u8();
+      ts.n32PerQN = tr.u8();
+      out.timeSigs.push_back(ts);
+    } else if (metaType == 0x59 && mlen == 2) {
+      // Key signature: sf (signed sharps/flats), mi (0 major, 1 minor)
+      const auto sf = static_cast<std::int8_t>(tr.u8());
+      const bool minor = tr.u8() != 0;
+      out.keySigs.push_back(midi::KeySigEv{tick, sf, minor});
+    } else {
+      // Skip other meta payloads we don't consume yet
+      tr.skip(mlen);
     }
+    return true;
+  }
 
-    // SysEx events
-    if (status == 0xF0 || status == 0xF7) {
-      std::uint32_t slen = read_vlq(tr);
-      tr.skip(slen);
-      continue;
-    }
+  // SysEx events
+  if (status == 0xF0 || status == 0xF7) {
+    std::uint32_t slen = read_vlq(tr);
+    tr.skip(slen);
+    return true;
+  }
+
+  // Anything else is unsupported/malformed at this stage
+  std::ostringstream oss;
+  oss << "Unsupported or malformed status byte: 0x" << std::hex << int(status);
+  throw std::runtime_error(oss.str());
+}
+
+// Walk the events of one MTrk chunk (file[start, start + len)).
+void walk_track_events(const Bytes &file, std::size_t start, std::size_t len,
+                       midi::Song &out) {
+  Bytes tr = make_slice(file, start, len);
+  midi::TrackState st;
+  while (tr.off < tr.size && walk_event(tr, st, out)) {
+  }
+}
 
-    // Anything else is unsupported/malformed at this stage
-    std::ostringstream oss;
-    oss << "Unsupported or malformed status byte: 0x" << std::hex
-        << int(status);
-    throw std::runtime_error(oss.str());
+// Read one MTrk chunk header; returns the event byte count and leaves r at
+// the first event.
+std::uint32_t read_track_header(Bytes &r) {
+  const std::uint32_t id = r.be32();
+  if (id != 0x4D54726B) { // "MTrk"
+    throw std::runtime_error("Missing 'MTrk' chunk");
   }
+  return r.be32();
+}
+
+// Walk a single MTrk chunk and append its events to the song's vectors.
+void walk_one_track(Bytes &r, int /*trackIndex*/, midi::Song &out) {
+  const std::uint32_t len = read_track_header(r);
+
+  // Walk just this track's bytes, then skip over them in the main reader.
+  const std::size_t trackStart = r.off;
+  walk_track_events(r, trackStart, len, out);
+  r.skip(len);
 }
 
 } // namespace
 
 namespace midi {
 
-Song parse_smf(const std::vector<std::uint8_t> &bytes) {
-  Bytes r(bytes);
+Song parse_smf(const std::uint8_t *data, std::size_t size,
+               std::pmr::memory_resource *mr) {
+  Bytes r(data, size);
 
   // Header
   SMFHeader header = parse_header(r);
 
   // Accumulate events from all tracks
-  std::vector<NoteEv> notes;
-  std::vector<TempoEv> tempi;
-  notes.reserve(4096);
-  tempi.reserve(64);
+  Song song(mr);
+  song.header = header;
+  song.notes.reserve(4096);
+  song.ctrls.reserve(256);
+  song.tempi.reserve(64);
 
   for (std::uint16_t i = 0; i < header.nTracks; ++i) {
-    walk_one_track(bytes, r, static_cast<int>(i), notes, tempi);
+    walk_one_track(r, static_cast<int>(i), song);
   }
-
-  Song song;
-  song.header = header;
-  song.notes = std::move(notes);
-  song.tempi = std::move(tempi);
   return song;
 }
 
+Song parse_smf(const std::vector<std::uint8_t> &bytes,
+               std::pmr::memory_resource *mr) {
+  return parse_smf(bytes.data(), bytes.size(), mr);
+}
+
+SMFHeader scan_smf(const std::vector<std::uint8_t> &bytes,
+                   std::vector<TrackChunk> &tracks) {
+  Bytes r(bytes);
+  SMFHeader header = parse_header(r);
+  tracks.clear();
+  tracks.reserve(header.nTracks);
+  for (std::uint16_t i = 0; i < header.nTracks; ++i) {
+    const std::uint32_t len = read_track_header(r);
+    if (r.off + len > bytes.size()) {
+      throw std::runtime_error("Track slice out of range");
+    }
+    tracks.push_back(
+        TrackChunk{r.off, len, fnv1a(bytes.data() + r.off, len)});
+    r.skip(len);
+  }
+  return header;
+}
+
+void parse_track(const std::vector<std::uint8_t> &bytes,
+                 const TrackChunk &chunk, Song &out) {
+  walk_track_events(Bytes(bytes), chunk.offset, chunk.length, out);
+}
+
+SmfStreamParser::SmfStreamParser(std::pmr::memory_resource *mr)
+    : song_(mr) {}
+
+void SmfStreamParser::feed(const std::uint8_t *data, std::size_t n) {
+  // Drop consumed bytes once they dominate the buffer.
+  if (pos_ > 65536 && pos_ * 2 > buf_.size()) {
+    buf_.erase(buf_.begin(), buf_.begin() + std::ptrdiff_t(pos_));
+    pos_ = 0;
+  }
+  buf_.insert(buf_.end(), data, data + n);
+
+  for (;;) {
+    const std::size_t avail = buf_.size() - pos_;
+    Bytes r(buf_.data() + pos_, avail);
+    switch (stage_) {
+    case Stage::Header:
+      if (avail < 14)
+        return;
+      song_.header = parse_header(r);
+      pos_ += r.off;
+      stage_ = song_.header.nTracks ? Stage::TrackHeader : Stage::Done;
+      break;
+    case Stage::TrackHeader:
+      if (avail < 8)
+        return;
+      trackLeft_ = read_track_header(r);
+      pos_ += r.off;
+      track_ = TrackState{};
+      stage_ = Stage::Events;
+      break;
+    case Stage::Events: {
+      if (trackLeft_ == 0) {
+        end_track();
+        break;
+      }
+      Bytes tr(buf_.data() + pos_, std::min(avail, trackLeft_));
+      TrackState st = track_;
+      bool more = true;
+      try {
+        more = walk_event(tr, st, song_);
+      } catch (const BytesEof &) {
+        if (avail >= trackLeft_)
+          throw; // the event overruns its chunk: malformed
+        return;  // wait for the rest of the event
+      }
+      track_ = st;
+      pos_ += tr.off;
+      trackLeft_ -= tr.off;
+      if (!more)
+        stage_ = Stage::SkipTrack; // bytes after End of Track
+      break;
+    }
+    case Stage::SkipTrack: {
+      const std::size_t n = std::min(avail, trackLeft_);
+      pos_ += n;
+      trackLeft_ -= n;
+      if (trackLeft_ > 0)
+        return;
+      end_track();
+      break;
+    }
+    case Stage::Done:
+      pos_ = buf_.size(); // trailing bytes are ignored, as in parse_smf()
+      return;
+    }
+  }
+}
+
+void SmfStreamParser::end_track() {
+  ++tracksDone_;
+  stage_ = tracksDone_ >= song_.header.nTracks ? Stage::Done
+                                                : Stage::TrackHeader;
+}
+
+void SmfStreamParser::finish() const {
+  if (stage_ == Stage::Header)
+    throw std::runtime_error("Not a MIDI file (stream ended before header)");
+  if (stage_ != Stage::Done) {
+    throw std::runtime_error("Stream ended inside track " +
+                             std::to_string(tracksDone_ + 1) + " of " +
+                             std::to_string(song_.header.nTracks));
+  }
+}
+
 } // namespace midi
@@ -4,7 +4,9 @@
 // - Throws std::runtime_error on malformed input.
 
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <memory_resource>
 #include <vector>
 
 #include "midi/events.hpp"
@@ -15,8 +17,85 @@ namespace midi {
 // On success, returns a Song containing:
 //   - header: SMFHeader (format, nTracks, timing division info)
 //   - notes : flattened NoteOn/NoteOff events across tracks (absolute ticks)
+//   - ctrls : flattened Control Change events across tracks (absolute ticks)
 //   - tempi : collected tempo changes (microseconds per quarter note)
+//   - timeSigs / keySigs : time and key signature meta events
+// All of the Song's event vectors allocate from `mr`.
 // On failure, throws std::runtime_error with a descriptive message.
-Song parse_smf(const std::vector<std::uint8_t> &bytes);
+Song parse_smf(
+    const std::vector<std::uint8_t> &bytes,
+    std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+// Same, over bytes owned elsewhere (e.g. a mapped pack entry, io/pack.hpp);
+// they are read in place and need only outlive the call.
+Song parse_smf(
+    const std::uint8_t *data, std::size_t size,
+    std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+// One MTrk chunk located by scan_smf(): where its events are in the file and
+// a hash of those bytes, so a reloader can tell which tracks changed.
+struct TrackChunk {
+  std::size_t offset; // first event byte (after the 8-byte chunk header)
+  std::size_t length; // event bytes
+  std::uint64_t hash; // FNV-1a of the event bytes
+};
+
+// Read the header and locate every MTrk chunk without decoding any events.
+SMFHeader scan_smf(const std::vector<std::uint8_t> &bytes,
+                   std::vector<TrackChunk> &tracks);
+
+// Decode one chunk found by scan_smf() and append its events to `out`.
+// Parsing every chunk in order into one Song matches parse_smf().
+void parse_track(const std::vector<std::uint8_t> &bytes,
+                 const TrackChunk &chunk, Song &out);
+
+// Running decoder state within one MTrk chunk.
+struct TrackState {
+  std::uint32_t tick = 0;   // absolute tick of the last event
+  std::uint8_t running = 0; // running status
+  std::uint8_t port = 0;    // from a port meta event (0x21)
+};
+
+// Incremental parser for input that arrives in pieces (stdin, pipes):
+//
+//   midi::SmfStreamParser p;
+//   while ((n = read(fd, buf, sizeof buf)) > 0) {
+//     p.feed(buf, n);            // decodes every event that is complete
+//     if (p.song().header.format == 0) ...play what is there
+//   }
+//   p.finish();                  // throws if the stream ended mid-track
+//
+// Events are appended to song() as soon as their last byte has arrived, in
+// the same order parse_smf() would produce them, so a format-0 song can play
+// while it is still being written. Format 1 tracks arrive one after another;
+// callers wait for complete() before playing them.
+class SmfStreamParser {
+public:
+  explicit SmfStreamParser(
+      std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+  // Append bytes. Throws std::runtime_error on malformed input.
+  void feed(const std::uint8_t *data, std::size_t n);
+  // End of input: throws if the header or a track is incomplete.
+  void finish() const;
+
+  [[nodiscard]] bool has_header() const { return stage_ != Stage::Header; }
+  // Every MTrk the header announced has been read.
+  [[nodiscard]] bool complete() const { return stage_ == Stage::Done; }
+  [[nodiscard]] std::size_t tracks_done() const { return tracksDone_; }
+  [[nodiscard]] const Song &song() const { return song_; }
+
+private:
+  enum class Stage { Header, TrackHeader, Events, SkipTrack, Done };
+
+  void end_track();
+
+  std::vector<std::uint8_t> buf_;
+  std::size_t pos_ = 0; // first unconsumed byte in buf_
+  Stage stage_ = Stage::Header;
+  std::size_t trackLeft_ = 0; // bytes of the current MTrk not consumed yet
+  std::size_t tracksDone_ = 0;
+  TrackState track_;
+  Song song_;
+};
 
 } // namespace midi
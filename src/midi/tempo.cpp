@@ -8,14 +8,14 @@
 
 namespace midi {
 
-TempoMap build_tempo_map(const Song &song) {
+TempoMap build_tempo_map(const Song &song, std::pmr::memory_resource *mr) {
   // Decide PPQN (ticks per quarter note)
   const unsigned ppqn = song.header.isPPQN
                             ? song.header.ppqn
                             : 480; // SMPTE: simple fallback for now
 
   // Work on a copy so we can sort safely
-  std::vector<TempoEv> tempi = song.tempi;
+  std::pmr::vector<TempoEv> tempi(song.tempi.begin(), song.tempi.end(), mr);
   std::sort(tempi.begin(), tempi.end(),
             [](const TempoEv &a, const TempoEv &b) { return a.tick < b.tick; });
 
@@ -24,7 +24,7 @@ TempoMap build_tempo_map(const Song &song) {
   double accSec = 0.0;
   std::uint32_t lastTick = 0;
 
-  TempoMap map;
+  TempoMap map(mr);
   map.ppqn = ppqn;
   map.segments.clear();
   map.segments.push_back(TempoSeg{0u, 0.0, current_usPerQN});
@@ -49,19 +49,35 @@ TempoMap build_tempo_map(const Song &song) {
 }
 
 double ticks_to_seconds(std::uint32_t tick, const TempoMap &tempo) {
-  // Find the last segment whose startTick <= tick (linear scan is fine; lists
-  // are tiny)
-  const TempoSeg *seg = &tempo.segments.front();
-  for (const auto &s : tempo.segments) {
-    if (s.startTick <= tick)
-      seg = &s;
-    else
-      break;
-  }
-
+  const TempoSeg &seg = tempo.segments[tempo_segment_at_tick(tick, tempo)];
   const double deltaQN =
-      (tick - seg->startTick) / static_cast<double>(tempo.ppqn);
-  return seg->startSec + deltaQN * (seg->usPerQN * 1e-6);
+      (tick - seg.startTick) / static_cast<double>(tempo.ppqn);
+  return seg.startSec + deltaQN * (seg.usPerQN * 1e-6);
+}
+
+double seconds_to_ticks(double sec, const TempoMap &tempo) {
+  if (sec <= 0.0)
+    return 0.0;
+  const TempoSeg &seg = tempo.segments[tempo_segment_at_seconds(sec, tempo)];
+  if (seg.usPerQN <= 0.0)
+    return seg.startTick; // zero tempo from a malformed file: time stands
+  const double deltaQN = (sec - seg.startSec) / (seg.usPerQN * 1e-6);
+  return seg.startTick + deltaQN * tempo.ppqn;
+}
+
+std::size_t tempo_segment_at_tick(std::uint32_t tick, const TempoMap &tempo) {
+  // Last segment whose startTick <= tick (segment 0 starts at tick 0).
+  const auto it = std::upper_bound(
+      tempo.segments.begin() + 1, tempo.segments.end(), tick,
+      [](std::uint32_t t, const TempoSeg &s) { return t < s.startTick; });
+  return static_cast<std::size_t>(it - tempo.segments.begin()) - 1;
+}
+
+std::size_t tempo_segment_at_seconds(double sec, const TempoMap &tempo) {
+  const auto it = std::upper_bound(
+      tempo.segments.begin() + 1, tempo.segments.end(), sec,
+      [](double t, const TempoSeg &s) { return t < s.startSec; });
+  return static_cast<std::size_t>(it - tempo.segments.begin()) - 1;
 }
 
 } // namespace midi
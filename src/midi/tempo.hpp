@@ -2,10 +2,14 @@
 // Timing utilities: build a tempo map and convert ticks -> seconds.
 //
 // Contract:
-//  - build_tempo_map(const Song&): consumes Song.header + Song.tempi
+//  - build_tempo_map(const Song&[, mr]): consumes Song.header + Song.tempi;
+//    the segments (and the sort scratch) allocate from mr.
 //      * Assumes PPQN timing. If the file uses SMPTE timing, we currently
 //        fall back to a default PPQN (480) inside the implementation.
 //  - ticks_to_seconds(tick, TempoMap): converts absolute tick to seconds.
+//  - seconds_to_ticks(sec, TempoMap): the inverse (fractional ticks).
+//  - Both binary-search the segments: O(log n) in the number of tempo
+//    changes. For sequential sweeps use midi::MusicalCursor (midi/meter.hpp).
 //
 // Notes:
 //  - TempoMap carries PPQN and a list of segments (startTick/startSec/usPerQN).
@@ -15,7 +19,9 @@
 #pragma once
 #include "midi/events.hpp"
 
+#include <cstddef>
 #include <cstdint>
+#include <memory_resource>
 
 namespace midi {
 
@@ -24,11 +30,20 @@ namespace midi {
 // - If the file uses SMPTE timing (header.isPPQN == false), we currently
 //   approximate with ppqn = 480 (common default). Proper SMPTE will be added
 //   later.
-TempoMap build_tempo_map(const Song &song);
+TempoMap build_tempo_map(
+    const Song &song,
+    std::pmr::memory_resource *mr = std::pmr::get_default_resource());
 
 // Convert an absolute tick to seconds using the TempoMap.
 // - Works for any tick within or after the last segment: beyond the last
 //   tempo change we continue with the last tempo.
 double ticks_to_seconds(std::uint32_t tick, const TempoMap &tempo);
 
+// Convert seconds to a (fractional) absolute tick; negative times clamp to 0.
+double seconds_to_ticks(double sec, const TempoMap &tempo);
+
+// Index of the segment containing `tick` / `sec` (O(log n)).
+std::size_t tempo_segment_at_tick(std::uint32_t tick, const TempoMap &tempo);
+std::size_t tempo_segment_at_seconds(double sec, const TempoMap &tempo);
+
 } // namespace midi
@@ -0,0 +1,26 @@
+# Play one song through the simulated driver and check where its clock
+# stopped: play() ends once the song's last event plus its tail has been
+# rendered, so the simulated length must lie in [MIN_SEC, MAX_SEC], the end
+# plus at most one poll and one period. A broken end-of-song check or tempo
+# map moves it out of that window.
+#
+#   cmake -DPLAYER=<midi_player> -DSONG=<x.mid> -DFONT=<x.sf2> -DDRIVER=sim:..
+#         -DMIN_SEC=<s> -DMAX_SEC=<s> -P sim_length.cmake
+
+execute_process(
+  COMMAND ${PLAYER} ${SONG} --sf ${FONT} --driver ${DRIVER}
+  RESULT_VARIABLE rc
+  OUTPUT_VARIABLE out
+  ERROR_VARIABLE err)
+if(NOT rc EQUAL 0)
+  message(FATAL_ERROR "${PLAYER} failed (${rc}):\n${err}")
+endif()
+if(NOT out MATCHES "Simulated ([0-9.]+) s of audio")
+  message(FATAL_ERROR "No simulated length in the output:\n${out}")
+endif()
+set(sec ${CMAKE_MATCH_1})
+if(sec LESS MIN_SEC OR sec GREATER MAX_SEC)
+  message(FATAL_ERROR
+    "Simulated ${sec} s, expected ${MIN_SEC} .. ${MAX_SEC} s")
+endif()
+message(STATUS "Simulated ${sec} s (${MIN_SEC} .. ${MAX_SEC} s)")